@@ -0,0 +1,162 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.cpp
+//
+// Identification: src/buffer/arc_replacer.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/arc_replacer.h"
+
+#include <algorithm>
+
+#include "common/exception.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+ARCReplacer::ARCReplacer(size_t num_frames) : nodes_(num_frames) {}
+
+auto ARCReplacer::FindVictim(std::list<frame_id_t> &list, const std::vector<ArcNode> &nodes)
+    -> std::list<frame_id_t>::iterator {
+  // Pinned frames are few compared to the pool, so skipping them from the LRU end is cheap in practice.
+  return std::find_if(list.begin(), list.end(),
+                      [&nodes](frame_id_t frame_id) { return nodes[frame_id].is_evictable_; });
+}
+
+void ARCReplacer::DropGhost(std::list<page_id_t> &list) {
+  ghosts_.erase(list.front());
+  list.pop_front();
+}
+
+void ARCReplacer::TrimGhosts() {
+  while (!b1_.empty() && t1_.size() + b1_.size() > capacity_) {
+    DropGhost(b1_);
+  }
+  while (!b2_.empty() && t1_.size() + t2_.size() + b1_.size() + b2_.size() > 2 * capacity_) {
+    DropGhost(b2_);
+  }
+}
+
+void ARCReplacer::Untrack(frame_id_t frame_id) {
+  auto &node = nodes_[frame_id];
+  node.list_->erase(node.pos_);
+  if (node.is_evictable_) {
+    evictable_size_--;
+  }
+  node = ArcNode{};
+}
+
+auto ARCReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock latch(latch_);
+  auto victim_t1 = FindVictim(t1_, nodes_);
+  auto victim_t2 = FindVictim(t2_, nodes_);
+  bool from_t1;
+  if (victim_t1 == t1_.end()) {
+    if (victim_t2 == t2_.end()) {
+      return false;
+    }
+    from_t1 = false;
+  } else {
+    from_t1 = t1_.size() > target_t1_ || victim_t2 == t2_.end();
+  }
+
+  *frame_id = from_t1 ? *victim_t1 : *victim_t2;
+  page_id_t page_id = nodes_[*frame_id].page_id_;
+  Untrack(*frame_id);
+  if (page_id != INVALID_PAGE_ID) {
+    auto &ghost_list = from_t1 ? b1_ : b2_;
+    ghost_list.push_back(page_id);
+    ghosts_[page_id] = Ghost{&ghost_list, std::prev(ghost_list.end())};
+    TrimGhosts();
+  }
+  return true;
+}
+
+void ARCReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type, page_id_t page_id) {
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= nodes_.size()) {
+    throw bustub::Exception(fmt::format("RecordAccess frame id: {} >= replacer size {}", frame_id, nodes_.size()));
+  }
+  std::scoped_lock latch(latch_);
+  auto &node = nodes_[frame_id];
+  if (node.list_ != nullptr) {
+    // A hit. Scans touch every page once, so they must not make a page look frequently used.
+    if (access_type != AccessType::Scan) {
+      node.list_->erase(node.pos_);
+      t2_.push_back(frame_id);
+      node.list_ = &t2_;
+      node.pos_ = std::prev(t2_.end());
+    }
+    return;
+  }
+
+  // A miss: the page has just been brought into the frame.
+  capacity_ = std::max(capacity_, t1_.size() + t2_.size() + 1);
+  auto *list = &t1_;
+  auto ghost = page_id == INVALID_PAGE_ID ? ghosts_.end() : ghosts_.find(page_id);
+  if (ghost != ghosts_.end()) {
+    auto *ghost_list = ghost->second.list_;
+    if (access_type != AccessType::Scan) {
+      // The page was evicted too early: grow the list it was evicted from, and treat it as frequently used.
+      if (ghost_list == &b1_) {
+        size_t delta = std::max<size_t>(1, b2_.size() / b1_.size());
+        target_t1_ = std::min(capacity_, target_t1_ + delta);
+      } else {
+        size_t delta = std::max<size_t>(1, b1_.size() / b2_.size());
+        target_t1_ -= std::min(target_t1_, delta);
+      }
+      list = &t2_;
+    }
+    ghost_list->erase(ghost->second.pos_);
+    ghosts_.erase(ghost);
+  }
+  list->push_back(frame_id);
+  node.list_ = list;
+  node.pos_ = std::prev(list->end());
+  node.page_id_ = page_id;
+  TrimGhosts();
+}
+
+void ARCReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock latch(latch_);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= nodes_.size() || nodes_[frame_id].list_ == nullptr) {
+    throw bustub::Exception(fmt::format("SetEvictable frame id: {} is invalid", frame_id));
+  }
+  auto &node = nodes_[frame_id];
+  if (node.is_evictable_ && !set_evictable) {
+    evictable_size_--;
+  } else if (!node.is_evictable_ && set_evictable) {
+    evictable_size_++;
+  }
+  node.is_evictable_ = set_evictable;
+}
+
+void ARCReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock latch(latch_);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= nodes_.size() || nodes_[frame_id].list_ == nullptr) {
+    return;
+  }
+  if (!nodes_[frame_id].is_evictable_) {
+    throw bustub::Exception(fmt::format("Remove frame id: {} is not evictable", frame_id));
+  }
+  Untrack(frame_id);
+}
+
+auto ARCReplacer::Size() -> size_t {
+  std::scoped_lock latch(latch_);
+  return evictable_size_;
+}
+
+auto ARCReplacer::GetEvictionOrder() -> std::vector<frame_id_t> {
+  std::scoped_lock latch(latch_);
+  // Pages seen once go before pages seen twice, each in LRU order.
+  std::vector<frame_id_t> frame_ids(t1_.begin(), t1_.end());
+  frame_ids.insert(frame_ids.end(), t2_.begin(), t2_.end());
+  return frame_ids;
+}
+
+}  // namespace bustub
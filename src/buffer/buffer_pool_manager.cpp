@@ -11,183 +11,940 @@
 //===----------------------------------------------------------------------===//
 
 #include "buffer/buffer_pool_manager.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <new>
+#include <tuple>
+#include <unordered_set>
 
 #include "common/exception.h"
+#include "common/logger.h"
 #include "common/macros.h"
+#include "fmt/format.h"
 #include "storage/page/page.h"
 #include "storage/page/page_guard.h"
+#include "storage/page/space_map_page.h"
 
 namespace bustub {
 
+/** @brief Wait for a disk request to complete. @return false if it failed, which is logged */
+static auto WaitForIo(std::future<bool> &future) -> bool {
+  try {
+    return future.get();
+  } catch (const std::exception &e) {
+    LOG_WARN("disk I/O failed: %s", e.what());
+    return false;
+  }
+}
+
 BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, size_t replacer_k,
-                                     LogManager *log_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
-  // TODO(students): remove this line after you have implemented the buffer pool manager
+                                     LogManager *log_manager, size_t num_shards, ReplacerPolicy replacer_policy)
+    : pool_size_(pool_size),
+      page_size_(disk_manager->GetPageSize()),
+      replacer_k_(replacer_k),
+      replacer_policy_(replacer_policy),
+      disk_manager_(disk_manager),
+      disk_scheduler_(std::make_unique<DiskScheduler>(disk_manager)),
+      log_manager_(log_manager) {
+  BUSTUB_ENSURE(num_shards > 0 && num_shards <= pool_size, "the number of shards must be in [1, pool_size]");
+
+  // we allocate a consecutive memory space for the buffer pool, and keep the page metadata apart from it
+  arena_ = std::make_unique<FrameArena>(pool_size_, page_size_, enable_huge_pages);
+  pages_ = static_cast<Page *>(::operator new[](pool_size_ * sizeof(Page), std::align_val_t{alignof(Page)}));
+  for (size_t i = 0; i < pool_size_; ++i) {
+    new (&pages_[i]) Page(arena_->GetFrame(static_cast<frame_id_t>(i)), page_size_);
+  }
+  frame_hints_ = std::make_unique<std::atomic<frame_id_t>[]>(pool_size_);
 
-  // we allocate a consecutive memory space for the buffer pool
-  pages_ = new Page[pool_size_];
-  replacer_ = std::make_unique<LRUKReplacer>(pool_size, replacer_k);
+  shards_.reserve(num_shards);
+  for (size_t i = 0; i < num_shards; ++i) {
+    shards_.emplace_back(std::make_unique<Shard>(pool_size_, replacer_k, replacer_policy, static_cast<page_id_t>(i)));
+  }
 
-  // Initially, every page is in the free list.
+  // Initially, every page is in the free list of the shard owning it. Frames without a page keep an odd version,
+  // so optimistic readers never trust what they see in them.
   for (size_t i = 0; i < pool_size_; ++i) {
-    free_list_.emplace_back(static_cast<int>(i));
+    shards_[i % num_shards]->free_list_.emplace_back(static_cast<int>(i));
+    shards_[i % num_shards]->frames_.emplace_back(static_cast<int>(i));
+    pages_[i].BeginWrite();
   }
 }
 
-BufferPoolManager::~BufferPoolManager() { delete[] pages_; }
+BufferPoolManager::~BufferPoolManager() {
+  StopBackgroundWriter();
+  SaveSpaceMap();
+  // Drain the scheduler first: completion callbacks of in-flight read-aheads still touch the shards and frames.
+  disk_scheduler_.reset();
+  for (size_t i = 0; i < pool_size_; ++i) {
+    pages_[i].~Page();
+  }
+  ::operator delete[](pages_, std::align_val_t{alignof(Page)});
+}
 
-auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * {
-  frame_id_t new_frame_id;
+auto BufferPoolManager::TakeFrame(Shard &shard, frame_id_t *frame_id, page_id_t *write_back_page_id) -> bool {
+  *write_back_page_id = INVALID_PAGE_ID;
+  if (!shard.free_list_.empty()) {
+    *frame_id = shard.free_list_.front();
+    shard.free_list_.pop_front();
+    return true;
+  }
+  if (!shard.replacer_->Evict(frame_id)) {
+    return false;
+  }
+  eviction_cnt_.Add();
+  auto &victim = pages_[*frame_id];
+  victim.BeginWrite();
+  page_id_t victim_page_id = victim.GetPageId();
+  shard.page_table_.erase(victim_page_id);
+  victim.SetPageId(INVALID_PAGE_ID);
+  if (victim.IsDirty()) {
+    // The frame is now neither in the page table nor in the replacer, so nobody else can reach it while it is
+    // written back without the latch. Fetchers of the victim page wait until the write has completed.
+    SetDirty(shard, victim, false);
+    write_back_cnt_.Add();
+    shard.in_transit_.insert(victim_page_id);
+    *write_back_page_id = victim_page_id;
+  }
+  return true;
+}
+
+auto BufferPoolManager::AcquireFrame(Shard &shard, std::unique_lock<std::mutex> &lock, frame_id_t *frame_id) -> bool {
+  page_id_t victim_page_id;
+  if (!TakeFrame(shard, frame_id, &victim_page_id)) {
+    return false;
+  }
+  if (victim_page_id != INVALID_PAGE_ID) {
+    auto promise = disk_scheduler_->CreatePromise();
+    auto future = promise.get_future();
+    disk_scheduler_->Schedule({/*is_write=*/true, pages_[*frame_id].GetData(), victim_page_id, std::move(promise)});
+    lock.unlock();
+    bool written = WaitForIo(future);
+    lock.lock();
+    if (!written) {
+      RestoreVictim(shard, *frame_id, victim_page_id);
+      return false;
+    }
+    shard.in_transit_.erase(victim_page_id);
+    shard.io_cv_.notify_all();
+  }
+  return true;
+}
+
+void BufferPoolManager::RestoreVictim(Shard &shard, frame_id_t frame_id, page_id_t victim_page_id) {
+  // The frame still holds the victim's data, which is now the only copy of its latest version.
+  auto &page = pages_[frame_id];
+  shard.in_transit_.erase(victim_page_id);
+  shard.page_table_[victim_page_id] = frame_id;
+  page.SetPageId(victim_page_id);
+  SetDirty(shard, page, true);
+  page.EndWrite();
+  shard.replacer_->RecordAccess(frame_id, AccessType::Unknown, victim_page_id);
+  shard.replacer_->SetEvictable(frame_id, page.pin_count_ == 0);
+  shard.io_cv_.notify_all();
+}
+
+void BufferPoolManager::AbandonRead(Shard &shard, frame_id_t frame_id, page_id_t victim_page_id) {
+  auto &page = pages_[frame_id];
+  shard.page_table_.erase(page.GetPageId());
+  page.io_in_progress_ = false;
+  page.read_ahead_mark_ = false;
+  if (victim_page_id != INVALID_PAGE_ID) {
+    RestoreVictim(shard, frame_id, victim_page_id);
+    return;
+  }
+  // The frame holds whatever part of the read landed, so it keeps its odd version until it is reused.
+  page.SetPageId(INVALID_PAGE_ID);
+  shard.replacer_->SetEvictable(frame_id, true);
+  shard.replacer_->Remove(frame_id);
+  if (page.pin_count_ == 0) {
+    shard.free_list_.push_back(frame_id);
+  }
+  shard.io_cv_.notify_all();
+}
+
+void BufferPoolManager::UnpinFrame(Shard &shard, frame_id_t frame_id) {
+  auto &page = pages_[frame_id];
+  if (--page.pin_count_ > 0) {
+    return;
+  }
+  if (page.GetPageId() == INVALID_PAGE_ID) {
+    shard.free_list_.push_back(frame_id);
+  } else {
+    shard.replacer_->SetEvictable(frame_id, true);
+  }
+}
+
+auto BufferPoolManager::PinResidentFrame(Shard &shard, std::unique_lock<std::mutex> &lock, frame_id_t frame_id,
+                                         AccessType access_type) -> Page * {
+  auto &page = pages_[frame_id];
+  page_id_t page_id = page.GetPageId();
+  page.pin_count_++;
+  shard.replacer_->RecordAccess(frame_id, access_type, page_id);
+  shard.replacer_->SetEvictable(frame_id, false);
+  // Our pin keeps the frame from being evicted while we wait for its contents to arrive.
+  shard.io_cv_.wait(lock, [&page] { return !page.io_in_progress_; });
+  if (page.GetPageId() != page_id) {
+    UnpinFrame(shard, frame_id);
+    return nullptr;
+  }
+  return &page;
+}
+
+void BufferPoolManager::ReadAhead(page_id_t page_id) {
+  size_t window = read_ahead_pages_;
+  bool marked = false;
+  for (size_t i = 1; i <= window; ++i) {
+    auto next_page_id = static_cast<page_id_t>(page_id + i);
+    // Mark the first page we actually start reading: when the scan reaches it, the rest of the window is hopefully
+    // still in flight, and extending the window from there keeps the disk busy.
+    bool started;
+    if (!PrefetchPage(GetShard(next_page_id), next_page_id, !marked, &started)) {
+      // The pool is full of pinned or in-flight pages; reading further ahead would only evict what we just read.
+      return;
+    }
+    marked = marked || started;
+  }
+}
+
+auto BufferPoolManager::PrefetchPage(Shard &shard, page_id_t page_id, bool mark, bool *started) -> bool {
+  std::scoped_lock latch(shard.latch_);
+  *started = false;
+  // Pages that are not allocated must not enter the page table, or NewPage would map them a second time.
+  if (!IsAllocated(shard, page_id) || shard.page_table_.count(page_id) > 0 || shard.in_transit_.count(page_id) > 0) {
+    return true;
+  }
 
-  latch_.lock();
+  frame_id_t frame_id;
+  page_id_t victim_page_id;
+  if (!TakeFrame(shard, &frame_id, &victim_page_id)) {
+    return false;
+  }
 
-  if (!free_list_.empty()) {
-    new_frame_id = free_list_.front();
-    free_list_.pop_front();
+  auto &page = pages_[frame_id];
+  shard.page_table_[page_id] = frame_id;
+  page.SetPageId(page_id);
+  page.pin_count_ = 0;
+  page.io_in_progress_ = true;
+  page.read_ahead_mark_ = mark;
+  shard.replacer_->RecordAccess(frame_id, AccessType::Scan, page_id);
+  // Not evictable until the read has landed; fetchers that arrive meanwhile pin the frame and wait as usual.
+  shard.replacer_->SetEvictable(frame_id, false);
 
-  } else if (replacer_->Evict(&new_frame_id)) {
-    if (pages_[new_frame_id].IsDirty()) {
-      disk_manager_->WritePage(pages_[new_frame_id].GetPageId(), pages_[new_frame_id].GetData());
-      pages_[new_frame_id].is_dirty_ = false;
+  auto on_read = [this, &shard, frame_id](bool read) {
+    std::scoped_lock latch(shard.latch_);
+    if (!read) {
+      AbandonRead(shard, frame_id, INVALID_PAGE_ID);
+      return;
     }
-    page_table_.erase(pages_[new_frame_id].page_id_);
-    pages_[new_frame_id].ResetMemory();
+    auto &page = pages_[frame_id];
+    page.io_in_progress_ = false;
+    page.EndWrite();
+    if (page.pin_count_ == 0) {
+      shard.replacer_->SetEvictable(frame_id, true);
+    }
+    shard.io_cv_.notify_all();
+  };
+
+  if (victim_page_id == INVALID_PAGE_ID) {
+    disk_scheduler_->Schedule(
+        {/*is_write=*/false, page.GetData(), page_id, disk_scheduler_->CreatePromise(), std::move(on_read)});
   } else {
-    page_id = nullptr;
-    latch_.unlock();
+    // Chain the read behind the write-back of the victim, which still occupies the frame.
+    auto on_write = [this, &shard, frame_id, page_id, victim_page_id, on_read = std::move(on_read)](bool written) {
+      {
+        std::scoped_lock latch(shard.latch_);
+        if (!written) {
+          AbandonRead(shard, frame_id, victim_page_id);
+          return;
+        }
+        shard.in_transit_.erase(victim_page_id);
+        shard.io_cv_.notify_all();
+      }
+      disk_scheduler_->Schedule(
+          {/*is_write=*/false, pages_[frame_id].GetData(), page_id, disk_scheduler_->CreatePromise(), on_read});
+    };
+    disk_scheduler_->Schedule(
+        {/*is_write=*/true, page.GetData(), victim_page_id, disk_scheduler_->CreatePromise(), std::move(on_write)});
+  }
+  *started = true;
+  return true;
+}
+
+auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * {
+  // Start from a different shard every time so that new pages are spread evenly, and fall back to the other
+  // shards if the preferred one has all of its frames pinned.
+  size_t start = next_shard_.fetch_add(1) % shards_.size();
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    auto *page = NewPageInShard(*shards_[(start + i) % shards_.size()], page_id);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+  return nullptr;
+}
+
+auto BufferPoolManager::NewPageInShard(Shard &shard, page_id_t *page_id) -> Page * {
+  std::unique_lock lock(shard.latch_);
+
+  frame_id_t new_frame_id;
+  if (!AcquireFrame(shard, lock, &new_frame_id)) {
     return nullptr;
   }
 
-  *page_id = AllocatePage();
-  page_table_[*page_id] = new_frame_id;
-  pages_[new_frame_id].page_id_ = *page_id;
-  pages_[new_frame_id].pin_count_++;             // pin count++
-  replacer_->RecordAccess(new_frame_id);         // 相当于第一次访问当前页
-  replacer_->SetEvictable(new_frame_id, false);  // 不能被替换
+  *page_id = AllocatePage(shard);
+  return InstallNewPage(shard, new_frame_id, *page_id);
+}
 
-  latch_.unlock();
-  return &pages_[new_frame_id];
+auto BufferPoolManager::InstallNewPage(Shard &shard, frame_id_t frame_id, page_id_t page_id) -> Page * {
+  BUSTUB_ASSERT(shard.page_table_.count(page_id) == 0, "a newly allocated page must not be resident");
+  auto &page = pages_[frame_id];
+  page.ResetMemory();
+  shard.page_table_[page_id] = frame_id;
+  page.SetPageId(page_id);
+  page.pin_count_ = 1;
+  page.read_ahead_mark_ = false;
+  page.EndWrite();
+  shard.replacer_->RecordAccess(frame_id, AccessType::Unknown, page_id);
+  shard.replacer_->SetEvictable(frame_id, false);
+  return &page;
 }
 
-auto BufferPoolManager::FetchPage(page_id_t page_id, [[maybe_unused]] AccessType access_type) -> Page * {
-  latch_.lock();
-  auto it = page_table_.find(page_id);
+auto BufferPoolManager::NewPageInExtent(Extent *extent, page_id_t *page_id) -> Page * {
+  std::scoped_lock extent_latch(extent->latch_);
+  if (extent->next_page_id_ == extent->end_page_id_) {
+    ReserveExtent(extent);
+  }
+
+  auto &shard = GetShard(extent->next_page_id_);
+  std::unique_lock lock(shard.latch_);
   frame_id_t new_frame_id;
-  if (it == page_table_.end()) {
-    if (!free_list_.empty()) {
-      new_frame_id = free_list_.front();
-      free_list_.pop_front();
-    } else if (replacer_->Evict(&new_frame_id)) {
-      if (pages_[new_frame_id].IsDirty()) {
-        disk_manager_->WritePage(pages_[new_frame_id].GetPageId(), pages_[new_frame_id].GetData());
-        pages_[new_frame_id].is_dirty_ = false;
-      }
-      // pages_[new_frame_id].ResetMemory();
-      page_table_.erase(pages_[new_frame_id].page_id_);
-      // //  std::cout<<"FetchPage ResetMemory";
-    } else {
-      latch_.unlock();
-      return nullptr;
+  if (!AcquireFrame(shard, lock, &new_frame_id)) {
+    return nullptr;
+  }
+  *page_id = extent->next_page_id_++;
+  shard.reserved_pages_.erase(*page_id);
+  return InstallNewPage(shard, new_frame_id, *page_id);
+}
+
+void BufferPoolManager::ReserveExtent(Extent *extent) {
+  std::vector<std::unique_lock<std::mutex>> locks;
+  page_id_t start = 0;
+  for (auto &shard : shards_) {
+    locks.emplace_back(shard->latch_);
+    start = std::max(start, shard->next_page_id_);
+  }
+  page_id_t end = start + BUSTUB_EXTENT_SIZE;
+  auto num_shards = static_cast<page_id_t>(shards_.size());
+  for (auto &shard : shards_) {
+    page_id_t page_id = shard->next_page_id_;
+    for (; page_id < end; page_id += num_shards) {
+      if (page_id < start) {
+        shard->free_pages_.insert(page_id);
+      } else {
+        shard->reserved_pages_.insert(page_id);
+      }
+    }
+    shard->next_page_id_ = page_id;
+  }
+  extent->next_page_id_ = start;
+  extent->end_page_id_ = end;
+}
+
+void BufferPoolManager::ReleaseExtent(Extent *extent) {
+  std::scoped_lock extent_latch(extent->latch_);
+  for (page_id_t page_id = extent->next_page_id_; page_id < extent->end_page_id_; ++page_id) {
+    auto &shard = GetShard(page_id);
+    std::scoped_lock latch(shard.latch_);
+    if (shard.reserved_pages_.erase(page_id) > 0) {
+      shard.free_pages_.insert(page_id);
     }
-    page_table_[page_id] = new_frame_id;
-    pages_[new_frame_id].page_id_ = page_id;
-    disk_manager_->ReadPage(page_id, pages_[new_frame_id].data_);
-  } else {
-    new_frame_id = it->second;
   }
-  replacer_->RecordAccess(new_frame_id);         // 相当于第一次访问当前页
-  replacer_->SetEvictable(new_frame_id, false);  // 不能被替换
-  pages_[new_frame_id].pin_count_++;             // pin count++
-  latch_.unlock();
-  return &pages_[new_frame_id];
+  extent->next_page_id_ = INVALID_PAGE_ID;
+  extent->end_page_id_ = INVALID_PAGE_ID;
+}
+
+auto BufferPoolManager::FetchPage(page_id_t page_id, AccessType access_type) -> Page * {
+  auto &shard = GetShard(page_id);
+  std::unique_lock lock(shard.latch_);
+  fetch_cnt_.Add();
+
+  // Wait for any other thread that is currently moving this page between disk and a frame.
+  bool waited = shard.in_transit_.count(page_id) > 0;
+  shard.io_cv_.wait(lock, [&] { return shard.in_transit_.count(page_id) == 0; });
+  auto it = shard.page_table_.find(page_id);
+  if (it != shard.page_table_.end()) {
+    hit_cnt_.Add();
+    if (waited || pages_[it->second].io_in_progress_) {
+      pin_wait_cnt_.Add();
+    }
+    auto *page = PinResidentFrame(shard, lock, it->second, access_type);
+    if (page != nullptr && access_type == AccessType::Scan && page->read_ahead_mark_) {
+      page->read_ahead_mark_ = false;
+      lock.unlock();
+      ReadAhead(page_id);
+    }
+    return page;
+  }
+
+  if (!ClaimFetchable(shard, page_id)) {
+    return nullptr;
+  }
+  miss_cnt_.Add();
+  if (waited) {
+    pin_wait_cnt_.Add();
+  }
+  // Claim the page so that concurrent fetchers wait for us instead of acquiring frames of their own, since
+  // AcquireFrame may drop the latch to write back a victim.
+  shard.in_transit_.insert(page_id);
+  frame_id_t frame_id;
+  bool acquired = AcquireFrame(shard, lock, &frame_id);
+  shard.in_transit_.erase(page_id);
+  shard.io_cv_.notify_all();
+  if (!acquired) {
+    return nullptr;
+  }
+
+  auto &page = pages_[frame_id];
+  shard.page_table_[page_id] = frame_id;
+  page.SetPageId(page_id);
+  page.pin_count_ = 1;
+  page.io_in_progress_ = true;
+  page.read_ahead_mark_ = false;
+  shard.replacer_->RecordAccess(frame_id, access_type, page_id);
+  shard.replacer_->SetEvictable(frame_id, false);
+
+  auto promise = disk_scheduler_->CreatePromise();
+  auto future = promise.get_future();
+  disk_scheduler_->Schedule({/*is_write=*/false, page.data_, page_id, std::move(promise)});
+  lock.unlock();
+  if (access_type == AccessType::Scan) {
+    // Issue the reads of the following pages while our own read is in flight.
+    ReadAhead(page_id);
+  }
+  bool read = WaitForIo(future);
+  lock.lock();
+
+  if (!read) {
+    AbandonRead(shard, frame_id, INVALID_PAGE_ID);
+    UnpinFrame(shard, frame_id);
+    return nullptr;
+  }
+  page.io_in_progress_ = false;
+  page.EndWrite();
+  shard.io_cv_.notify_all();
+  return &page;
 }
 
 auto BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty, [[maybe_unused]] AccessType access_type) -> bool {
-  latch_.lock();
-  auto it = page_table_.find(page_id);
-  if (it == page_table_.end()) {
-    latch_.unlock();
+  auto &shard = GetShard(page_id);
+  std::scoped_lock latch(shard.latch_);
+
+  auto it = shard.page_table_.find(page_id);
+  if (it == shard.page_table_.end()) {
     return false;
   }
-  if (pages_[it->second].GetPinCount() == 0) {
-    latch_.unlock();
+  auto &page = pages_[it->second];
+  if (page.GetPinCount() == 0) {
     return false;
   }
-  if (is_dirty) {
-    pages_[it->second].is_dirty_ = true;
+  if (is_dirty && !page.is_dirty_) {
+    SetDirty(shard, page, true);
+    if (shard.num_dirty_ > dirty_high_water_ * shard.frames_.size()) {
+      // Let the background writer catch up before evictions have to write dirty victims themselves.
+      background_writer_cv_.notify_one();
+    }
   }
-  pages_[it->second].pin_count_--;
-  if (pages_[it->second].GetPinCount() == 0) {
-    replacer_->SetEvictable(it->second, true);
+  page.pin_count_--;
+  if (page.GetPinCount() == 0) {
+    shard.replacer_->SetEvictable(it->second, true);
   }
-  latch_.unlock();
   return true;
 }
 
+void BufferPoolManager::SetDirty(Shard &shard, Page &page, bool is_dirty) {
+  if (page.is_dirty_ != is_dirty) {
+    page.is_dirty_ = is_dirty;
+    if (is_dirty) {
+      shard.num_dirty_++;
+    } else {
+      shard.num_dirty_--;
+    }
+  }
+}
+
+auto BufferPoolManager::WriteBack(Shard &shard, std::unique_lock<std::mutex> &lock,
+                                  const std::vector<frame_id_t> &frame_ids) -> bool {
+  // Pin the pages so that they stay in their frames while we write them without the latch; the completion of an
+  // asynchronous read may need the latch in the meantime.
+  for (auto frame_id : frame_ids) {
+    auto &page = pages_[frame_id];
+    page.pin_count_++;
+    page.write_back_pins_++;
+    shard.replacer_->SetEvictable(frame_id, false);
+  }
+  shard.io_cv_.wait(lock, [&] {
+    return std::none_of(frame_ids.begin(), frame_ids.end(),
+                        [&](frame_id_t frame_id) { return pages_[frame_id].io_in_progress_; });
+  });
+
+  // Hand all pages to the scheduler as one batch so that they are written out in parallel.
+  std::vector<DiskRequest> requests;
+  std::vector<std::future<bool>> futures;
+  for (auto frame_id : frame_ids) {
+    auto &page = pages_[frame_id];
+    SetDirty(shard, page, false);
+    auto promise = disk_scheduler_->CreatePromise();
+    futures.push_back(promise.get_future());
+    requests.push_back({/*is_write=*/true, page.GetData(), page.GetPageId(), std::move(promise)});
+  }
+  write_back_cnt_.Add(frame_ids.size());
+  disk_scheduler_->Schedule(std::move(requests));
+  lock.unlock();
+  std::vector<bool> written;
+  for (auto &future : futures) {
+    written.push_back(WaitForIo(future));
+  }
+  lock.lock();
+
+  for (size_t i = 0; i < frame_ids.size(); ++i) {
+    auto &page = pages_[frame_ids[i]];
+    if (!written[i]) {
+      SetDirty(shard, page, true);
+    }
+    page.write_back_pins_--;
+    UnpinFrame(shard, frame_ids[i]);
+  }
+  shard.io_cv_.notify_all();
+  return std::all_of(written.begin(), written.end(), [](bool ok) { return ok; });
+}
+
 auto BufferPoolManager::FlushPage(page_id_t page_id) -> bool {
-  latch_.lock();
-  auto it = page_table_.find(page_id);
-  if (it == page_table_.end()) {
+  auto &shard = GetShard(page_id);
+  std::unique_lock lock(shard.latch_);
+
+  // A page that is still being read has nothing to write yet, and its read may fail and take it out of the pool.
+  shard.io_cv_.wait(lock, [&] {
+    auto it = shard.page_table_.find(page_id);
+    return it == shard.page_table_.end() || !pages_[it->second].io_in_progress_;
+  });
+  auto it = shard.page_table_.find(page_id);
+  if (it == shard.page_table_.end()) {
     return false;
   }
-  if (pages_[it->second].is_dirty_) {
-    pages_[it->second].is_dirty_ = false;
-    disk_manager_->WritePage(pages_[it->second].GetPageId(), pages_[it->second].GetData());
-  }
-  latch_.unlock();
-  return true;
+  bool written = WriteBack(shard, lock, {it->second});
+  // Shard latches are never held across disk I/O.
+  lock.unlock();
+  disk_manager_->SyncPages();
+  return written;
 }
 
 void BufferPoolManager::FlushAllPages() {
-  latch_.lock();
-  for (auto it : page_table_) {
-    if (pages_[it.second].is_dirty_) {
-      pages_[it.second].is_dirty_ = false;
-      disk_manager_->WritePage(pages_[it.second].GetPageId(), pages_[it.second].GetData());
+  for (auto &shard : shards_) {
+    std::unique_lock lock(shard->latch_);
+    std::vector<frame_id_t> dirty_frames;
+    for (auto [page_id, frame_id] : shard->page_table_) {
+      if (pages_[frame_id].is_dirty_) {
+        dirty_frames.push_back(frame_id);
+      }
+    }
+    // Pages that fail to be written stay dirty for the next flush.
+    WriteBack(*shard, lock, dirty_frames);
+  }
+  SaveSpaceMap();
+  // One sync makes every page written above durable.
+  disk_manager_->SyncPages();
+}
+
+void BufferPoolManager::StartBackgroundWriter(double dirty_high_water, std::chrono::milliseconds interval) {
+  StopBackgroundWriter();
+  dirty_high_water_ = dirty_high_water;
+  background_writer_stop_ = false;
+  background_writer_ = std::thread([this, interval] {
+    std::unique_lock lock(background_writer_latch_);
+    while (!background_writer_stop_) {
+      lock.unlock();
+      for (auto &shard : shards_) {
+        RunBackgroundWriter(*shard);
+      }
+      lock.lock();
+      background_writer_cv_.wait_for(lock, interval);
+    }
+  });
+}
+
+void BufferPoolManager::StopBackgroundWriter() {
+  if (!background_writer_.joinable()) {
+    return;
+  }
+  {
+    std::scoped_lock latch(background_writer_latch_);
+    background_writer_stop_ = true;
+  }
+  background_writer_cv_.notify_one();
+  background_writer_.join();
+}
+
+void BufferPoolManager::RunBackgroundWriter(Shard &shard) {
+  std::unique_lock lock(shard.latch_);
+  // Trickle a few pages every round, and as many as it takes to get back under the high-water mark.
+  auto high_water = static_cast<size_t>(dirty_high_water_ * shard.frames_.size());
+  size_t budget = BACKGROUND_WRITER_MAX_PAGES;
+  if (shard.num_dirty_ > high_water) {
+    budget = std::max(budget, shard.num_dirty_ - high_water);
+  }
+
+  // Sweep the frames of the shard round-robin and pick the dirty ones nobody is using. Pinned pages will likely be
+  // dirtied again before they are evicted, so writing them now would be wasted.
+  std::vector<frame_id_t> frame_ids;
+  for (size_t i = 0; i < shard.frames_.size() && frame_ids.size() < budget && shard.num_dirty_ > frame_ids.size();
+       ++i) {
+    frame_id_t frame_id = shard.frames_[shard.writer_cursor_];
+    shard.writer_cursor_ = (shard.writer_cursor_ + 1) % shard.frames_.size();
+    auto &page = pages_[frame_id];
+    if (page.is_dirty_ && page.pin_count_ == 0 && !page.io_in_progress_) {
+      frame_ids.push_back(frame_id);
     }
   }
-  latch_.unlock();
+  if (!frame_ids.empty()) {
+    WriteBack(shard, lock, frame_ids);
+  }
 }
 
 auto BufferPoolManager::DeletePage(page_id_t page_id) -> bool {
-  latch_.lock();
-  auto it = page_table_.find(page_id);
-  if (it == page_table_.end()) {
-    DeallocatePage(page_id);
-    latch_.unlock();
+  auto &shard = GetShard(page_id);
+  std::unique_lock lock(shard.latch_);
+
+  // An unpinned page may still be in the middle of a read-ahead, or pinned only by a write-back. An evicted page may
+  // still be on its way to disk, and its id must not be reused before that write is done.
+  shard.io_cv_.wait(lock, [&] {
+    if (shard.in_transit_.count(page_id) > 0) {
+      return false;
+    }
+    auto it = shard.page_table_.find(page_id);
+    return it == shard.page_table_.end() ||
+           (!pages_[it->second].io_in_progress_ && pages_[it->second].write_back_pins_ == 0);
+  });
+  auto it = shard.page_table_.find(page_id);
+  if (it == shard.page_table_.end()) {
+    DeallocatePage(shard, page_id);
     return true;
   }
-  if (pages_[it->second].GetPinCount() != 0) {
-    latch_.unlock();
+  frame_id_t frame_id = it->second;
+  auto &page = pages_[frame_id];
+  if (page.GetPinCount() != 0) {
     return false;
   }
-  replacer_->Remove(it->second);
-  if (pages_[it->second].is_dirty_) {
-    pages_[it->second].is_dirty_ = false;
-    disk_manager_->WritePage(pages_[it->second].GetPageId(), pages_[it->second].GetData());
-  }
-  pages_[it->second].page_id_ = INVALID_PAGE_ID;
-  pages_[it->second].ResetMemory();  // reset memory
-  free_list_.push_back(it->second);
-  page_table_.erase(page_id);
-  DeallocatePage(page_id);
-  latch_.unlock();
+  page.BeginWrite();
+  shard.replacer_->Remove(frame_id);
+  shard.page_table_.erase(it);
+  page.SetPageId(INVALID_PAGE_ID);
+  SetDirty(shard, page, false);
+  page.ResetMemory();
+  shard.free_list_.push_back(frame_id);
+  DeallocatePage(shard, page_id);
   return true;
 }
 
-auto BufferPoolManager::AllocatePage() -> page_id_t {
-  page_id_t page_id = next_page_id_;
-  next_page_id_++;
+void BufferPoolManager::SetReplacerPolicy(ReplacerPolicy replacer_policy) {
+  replacer_policy_ = replacer_policy;
+  for (auto &shard : shards_) {
+    std::scoped_lock latch(shard->latch_);
+    auto replacer = MakeReplacer(replacer_policy, pool_size_, replacer_k_);
+    for (auto [page_id, frame_id] : shard->page_table_) {
+      auto &page = pages_[frame_id];
+      replacer->RecordAccess(frame_id, AccessType::Unknown, page_id);
+      replacer->SetEvictable(frame_id, page.pin_count_ == 0 && !page.io_in_progress_);
+    }
+    shard->replacer_ = std::move(replacer);
+  }
+}
+
+auto BufferPoolManager::AllocatePage(Shard &shard) -> page_id_t {
+  if (!shard.free_pages_.empty()) {
+    page_id_t page_id = *shard.free_pages_.begin();
+    shard.free_pages_.erase(shard.free_pages_.begin());
+    return page_id;
+  }
+  page_id_t page_id = shard.next_page_id_;
+  shard.next_page_id_ += static_cast<page_id_t>(shards_.size());
   return page_id;
 }
 
-auto BufferPoolManager::FetchPageBasic(page_id_t page_id) -> BasicPageGuard {
-  return BasicPageGuard{this, FetchPage(page_id)};
+auto BufferPoolManager::ClaimFetchable(Shard &shard, page_id_t page_id) -> bool {
+  if (!space_map_loaded_ && page_id >= shard.next_page_id_) {
+    shard.next_page_id_ = page_id + static_cast<page_id_t>(shards_.size());
+  }
+  return IsAllocated(shard, page_id);
 }
 
-auto BufferPoolManager::FetchPageRead(page_id_t page_id) -> ReadPageGuard {
-  Page *page = FetchPage(page_id);
+void BufferPoolManager::DeallocatePage(Shard &shard, page_id_t page_id) {
+  if (page_id < 0 || page_id >= shard.next_page_id_ || (space_map_loaded_ && page_id == SPACE_MAP_PAGE_ID) ||
+      shard.reserved_pages_.count(page_id) > 0 ||
+      std::find(shard.trunk_pages_.begin(), shard.trunk_pages_.end(), page_id) != shard.trunk_pages_.end()) {
+    return;
+  }
+  shard.free_pages_.insert(page_id);
+}
+
+void BufferPoolManager::DiskIo(bool is_write, char *data, page_id_t page_id) {
+  auto promise = disk_scheduler_->CreatePromise();
+  auto future = promise.get_future();
+  disk_scheduler_->Schedule({is_write, data, page_id, std::move(promise)});
+  future.get();
+}
+
+void BufferPoolManager::LoadSpaceMap() {
+  std::scoped_lock space_map_latch(space_map_latch_);
+  BUSTUB_ENSURE(shards_.size() <= SpaceMapHeaderPage::MAX_SHARDS, "too many shards for the space map");
+
+  // A fresh database file reads as zeroes (or not at all), which never matches the magic.
+  auto header_data = std::make_unique<char[]>(page_size_);
+  DiskIo(/*is_write=*/false, header_data.get(), SPACE_MAP_PAGE_ID);
+  auto *header = reinterpret_cast<SpaceMapHeaderPage *>(header_data.get());
+
+  // Every page id below end_page_id has been allocated at some point, unless it is listed as free.
+  page_id_t end_page_id = SPACE_MAP_PAGE_ID + 1;
+  std::vector<page_id_t> free_page_ids;
+  std::unordered_set<page_id_t> trunk_page_ids;
+  if (header->magic_ == SpaceMapHeaderPage::MAGIC) {
+    if (header->page_size_ != page_size_) {
+      throw Exception(fmt::format("the database has pages of {} bytes, not {}", header->page_size_, page_size_));
+    }
+    if (header->num_shards_ == 0 || header->num_shards_ > SpaceMapHeaderPage::MAX_SHARDS) {
+      throw Exception("corrupted space map");
+    }
+    auto saved_shards = static_cast<page_id_t>(header->num_shards_);
+    for (page_id_t i = 0; i < saved_shards; ++i) {
+      if (header->shards_[i].next_page_id_ < 0) {
+        throw Exception("corrupted space map");
+      }
+      end_page_id = std::max(end_page_id, header->shards_[i].next_page_id_);
+    }
+    const size_t trunk_capacity = SpaceMapTrunkPage::Capacity(page_size_);
+    auto trunk_data = std::make_unique<char[]>(page_size_);
+    auto *trunk = reinterpret_cast<SpaceMapTrunkPage *>(trunk_data.get());
+    for (page_id_t i = 0; i < saved_shards; ++i) {
+      const auto &entry = header->shards_[i];
+      // The shards may have been configured differently before; pages a shard never got to allocate are free too.
+      for (page_id_t page_id = entry.next_page_id_; page_id < end_page_id; page_id += saved_shards) {
+        free_page_ids.push_back(page_id);
+      }
+      // Only follow trunks within the file, and each of them once, so that a damaged chain cannot lead astray.
+      for (page_id_t trunk_page_id = entry.first_trunk_page_id_; trunk_page_id != INVALID_PAGE_ID;
+           trunk_page_id = trunk->next_trunk_page_id_) {
+        if (trunk_page_id <= SPACE_MAP_PAGE_ID || trunk_page_id >= end_page_id ||
+            !trunk_page_ids.insert(trunk_page_id).second) {
+          throw Exception("corrupted space map");
+        }
+        DiskIo(/*is_write=*/false, trunk_data.get(), trunk_page_id);
+        if (trunk->size_ > trunk_capacity) {
+          throw Exception("corrupted space map");
+        }
+        for (uint32_t j = 0; j < trunk->size_; ++j) {
+          if (trunk->page_ids_[j] < 0 || trunk->page_ids_[j] >= end_page_id) {
+            throw Exception("corrupted space map");
+          }
+        }
+        free_page_ids.insert(free_page_ids.end(), trunk->page_ids_, trunk->page_ids_ + trunk->size_);
+      }
+    }
+  }
+
+  auto num_shards = static_cast<page_id_t>(shards_.size());
+  for (page_id_t i = 0; i < num_shards; ++i) {
+    std::scoped_lock latch(shards_[i]->latch_);
+    // The first page id of this shard at or after end_page_id.
+    shards_[i]->next_page_id_ = end_page_id + ((i - end_page_id % num_shards) + num_shards) % num_shards;
+    shards_[i]->free_pages_.clear();
+    shards_[i]->reserved_pages_.clear();
+    shards_[i]->trunk_pages_.clear();
+  }
+  // The trunks are listed as free, but the header on disk keeps pointing at them until the map is saved again.
+  for (auto page_id : trunk_page_ids) {
+    auto &shard = GetShard(page_id);
+    std::scoped_lock latch(shard.latch_);
+    shard.trunk_pages_.push_back(page_id);
+  }
+  for (auto page_id : free_page_ids) {
+    if (page_id != SPACE_MAP_PAGE_ID && trunk_page_ids.count(page_id) == 0) {
+      auto &shard = GetShard(page_id);
+      std::scoped_lock latch(shard.latch_);
+      shard.free_pages_.insert(page_id);
+    }
+  }
+  space_map_loaded_ = true;
+}
+
+void BufferPoolManager::SaveSpaceMap() {
+  std::scoped_lock space_map_latch(space_map_latch_);
+  if (!space_map_loaded_) {
+    return;
+  }
+
+  auto header_data = std::make_unique<char[]>(page_size_);
+  auto *header = reinterpret_cast<SpaceMapHeaderPage *>(header_data.get());
+  header->magic_ = SpaceMapHeaderPage::MAGIC;
+  header->page_size_ = page_size_;
+  header->num_shards_ = shards_.size();
+  const size_t trunk_capacity = SpaceMapTrunkPage::Capacity(page_size_);
+  auto num_shards = static_cast<page_id_t>(shards_.size());
+
+  std::vector<std::vector<page_id_t>> old_trunk_page_ids(shards_.size());
+  std::vector<std::vector<page_id_t>> new_trunk_page_ids(shards_.size());
+  std::vector<std::unique_ptr<char[]>> trunk_data;
+  std::vector<DiskRequest> requests;
+  std::vector<std::future<bool>> futures;
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    auto &shard = *shards_[i];
+    auto &trunk_page_ids = new_trunk_page_ids[i];
+    std::vector<page_id_t> free_page_ids;
+    {
+      std::scoped_lock latch(shard.latch_);
+      // The trunks of the map on disk are free in the new one, and so are the pages that extents reserved but have
+      // not handed out, as the extents do not outlive the buffer pool. The new trunks are taken out of the free pages,
+      // and fresh pages are appended if there are too few of them. Both are listed as free too.
+      old_trunk_page_ids[i] = shard.trunk_pages_;
+      free_page_ids.assign(shard.free_pages_.begin(), shard.free_pages_.end());
+      free_page_ids.insert(free_page_ids.end(), shard.trunk_pages_.begin(), shard.trunk_pages_.end());
+      free_page_ids.insert(free_page_ids.end(), shard.reserved_pages_.begin(), shard.reserved_pages_.end());
+      auto it = shard.free_pages_.begin();
+      while (trunk_page_ids.size() * trunk_capacity < free_page_ids.size()) {
+        if (it != shard.free_pages_.end()) {
+          trunk_page_ids.push_back(*it);
+          it = shard.free_pages_.erase(it);
+        } else {
+          trunk_page_ids.push_back(shard.next_page_id_);
+          free_page_ids.push_back(shard.next_page_id_);
+          shard.next_page_id_ += num_shards;
+        }
+      }
+      header->shards_[i].next_page_id_ = shard.next_page_id_;
+    }
+    header->shards_[i].first_trunk_page_id_ = trunk_page_ids.empty() ? INVALID_PAGE_ID : trunk_page_ids[0];
+
+    for (size_t j = 0; j < trunk_page_ids.size(); ++j) {
+      trunk_data.push_back(std::make_unique<char[]>(page_size_));
+      auto *trunk = reinterpret_cast<SpaceMapTrunkPage *>(trunk_data.back().get());
+      trunk->next_trunk_page_id_ = j + 1 < trunk_page_ids.size() ? trunk_page_ids[j + 1] : INVALID_PAGE_ID;
+      size_t begin = j * trunk_capacity;
+      trunk->size_ = std::min(trunk_capacity, free_page_ids.size() - begin);
+      std::copy_n(&free_page_ids[begin], trunk->size_, trunk->page_ids_);
+      auto promise = disk_scheduler_->CreatePromise();
+      futures.push_back(promise.get_future());
+      requests.push_back({/*is_write=*/true, trunk_data.back().get(), trunk_page_ids[j], std::move(promise)});
+    }
+  }
+  disk_scheduler_->Schedule(std::move(requests));
+  for (auto &future : futures) {
+    future.get();
+  }
+
+  // The header goes last and only once the trunks are durable, so that it only ever points at trunks that are on
+  // disk. The old trunks are reused only once the new header is durable and no longer points at them.
+  disk_manager_->SyncPages();
+  DiskIo(/*is_write=*/true, header_data.get(), SPACE_MAP_PAGE_ID);
+  disk_manager_->SyncPages();
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    auto &shard = *shards_[i];
+    std::scoped_lock latch(shard.latch_);
+    shard.free_pages_.insert(old_trunk_page_ids[i].begin(), old_trunk_page_ids[i].end());
+    shard.trunk_pages_ = std::move(new_trunk_page_ids[i]);
+  }
+}
+
+auto BufferPoolManager::DumpResidentPages(const std::string &file_name) -> bool {
+  std::vector<std::pair<double, page_id_t>> ranked_page_ids;
+  for (auto &shard : shards_) {
+    std::scoped_lock latch(shard->latch_);
+    auto frame_ids = shard->replacer_->GetEvictionOrder();
+    for (size_t i = 0; i < frame_ids.size(); ++i) {
+      const auto &page = pages_[frame_ids[i]];
+      if (page.GetPageId() != INVALID_PAGE_ID && !page.io_in_progress_) {
+        // The shards rank their frames independently, so interleave them by relative position.
+        ranked_page_ids.emplace_back(static_cast<double>(i + 1) / frame_ids.size(), page.GetPageId());
+      }
+    }
+  }
+  std::stable_sort(ranked_page_ids.begin(), ranked_page_ids.end(),
+                   [](const auto &a, const auto &b) { return a.first < b.first; });
+
+  // Write a new file and move it into place, so that a crash never leaves a truncated dump behind. The new file must
+  // be on disk before the rename is, or a crash could leave an empty file in place of the old dump.
+  auto temp_file_name = file_name + ".tmp";
+  {
+    std::ofstream out(temp_file_name, std::ios::out | std::ios::trunc);
+    for (auto [rank, page_id] : ranked_page_ids) {
+      out << page_id << '\n';
+    }
+    out.close();
+    if (!out.good()) {
+      return false;
+    }
+  }
+  int fd = open(temp_file_name.c_str(), O_WRONLY);
+  bool synced = fd >= 0 && fsync(fd) == 0;
+  if (fd >= 0) {
+    close(fd);
+  }
+  return synced && std::rename(temp_file_name.c_str(), file_name.c_str()) == 0;
+}
+
+auto BufferPoolManager::WarmUp(const std::string &file_name) -> size_t {
+  std::ifstream in(file_name);
+  std::vector<page_id_t> page_ids;
+  for (page_id_t page_id; in >> page_id;) {
+    page_ids.push_back(page_id);
+  }
+  // Keep the hottest pages that fit, and drop the ones that have been deleted since the dump.
+  if (page_ids.size() > pool_size_) {
+    page_ids.erase(page_ids.begin(), page_ids.end() - pool_size_);
+  }
+  page_ids.erase(std::remove_if(page_ids.begin(), page_ids.end(),
+                                [this](page_id_t page_id) {
+                                  if (page_id < 0) {
+                                    return true;
+                                  }
+                                  auto &shard = GetShard(page_id);
+                                  std::scoped_lock latch(shard.latch_);
+                                  return !IsAllocated(shard, page_id);
+                                }),
+                 page_ids.end());
+
+  std::vector<page_id_t> sorted_page_ids = page_ids;
+  std::sort(sorted_page_ids.begin(), sorted_page_ids.end());
+  sorted_page_ids.erase(std::unique(sorted_page_ids.begin(), sorted_page_ids.end()), sorted_page_ids.end());
+  // Read them as scans, which leaves the recency to the accesses below.
+  auto pages = FetchPages(sorted_page_ids, AccessType::Scan);
+
+  for (auto page_id : page_ids) {
+    auto &shard = GetShard(page_id);
+    std::scoped_lock latch(shard.latch_);
+    auto it = shard.page_table_.find(page_id);
+    if (it != shard.page_table_.end()) {
+      shard.replacer_->RecordAccess(it->second, AccessType::Unknown, page_id);
+    }
+  }
+  size_t num_loaded = 0;
+  for (auto *page : pages) {
+    if (page != nullptr) {
+      UnpinPage(page->GetPageId(), false);
+      num_loaded++;
+    }
+  }
+  return num_loaded;
+}
+
+auto BufferPoolManager::FetchPageBasic(page_id_t page_id, AccessType access_type) -> BasicPageGuard {
+  return BasicPageGuard{this, FetchPage(page_id, access_type)};
+}
+
+auto BufferPoolManager::FetchPageRead(page_id_t page_id, AccessType access_type) -> ReadPageGuard {
+  Page *page = FetchPage(page_id, access_type);
   if (page == nullptr) {
     return ReadPageGuard{this, nullptr};
   }
@@ -195,8 +952,8 @@ auto BufferPoolManager::FetchPageRead(page_id_t page_id) -> ReadPageGuard {
   return ReadPageGuard{this, page};
 }
 
-auto BufferPoolManager::FetchPageWrite(page_id_t page_id) -> WritePageGuard {
-  Page *page = FetchPage(page_id);
+auto BufferPoolManager::FetchPageWrite(page_id_t page_id, AccessType access_type) -> WritePageGuard {
+  Page *page = FetchPage(page_id, access_type);
   if (page == nullptr) {
     return WritePageGuard{this, nullptr};
   }
@@ -204,8 +961,244 @@ auto BufferPoolManager::FetchPageWrite(page_id_t page_id) -> WritePageGuard {
   return WritePageGuard{this, page};
 }
 
+auto BufferPoolManager::FetchPages(const std::vector<page_id_t> &page_ids, AccessType access_type)
+    -> std::vector<Page *> {
+  std::vector<Page *> pages(page_ids.size(), nullptr);
+  std::vector<std::vector<size_t>> shard_indexes(shards_.size());
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    shard_indexes[page_ids[i] % shards_.size()].push_back(i);
+  }
+
+  // Phase 1: pin the resident pages and install the missing ones in free frames, shard by shard, without any I/O.
+  std::vector<DiskRequest> writes;
+  std::vector<std::future<bool>> write_futures;
+  std::vector<std::tuple<Shard *, frame_id_t, page_id_t>> write_back_page_ids;
+  std::vector<std::pair<Shard *, frame_id_t>> read_frame_ids;
+  std::vector<size_t> fallback_indexes;
+  for (size_t shard_index = 0; shard_index < shards_.size(); ++shard_index) {
+    auto &indexes = shard_indexes[shard_index];
+    if (indexes.empty()) {
+      continue;
+    }
+    std::sort(indexes.begin(), indexes.end(), [&](size_t a, size_t b) { return page_ids[a] < page_ids[b]; });
+    auto &shard = *shards_[shard_index];
+    std::scoped_lock latch(shard.latch_);
+    for (auto i : indexes) {
+      page_id_t page_id = page_ids[i];
+      auto it = shard.page_table_.find(page_id);
+      if (it != shard.page_table_.end()) {
+        auto &page = pages_[it->second];
+        page.pin_count_++;
+        shard.replacer_->RecordAccess(it->second, access_type, page_id);
+        shard.replacer_->SetEvictable(it->second, false);
+        fetch_cnt_.Add();
+        hit_cnt_.Add();
+        if (page.io_in_progress_) {
+          pin_wait_cnt_.Add();
+        }
+        pages[i] = &page;
+        continue;
+      }
+      if (!ClaimFetchable(shard, page_id)) {
+        continue;
+      }
+      frame_id_t frame_id;
+      page_id_t victim_page_id;
+      if (shard.in_transit_.count(page_id) > 0 || !TakeFrame(shard, &frame_id, &victim_page_id)) {
+        // Someone else is moving the page, or the shard is out of frames; FetchPage() knows how to deal with that.
+        fallback_indexes.push_back(i);
+        continue;
+      }
+      auto &page = pages_[frame_id];
+      if (victim_page_id != INVALID_PAGE_ID) {
+        auto promise = disk_scheduler_->CreatePromise();
+        write_futures.push_back(promise.get_future());
+        writes.push_back({/*is_write=*/true, page.GetData(), victim_page_id, std::move(promise)});
+        write_back_page_ids.emplace_back(&shard, frame_id, victim_page_id);
+      }
+      shard.page_table_[page_id] = frame_id;
+      page.SetPageId(page_id);
+      page.pin_count_ = 1;
+      page.io_in_progress_ = true;
+      page.read_ahead_mark_ = false;
+      shard.replacer_->RecordAccess(frame_id, access_type, page_id);
+      shard.replacer_->SetEvictable(frame_id, false);
+      fetch_cnt_.Add();
+      miss_cnt_.Add();
+      read_frame_ids.emplace_back(&shard, frame_id);
+      pages[i] = &page;
+    }
+  }
+
+  // Phase 2: the victims still occupy the frames the reads go into, so write them all back first. A victim that
+  // could not be written keeps its frame, and the page that was to be read into it is not fetched.
+  if (!writes.empty()) {
+    disk_scheduler_->Schedule(std::move(writes));
+    std::unordered_set<frame_id_t> abandoned_frame_ids;
+    for (size_t j = 0; j < write_futures.size(); ++j) {
+      bool written = WaitForIo(write_futures[j]);
+      auto [shard, frame_id, page_id] = write_back_page_ids[j];
+      std::scoped_lock latch(shard->latch_);
+      if (written) {
+        shard->in_transit_.erase(page_id);
+        shard->io_cv_.notify_all();
+      } else {
+        AbandonRead(*shard, frame_id, page_id);
+        abandoned_frame_ids.insert(frame_id);
+      }
+    }
+    read_frame_ids.erase(std::remove_if(read_frame_ids.begin(), read_frame_ids.end(),
+                                        [&](auto read) { return abandoned_frame_ids.count(read.second) > 0; }),
+                         read_frame_ids.end());
+  }
+
+  // Phase 3: read all missing pages as one batch, in page id order.
+  if (!read_frame_ids.empty()) {
+    std::sort(read_frame_ids.begin(), read_frame_ids.end(),
+              [this](auto a, auto b) { return pages_[a.second].GetPageId() < pages_[b.second].GetPageId(); });
+    std::vector<DiskRequest> reads;
+    std::vector<std::future<bool>> read_futures;
+    for (auto [shard, frame_id] : read_frame_ids) {
+      auto &page = pages_[frame_id];
+      auto promise = disk_scheduler_->CreatePromise();
+      read_futures.push_back(promise.get_future());
+      reads.push_back({/*is_write=*/false, page.GetData(), page.GetPageId(), std::move(promise)});
+    }
+    disk_scheduler_->Schedule(std::move(reads));
+    for (size_t j = 0; j < read_futures.size(); ++j) {
+      bool read = WaitForIo(read_futures[j]);
+      auto [shard, frame_id] = read_frame_ids[j];
+      std::scoped_lock latch(shard->latch_);
+      if (read) {
+        pages_[frame_id].io_in_progress_ = false;
+        pages_[frame_id].EndWrite();
+        shard->io_cv_.notify_all();
+      } else {
+        AbandonRead(*shard, frame_id, INVALID_PAGE_ID);
+      }
+    }
+  }
+
+  // Resident pages may still have been on their way in when we pinned them. Drop the pins on the pages whose reads
+  // failed, ours or someone else's.
+  for (size_t shard_index = 0; shard_index < shards_.size(); ++shard_index) {
+    auto &shard = *shards_[shard_index];
+    std::unique_lock lock(shard.latch_);
+    shard.io_cv_.wait(lock, [&] {
+      return std::none_of(shard_indexes[shard_index].begin(), shard_indexes[shard_index].end(),
+                          [&](size_t i) { return pages[i] != nullptr && pages[i]->io_in_progress_; });
+    });
+    for (auto i : shard_indexes[shard_index]) {
+      if (pages[i] != nullptr && pages[i]->GetPageId() != page_ids[i]) {
+        UnpinFrame(shard, static_cast<frame_id_t>(pages[i] - pages_));
+        pages[i] = nullptr;
+      }
+    }
+  }
+
+  for (auto i : fallback_indexes) {
+    pages[i] = FetchPage(page_ids[i], access_type);
+  }
+  return pages;
+}
+
+auto BufferPoolManager::FetchPagesRead(const std::vector<page_id_t> &page_ids, AccessType access_type)
+    -> std::vector<ReadPageGuard> {
+  auto pages = FetchPages(page_ids, access_type);
+
+  std::vector<size_t> order(page_ids.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return page_ids[a] < page_ids[b]; });
+  std::vector<ReadPageGuard> guards(page_ids.size());
+  for (size_t begin = 0, end; begin < order.size(); begin = end) {
+    // Every occurrence of a page holds a pin of its own, but the page is latched only once.
+    std::vector<size_t> indexes;
+    for (end = begin; end < order.size() && page_ids[order[end]] == page_ids[order[begin]]; ++end) {
+      if (pages[order[end]] != nullptr) {
+        indexes.push_back(order[end]);
+      }
+    }
+    if (indexes.empty()) {
+      continue;
+    }
+    Page *page = pages[indexes[0]];
+    page->RLatch();
+    if (indexes.size() == 1) {
+      guards[indexes[0]] = ReadPageGuard{this, page};
+      continue;
+    }
+    std::shared_ptr<void> shared_latch(page, [](void *latched) { static_cast<Page *>(latched)->RUnlatch(); });
+    for (auto i : indexes) {
+      guards[i] = ReadPageGuard{this, page, shared_latch};
+    }
+  }
+  return guards;
+}
+
+auto BufferPoolManager::GetStats() -> BufferPoolStats {
+  BufferPoolStats stats;
+  stats.fetches_ = fetch_cnt_.Get();
+  stats.hits_ = hit_cnt_.Get();
+  stats.misses_ = miss_cnt_.Get();
+  stats.evictions_ = eviction_cnt_.Get();
+  stats.write_backs_ = write_back_cnt_.Get();
+  stats.pin_waits_ = pin_wait_cnt_.Get();
+  return stats;
+}
+
+void BufferPoolManager::ResetStats() {
+  for (auto *counter : {&fetch_cnt_, &hit_cnt_, &miss_cnt_, &eviction_cnt_, &write_back_cnt_, &pin_wait_cnt_}) {
+    counter->Reset();
+  }
+  disk_scheduler_->GetReadLatency().Reset();
+  disk_scheduler_->GetWriteLatency().Reset();
+}
+
+auto BufferPoolManager::FetchPageOptimistic(page_id_t page_id) -> OptimisticReadGuard {
+  // The buffer pool only changes the page a frame holds while the frame's version is odd, so a hinted frame that
+  // holds the page with the same even version before and after its page id was read is a hit.
+  auto &hint = frame_hints_[page_id % pool_size_];
+  {
+    auto &page = pages_[hint.load(std::memory_order_relaxed)];
+    OptimisticReadGuard guard{&page, page_id, page.GetVersion()};
+    if (page.GetPageId() == page_id && guard.Validate()) {
+      fetch_cnt_.Add();
+      hit_cnt_.Add();
+      return guard;
+    }
+  }
+
+  auto &shard = GetShard(page_id);
+  {
+    std::scoped_lock latch(shard.latch_);
+    auto it = shard.page_table_.find(page_id);
+    if (it != shard.page_table_.end()) {
+      fetch_cnt_.Add();
+      hit_cnt_.Add();
+      hint.store(it->second, std::memory_order_relaxed);
+      auto &page = pages_[it->second];
+      return OptimisticReadGuard{&page, page_id, page.GetVersion()};
+    }
+  }
+  // Bring the page in with a regular fetch; the pin only has to last until we have seen its version.
+  Page *page = FetchPage(page_id);
+  if (page == nullptr) {
+    return OptimisticReadGuard{};
+  }
+  hint.store(static_cast<frame_id_t>(page - pages_), std::memory_order_relaxed);
+  OptimisticReadGuard guard{page, page_id, page->GetVersion()};
+  UnpinPage(page_id, false);
+  return guard;
+}
+
 auto BufferPoolManager::NewPageGuarded(page_id_t *page_id) -> BasicPageGuard {
   return BasicPageGuard{this, NewPage(page_id)};
 }
 
+auto BufferPoolManager::NewPageInExtentGuarded(Extent *extent, page_id_t *page_id) -> BasicPageGuard {
+  return BasicPageGuard{this, NewPageInExtent(extent, page_id)};
+}
+
 }  // namespace bustub
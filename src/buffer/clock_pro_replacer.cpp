@@ -0,0 +1,226 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// clock_pro_replacer.cpp
+//
+// Identification: src/buffer/clock_pro_replacer.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/clock_pro_replacer.h"
+
+#include <algorithm>
+
+#include "common/exception.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+ClockProReplacer::ClockProReplacer(size_t num_frames) : nodes_(num_frames) {}
+
+void ClockProReplacer::Unlink(frame_id_t frame_id) {
+  auto &node = nodes_[frame_id];
+  if (node.next_ == frame_id) {
+    hand_cold_ = -1;
+    hand_hot_ = -1;
+  } else {
+    nodes_[node.prev_].next_ = node.next_;
+    nodes_[node.next_].prev_ = node.prev_;
+    if (hand_cold_ == frame_id) {
+      hand_cold_ = node.next_;
+    }
+    if (hand_hot_ == frame_id) {
+      hand_hot_ = node.next_;
+    }
+  }
+  if (node.is_evictable_) {
+    evictable_size_--;
+  }
+  if (node.hot_) {
+    num_hot_--;
+  }
+  num_present_--;
+  node = ClockProNode{};
+}
+
+void ClockProReplacer::RunHandHot() {
+  if (num_hot_ == 0) {
+    return;
+  }
+  // Terminates within two rounds: the first one clears the reference bits of all hot frames.
+  while (true) {
+    auto &node = nodes_[hand_hot_];
+    hand_hot_ = node.next_;
+    if (!node.hot_) {
+      node.test_ = false;
+      continue;
+    }
+    if (node.ref_) {
+      node.ref_ = false;
+      continue;
+    }
+    node.hot_ = false;
+    num_hot_--;
+    return;
+  }
+}
+
+void ClockProReplacer::BalanceHot() {
+  while (num_hot_ > 0 && num_hot_ + cold_target_ > capacity_) {
+    RunHandHot();
+  }
+}
+
+void ClockProReplacer::AddTestPage(page_id_t page_id) {
+  test_pages_.push_back(page_id);
+  test_page_index_[page_id] = std::prev(test_pages_.end());
+  while (test_pages_.size() > capacity_) {
+    // The test period of the oldest non-resident page ran out without a reuse: cold pages need less room.
+    test_page_index_.erase(test_pages_.front());
+    test_pages_.pop_front();
+    cold_target_ = std::max<size_t>(1, cold_target_ - 1);
+  }
+}
+
+auto ClockProReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock latch(latch_);
+  if (evictable_size_ == 0) {
+    return false;
+  }
+  size_t steps = 0;
+  while (true) {
+    if (++steps > 2 * num_present_) {
+      // Every evictable frame is hot: turn one of them cold.
+      RunHandHot();
+      steps = 0;
+    }
+    frame_id_t candidate = hand_cold_;
+    auto &node = nodes_[candidate];
+    hand_cold_ = node.next_;
+    if (node.hot_ || !node.is_evictable_) {
+      continue;
+    }
+    if (node.ref_) {
+      node.ref_ = false;
+      if (node.test_) {
+        // Reused within its test period: the page's reuse distance is as short as that of the hot pages.
+        node.test_ = false;
+        node.hot_ = true;
+        num_hot_++;
+        BalanceHot();
+      } else {
+        node.test_ = true;
+      }
+      continue;
+    }
+    bool in_test = node.test_;
+    page_id_t page_id = node.page_id_;
+    Unlink(candidate);
+    if (in_test && page_id != INVALID_PAGE_ID) {
+      AddTestPage(page_id);
+    }
+    *frame_id = candidate;
+    return true;
+  }
+}
+
+void ClockProReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type, page_id_t page_id) {
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= nodes_.size()) {
+    throw bustub::Exception(fmt::format("RecordAccess frame id: {} >= replacer size {}", frame_id, nodes_.size()));
+  }
+  std::scoped_lock latch(latch_);
+  auto &node = nodes_[frame_id];
+  if (node.is_present_) {
+    if (access_type != AccessType::Scan) {
+      node.ref_ = true;
+    }
+    return;
+  }
+
+  // A miss: put the frame right behind the cold hand, the last place the current sweep reaches.
+  node.is_present_ = true;
+  node.page_id_ = page_id;
+  num_present_++;
+  capacity_ = std::max(capacity_, num_present_);
+  if (hand_cold_ == -1) {
+    node.prev_ = frame_id;
+    node.next_ = frame_id;
+    hand_cold_ = frame_id;
+    hand_hot_ = frame_id;
+  } else {
+    node.next_ = hand_cold_;
+    node.prev_ = nodes_[hand_cold_].prev_;
+    nodes_[node.prev_].next_ = frame_id;
+    nodes_[hand_cold_].prev_ = frame_id;
+  }
+
+  auto test_page = page_id == INVALID_PAGE_ID ? test_page_index_.end() : test_page_index_.find(page_id);
+  if (test_page != test_page_index_.end()) {
+    test_pages_.erase(test_page->second);
+    test_page_index_.erase(test_page);
+    if (access_type != AccessType::Scan) {
+      // Back within its test period: cold pages need more room, and this one is hot.
+      cold_target_ = std::min(cold_target_ + 1, std::max<size_t>(1, capacity_ - 1));
+      node.hot_ = true;
+      num_hot_++;
+      BalanceHot();
+      return;
+    }
+  }
+  node.test_ = access_type != AccessType::Scan;
+}
+
+void ClockProReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock latch(latch_);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= nodes_.size() || !nodes_[frame_id].is_present_) {
+    throw bustub::Exception(fmt::format("SetEvictable frame id: {} is invalid", frame_id));
+  }
+  auto &node = nodes_[frame_id];
+  if (node.is_evictable_ && !set_evictable) {
+    evictable_size_--;
+  } else if (!node.is_evictable_ && set_evictable) {
+    evictable_size_++;
+  }
+  node.is_evictable_ = set_evictable;
+}
+
+void ClockProReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock latch(latch_);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= nodes_.size() || !nodes_[frame_id].is_present_) {
+    return;
+  }
+  if (!nodes_[frame_id].is_evictable_) {
+    throw bustub::Exception(fmt::format("Remove frame id: {} is not evictable", frame_id));
+  }
+  Unlink(frame_id);
+}
+
+auto ClockProReplacer::Size() -> size_t {
+  std::scoped_lock latch(latch_);
+  return evictable_size_;
+}
+
+auto ClockProReplacer::GetEvictionOrder() -> std::vector<frame_id_t> {
+  std::scoped_lock latch(latch_);
+  // The cold hand takes the unreferenced cold frames as it reaches them, then the referenced ones; hot frames only
+  // leave after the hot hand has turned them cold.
+  std::vector<frame_id_t> cold_unreferenced;
+  std::vector<frame_id_t> cold_referenced;
+  std::vector<frame_id_t> hot;
+  if (hand_cold_ != -1) {
+    frame_id_t frame_id = hand_cold_;
+    do {
+      const auto &node = nodes_[frame_id];
+      (node.hot_ ? hot : node.ref_ ? cold_referenced : cold_unreferenced).push_back(frame_id);
+      frame_id = node.next_;
+    } while (frame_id != hand_cold_);
+  }
+  cold_unreferenced.insert(cold_unreferenced.end(), cold_referenced.begin(), cold_referenced.end());
+  cold_unreferenced.insert(cold_unreferenced.end(), hot.begin(), hot.end());
+  return cold_unreferenced;
+}
+
+}  // namespace bustub
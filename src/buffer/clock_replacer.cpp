@@ -12,18 +12,124 @@
 
 #include "buffer/clock_replacer.h"
 
+#include "common/exception.h"
+#include "fmt/format.h"
+
 namespace bustub {
 
-ClockReplacer::ClockReplacer(size_t num_pages) {}
+ClockReplacer::ClockReplacer(size_t num_pages) : nodes_(num_pages) {}
 
 ClockReplacer::~ClockReplacer() = default;
 
-auto ClockReplacer::Victim(frame_id_t *frame_id) -> bool { return false; }
+void ClockReplacer::Unlink(frame_id_t frame_id) {
+  auto &node = nodes_[frame_id];
+  if (node.next_ == frame_id) {
+    hand_ = -1;
+  } else {
+    nodes_[node.prev_].next_ = node.next_;
+    nodes_[node.next_].prev_ = node.prev_;
+    if (hand_ == frame_id) {
+      hand_ = node.next_;
+    }
+  }
+  if (node.is_evictable_) {
+    evictable_size_--;
+  }
+  node = ClockNode{};
+}
+
+auto ClockReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock latch(latch_);
+  if (evictable_size_ == 0) {
+    return false;
+  }
+  // Terminates within two rounds: the first one clears the reference bits of all evictable frames.
+  while (true) {
+    frame_id_t candidate = hand_;
+    auto &node = nodes_[candidate];
+    hand_ = node.next_;
+    if (!node.is_evictable_) {
+      continue;
+    }
+    if (node.ref_) {
+      node.ref_ = false;
+      continue;
+    }
+    Unlink(candidate);
+    *frame_id = candidate;
+    return true;
+  }
+}
+
+void ClockReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type, [[maybe_unused]] page_id_t page_id) {
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= nodes_.size()) {
+    throw bustub::Exception(fmt::format("RecordAccess frame id: {} >= replacer size {}", frame_id, nodes_.size()));
+  }
+  std::scoped_lock latch(latch_);
+  auto &node = nodes_[frame_id];
+  if (!node.is_present_) {
+    // New frames go right behind the hand, i.e. they are the last ones the current sweep reaches.
+    node.is_present_ = true;
+    if (hand_ == -1) {
+      node.prev_ = frame_id;
+      node.next_ = frame_id;
+      hand_ = frame_id;
+    } else {
+      node.next_ = hand_;
+      node.prev_ = nodes_[hand_].prev_;
+      nodes_[node.prev_].next_ = frame_id;
+      nodes_[hand_].prev_ = frame_id;
+    }
+  }
+  if (access_type != AccessType::Scan) {
+    node.ref_ = true;
+  }
+}
+
+void ClockReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock latch(latch_);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= nodes_.size() || !nodes_[frame_id].is_present_) {
+    throw bustub::Exception(fmt::format("SetEvictable frame id: {} is invalid", frame_id));
+  }
+  auto &node = nodes_[frame_id];
+  if (node.is_evictable_ && !set_evictable) {
+    evictable_size_--;
+  } else if (!node.is_evictable_ && set_evictable) {
+    evictable_size_++;
+  }
+  node.is_evictable_ = set_evictable;
+}
 
-void ClockReplacer::Pin(frame_id_t frame_id) {}
+void ClockReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock latch(latch_);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= nodes_.size() || !nodes_[frame_id].is_present_) {
+    return;
+  }
+  if (!nodes_[frame_id].is_evictable_) {
+    throw bustub::Exception(fmt::format("Remove frame id: {} is not evictable", frame_id));
+  }
+  Unlink(frame_id);
+}
 
-void ClockReplacer::Unpin(frame_id_t frame_id) {}
+auto ClockReplacer::Size() -> size_t {
+  std::scoped_lock latch(latch_);
+  return evictable_size_;
+}
 
-auto ClockReplacer::Size() -> size_t { return 0; }
+auto ClockReplacer::GetEvictionOrder() -> std::vector<frame_id_t> {
+  std::scoped_lock latch(latch_);
+  // The hand takes the unreferenced frames in the order it reaches them, and the referenced ones on its next round.
+  std::vector<frame_id_t> unreferenced;
+  std::vector<frame_id_t> referenced;
+  if (hand_ != -1) {
+    frame_id_t frame_id = hand_;
+    do {
+      (nodes_[frame_id].ref_ ? referenced : unreferenced).push_back(frame_id);
+      frame_id = nodes_[frame_id].next_;
+    } while (frame_id != hand_);
+  }
+  unreferenced.insert(unreferenced.end(), referenced.begin(), referenced.end());
+  return unreferenced;
+}
 
 }  // namespace bustub
@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.cpp
+//
+// Identification: src/buffer/frame_arena.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/frame_arena.h"
+
+#include <sys/mman.h>
+
+#ifdef BUSTUB_ASAN
+#include <sanitizer/asan_interface.h>
+#endif
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+/** The usual size of a huge page on x86-64 and aarch64. */
+static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+FrameArena::FrameArena(size_t num_frames, size_t frame_size, bool use_huge_pages)
+    : frame_stride_(frame_size + FRAME_RED_ZONE_SIZE), size_(num_frames * frame_stride_) {
+  void *data = MAP_FAILED;
+  if (use_huge_pages) {
+    size_t huge_size = (size_ + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    data = mmap(nullptr, huge_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (data != MAP_FAILED) {
+      size_ = huge_size;
+      huge_tlb_ = true;
+    }
+  }
+  if (data == MAP_FAILED) {
+    data = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, fmt::format("cannot map a frame arena of {} bytes", size_));
+    }
+    if (use_huge_pages && size_ >= HUGE_PAGE_SIZE && madvise(data, size_, MADV_HUGEPAGE) != 0) {
+      LOG_DEBUG("transparent huge pages are not available for the frame arena");
+    }
+  }
+  data_ = static_cast<char *>(data);
+#ifdef BUSTUB_ASAN
+  for (size_t i = 0; i < num_frames; i++) {
+    ASAN_POISON_MEMORY_REGION(data_ + i * frame_stride_ + frame_size, FRAME_RED_ZONE_SIZE);
+  }
+#endif
+}
+
+FrameArena::~FrameArena() {
+#ifdef BUSTUB_ASAN
+  ASAN_UNPOISON_MEMORY_REGION(data_, size_);
+#endif
+  munmap(data_, size_);
+}
+
+}  // namespace bustub
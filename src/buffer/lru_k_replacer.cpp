@@ -11,135 +11,179 @@
 //===----------------------------------------------------------------------===//
 
 #include "buffer/lru_k_replacer.h"
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
-#include <iostream>
-#include <iterator>
-#include <list>
+#include <utility>
 #include "common/config.h"
 #include "common/exception.h"
-#include "fmt/ranges.h"
+#include "fmt/format.h"
 namespace bustub {
 
-auto InsertOrder(std::list<LRUKNode> &over_k_nodes, LRUKNode &node) -> std::list<LRUKNode>::iterator {
-  size_t this_min_timestap = node.min_history_size_;
-  for (auto it = over_k_nodes.begin(); it != over_k_nodes.end(); ++it) {
-    if (this_min_timestap < it->min_history_size_) {
-      return over_k_nodes.insert(it, node);
+LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k)
+    : node_store_(num_frames), history_(num_frames * k), replacer_size_(num_frames), k_(k) {
+  heap_.reserve(num_frames);
+}
+
+auto LRUKReplacer::OldestTimestamp(frame_id_t frame_id) const -> size_t {
+  const auto &node = node_store_[frame_id];
+  const size_t *ring = &history_[frame_id * k_];
+  return node.history_size_ < k_ ? ring[0] : ring[node.history_next_];
+}
+
+auto LRUKReplacer::EvictsBefore(frame_id_t a, frame_id_t b) const -> bool {
+  auto rank = [this](frame_id_t frame_id) {
+    const auto &node = node_store_[frame_id];
+    if (node.in_probation_) {
+      return 0;
     }
+    return node.history_size_ < k_ ? 1 : 2;
+  };
+  int rank_a = rank(a);
+  int rank_b = rank(b);
+  if (rank_a != rank_b) {
+    return rank_a < rank_b;
   }
-  return over_k_nodes.insert(over_k_nodes.end(), node);
+  // +inf frames are ordered by their earliest access (classical LRU); the others by their k-th most recent access,
+  // which is the one that sits in the same place of a full ring.
+  return OldestTimestamp(a) < OldestTimestamp(b);
 }
 
-LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {}
+void LRUKReplacer::HeapSwap(size_t a, size_t b) {
+  std::swap(heap_[a], heap_[b]);
+  node_store_[heap_[a]].heap_index_ = a;
+  node_store_[heap_[b]].heap_index_ = b;
+}
 
-auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
-  latch_.lock();
-  for (auto it = less_k_nodes_.begin(); it != less_k_nodes_.end(); it++) {
-    if (it->is_evictable_) {
-      *frame_id = it->fid_;
-
-      curr_size_--;
-      evictable_size_--;
-      hash_cache_.erase(it->fid_);
-      less_k_nodes_.erase(it);
-      latch_.unlock();
-      return true;
+void LRUKReplacer::HeapSiftUp(size_t index) {
+  while (index > 0) {
+    size_t parent = (index - 1) / 2;
+    if (!EvictsBefore(heap_[index], heap_[parent])) {
+      return;
     }
+    HeapSwap(index, parent);
+    index = parent;
   }
-  for (auto it = over_k_nodes_.begin(); it != over_k_nodes_.end(); it++) {
-    if (it->is_evictable_) {
-      *frame_id = it->fid_;
-      curr_size_--;
-      evictable_size_--;
-      hash_cache_.erase(it->fid_);
-      over_k_nodes_.erase(it);
-      latch_.unlock();
-      return true;
+}
+
+void LRUKReplacer::HeapSiftDown(size_t index) {
+  while (true) {
+    size_t smallest = index;
+    for (size_t child = 2 * index + 1; child <= 2 * index + 2 && child < heap_.size(); ++child) {
+      if (EvictsBefore(heap_[child], heap_[smallest])) {
+        smallest = child;
+      }
+    }
+    if (smallest == index) {
+      return;
     }
+    HeapSwap(index, smallest);
+    index = smallest;
+  }
+}
+
+void LRUKReplacer::HeapPush(frame_id_t frame_id) {
+  node_store_[frame_id].heap_index_ = heap_.size();
+  heap_.push_back(frame_id);
+  HeapSiftUp(heap_.size() - 1);
+}
+
+void LRUKReplacer::HeapErase(frame_id_t frame_id) {
+  size_t index = node_store_[frame_id].heap_index_;
+  HeapSwap(index, heap_.size() - 1);
+  heap_.pop_back();
+  if (index < heap_.size()) {
+    // The former last entry now sits at index and may belong either above or below it.
+    HeapSiftUp(index);
+    HeapSiftDown(index);
   }
-  latch_.unlock();
-  return false;
 }
 
-void LRUKReplacer::RecordAccess(frame_id_t frame_id, [[maybe_unused]] AccessType access_type) {
-  if (frame_id > static_cast<int32_t>(replacer_size_)) {
-    throw bustub::Exception(fmt::format("RecordAccess frame id: {}  > replacer_size_{}", frame_id, replacer_size_));
+void LRUKReplacer::ResetNode(frame_id_t frame_id) { node_store_[frame_id] = LRUKNode{}; }
+
+auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock latch(latch_);
+  if (heap_.empty()) {
+    return false;
   }
-  latch_.lock();
+  *frame_id = heap_.front();
+  HeapErase(*frame_id);
+  ResetNode(*frame_id);
+  return true;
+}
+
+void LRUKReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type, [[maybe_unused]] page_id_t page_id) {
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= replacer_size_) {
+    throw bustub::Exception(fmt::format("RecordAccess frame id: {} >= replacer_size_ {}", frame_id, replacer_size_));
+  }
+  std::scoped_lock latch(latch_);
   current_timestamp_++;
-  if (hash_cache_.find(frame_id) == hash_cache_.end()) {
-    LRUKNode node;
-    node.fid_ = frame_id;
-    node.history_.push_front(current_timestamp_);
-    auto it = less_k_nodes_.insert(less_k_nodes_.end(), node);
-    hash_cache_[frame_id] = it;
-    curr_size_++;
-    latch_.unlock();
+  auto &node = node_store_[frame_id];
+  if (!node.is_present_) {
+    node.is_present_ = true;
+    node.in_probation_ = access_type == AccessType::Scan;
+  } else if (access_type == AccessType::Scan) {
+    // Scans must not make a frame look hot, nor refresh a probationary frame's position in the queue.
     return;
+  } else if (node.in_probation_) {
+    // First real use of a page a scan brought in: it starts its LRU-k history now.
+    node.in_probation_ = false;
+    node.history_size_ = 0;
+    node.history_next_ = 0;
   }
-  auto thisnode = hash_cache_[frame_id];
-
-  if (thisnode->over_k_) {
-    thisnode->history_.push_front(current_timestamp_);
-    thisnode->history_.pop_back();
-    thisnode->min_history_size_ = thisnode->history_.back();
-    auto node = *thisnode;
-    over_k_nodes_.erase(thisnode);
-    auto new_it = InsertOrder(over_k_nodes_, node);
-    hash_cache_[frame_id] = new_it;
-  } else {
-    if (thisnode->history_.size() == k_ - 1) {
-      thisnode->history_.push_front(current_timestamp_);
-      thisnode->over_k_ = true;
-      thisnode->min_history_size_ = thisnode->history_.back();
-      LRUKNode node = *thisnode;
-      less_k_nodes_.erase(thisnode);
-      auto new_it = InsertOrder(over_k_nodes_, node);
-      hash_cache_[frame_id] = new_it;
-
-    } else {
-      thisnode->history_.push_front(current_timestamp_);
-    }
+
+  history_[frame_id * k_ + node.history_next_] = current_timestamp_;
+  node.history_next_ = (node.history_next_ + 1) % k_;
+  if (node.history_size_ < k_) {
+    node.history_size_++;
+  }
+  // An access can only move a frame further away from eviction.
+  if (node.is_evictable_) {
+    HeapSiftDown(node.heap_index_);
   }
-  latch_.unlock();
 }
 
 void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
-  latch_.lock();
-  if (hash_cache_.find(frame_id) == hash_cache_.end()) {
+  std::scoped_lock latch(latch_);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= replacer_size_ || !node_store_[frame_id].is_present_) {
     throw bustub::Exception(fmt::format("SetEvictable frame id: {} is invalid", frame_id));
   }
-  auto thisnode = hash_cache_[frame_id];
-  if (thisnode->is_evictable_ && !set_evictable) {
-    evictable_size_--;
-  } else if (!thisnode->is_evictable_ && set_evictable) {
-    evictable_size_++;
+  auto &node = node_store_[frame_id];
+  if (node.is_evictable_ && !set_evictable) {
+    HeapErase(frame_id);
+  } else if (!node.is_evictable_ && set_evictable) {
+    HeapPush(frame_id);
   }
-  thisnode->is_evictable_ = set_evictable;
-  latch_.unlock();
+  node.is_evictable_ = set_evictable;
 }
 
 void LRUKReplacer::Remove(frame_id_t frame_id) {
-  if (hash_cache_.find(frame_id) == hash_cache_.end()) {
+  std::scoped_lock latch(latch_);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= replacer_size_ || !node_store_[frame_id].is_present_) {
     return;
   }
-  latch_.lock();
-  auto thisnode = hash_cache_[frame_id];
-  if (!thisnode->is_evictable_) {
+  if (!node_store_[frame_id].is_evictable_) {
     throw bustub::Exception(fmt::format("Remove frame id: {} is not evictable", frame_id));
   }
-  if (thisnode->over_k_) {
-    over_k_nodes_.erase(thisnode);
-  } else {
-    less_k_nodes_.erase(thisnode);
-  }
-  hash_cache_.erase(frame_id);
-  evictable_size_--;
-  curr_size_--;
-  latch_.unlock();
+  HeapErase(frame_id);
+  ResetNode(frame_id);
+}
+
+auto LRUKReplacer::Size() -> size_t {
+  std::scoped_lock latch(latch_);
+  return heap_.size();
 }
 
-auto LRUKReplacer::Size() -> size_t { return evictable_size_; }
+auto LRUKReplacer::GetEvictionOrder() -> std::vector<frame_id_t> {
+  std::scoped_lock latch(latch_);
+  std::vector<frame_id_t> frame_ids;
+  for (size_t i = 0; i < replacer_size_; ++i) {
+    if (node_store_[i].is_present_) {
+      frame_ids.push_back(static_cast<frame_id_t>(i));
+    }
+  }
+  std::sort(frame_ids.begin(), frame_ids.end(), [this](frame_id_t a, frame_id_t b) { return EvictsBefore(a, b); });
+  return frame_ids;
+}
 
 }  // namespace bustub
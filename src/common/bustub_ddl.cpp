@@ -15,6 +15,7 @@
 #include "binder/statement/select_statement.h"
 #include "binder/statement/set_show_statement.h"
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/replacer.h"
 #include "catalog/schema.h"
 #include "catalog/table_generator.h"
 #include "common/bustub_instance.h"
@@ -36,6 +37,7 @@
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree_index.h"
 #include "type/value_factory.h"
 
 namespace bustub {
@@ -56,25 +58,28 @@ void BustubInstance::HandleIndexStatement(Transaction *txn, const IndexStatement
   for (const auto &col : stmt.cols_) {
     auto idx = stmt.table_->schema_.GetColIdx(col->col_name_.back());
     col_ids.push_back(idx);
-    if (stmt.table_->schema_.GetColumn(idx).GetType() != TypeId::INTEGER) {
-      throw NotImplementedException("only support creating index on integer column");
-    }
   }
   auto key_schema = Schema::CopySchema(&stmt.table_->schema_, col_ids);
 
-  // TODO(spring2023): If you want to support composite index key for leaderboard optimization, remove this assertion
-  // and create index with different key type that can hold multiple keys based on number of index columns.
-  //
   // You can also create clustered index that directly stores value inside the index by modifying the value type.
 
-  if (col_ids.empty() || col_ids.size() > 2) {
-    throw NotImplementedException("only support creating index with exactly one or two columns");
+  if (col_ids.empty()) {
+    throw NotImplementedException("cannot create index without columns");
   }
 
+  // Keys that fit the fixed-size integer key are kept in it; anything wider, and any varchar, is normalized into a
+  // variable-length key instead.
   std::unique_lock<std::shared_mutex> l(catalog_lock_);
-  auto info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
-      txn, stmt.index_name_, stmt.table_->table_, stmt.table_->schema_, key_schema, col_ids, TWO_INTEGER_SIZE,
-      IntegerHashFunctionType{});
+  IndexInfo *info;
+  if (key_schema.IsInlined() && key_schema.GetLength() <= TWO_INTEGER_SIZE) {
+    info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
+        txn, stmt.index_name_, stmt.table_->table_, stmt.table_->schema_, key_schema, col_ids, TWO_INTEGER_SIZE,
+        IntegerHashFunctionType{});
+  } else {
+    info = catalog_->CreateIndex<NormalizedKey, RID, NormalizedComparator>(
+        txn, stmt.index_name_, stmt.table_->table_, stmt.table_->schema_, key_schema, col_ids, key_schema.GetLength(),
+        HashFunction<NormalizedKey>{});
+  }
   l.unlock();
 
   if (info == nullptr) {
@@ -127,12 +132,25 @@ void BustubInstance::HandleExplainStatement(Transaction *txn, const ExplainState
 
 void BustubInstance::HandleVariableShowStatement(Transaction *txn, const VariableShowStatement &stmt,
                                                  ResultWriter &writer) {
+  if (stmt.variable_ == "buffer_pool_stats") {
+    CmdDisplayBufferPoolStats(writer);
+    return;
+  }
   auto content = GetSessionVariable(stmt.variable_);
   WriteOneCell(fmt::format("{}={}", stmt.variable_, content), writer);
 }
 
 void BustubInstance::HandleVariableSetStatement(Transaction *txn, const VariableSetStatement &stmt,
                                                 ResultWriter &writer) {
+  if (stmt.variable_ == "replacer") {
+    ReplacerPolicy policy;
+    if (!ReplacerPolicyFromString(stmt.value_, &policy)) {
+      throw bustub::Exception(fmt::format("unknown replacer policy: {}", stmt.value_));
+    }
+    if (buffer_pool_manager_ != nullptr) {
+      buffer_pool_manager_->SetReplacerPolicy(policy);
+    }
+  }
   session_variables_[stmt.variable_] = stmt.value_;
 }
 
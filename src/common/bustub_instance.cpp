@@ -2,6 +2,8 @@
 #include <shared_mutex>
 #include <string>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 #include "binder/binder.h"
 #include "binder/bound_expression.h"
@@ -42,19 +44,22 @@ auto BustubInstance::MakeExecutorContext(Transaction *txn, bool is_modify) -> st
   return std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_, is_modify);
 }
 
-BustubInstance::BustubInstance(const std::string &db_file_name) {
+BustubInstance::BustubInstance(const std::string &db_file_name, size_t pool_size, size_t page_size) {
   enable_logging = false;
 
   // Storage related.
-  disk_manager_ = new DiskManager(db_file_name);
+  disk_manager_ = new DiskManager(db_file_name, page_size);
 
   // Log related.
   log_manager_ = new LogManager(disk_manager_);
 
-  // We need more frames for GenerateTestTable to work. Therefore, we use 128 instead of the default
-  // buffer pool size specified in `config.h`.
   try {
-    buffer_pool_manager_ = new BufferPoolManager(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    buffer_pool_manager_ = new BufferPoolManager(pool_size, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    buffer_pool_manager_->LoadSpaceMap();
+    buffer_pool_dump_file_name_ = db_file_name.substr(0, db_file_name.rfind('.')) + ".bp_dump";
+    buffer_pool_manager_->WarmUp(buffer_pool_dump_file_name_);
+    buffer_pool_manager_->SetReadAhead(SCAN_READ_AHEAD_PAGES);
+    buffer_pool_manager_->StartBackgroundWriter();
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
@@ -82,19 +87,18 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
 }
 
-BustubInstance::BustubInstance() {
+BustubInstance::BustubInstance(size_t pool_size, size_t page_size) {
   enable_logging = false;
 
   // Storage related.
-  disk_manager_ = new DiskManagerUnlimitedMemory();
+  disk_manager_ = new DiskManagerUnlimitedMemory(page_size);
 
   // Log related.
   log_manager_ = new LogManager(disk_manager_);
 
-  // We need more frames for GenerateTestTable to work. Therefore, we use 128 instead of the default
-  // buffer pool size specified in `config.h`.
   try {
-    buffer_pool_manager_ = new BufferPoolManager(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    buffer_pool_manager_ = new BufferPoolManager(pool_size, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    buffer_pool_manager_->StartBackgroundWriter();
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
@@ -163,6 +167,38 @@ void BustubInstance::CmdDisplayIndices(ResultWriter &writer) {
   writer.EndTable();
 }
 
+void BustubInstance::CmdDisplayBufferPoolStats(ResultWriter &writer) {
+  if (buffer_pool_manager_ == nullptr) {
+    throw Exception("the buffer pool is not available");
+  }
+  auto stats = buffer_pool_manager_->GetStats();
+  std::vector<std::pair<std::string, std::string>> rows{
+      {"pool_size", fmt::format("{}", buffer_pool_manager_->GetPoolSize())},
+      {"page_size", fmt::format("{}", buffer_pool_manager_->GetPageSize())},
+      {"fetches", fmt::format("{}", stats.fetches_)},
+      {"hits", fmt::format("{}", stats.hits_)},
+      {"misses", fmt::format("{}", stats.misses_)},
+      {"hit_ratio", fmt::format("{:.4f}", stats.HitRatio())},
+      {"evictions", fmt::format("{}", stats.evictions_)},
+      {"write_backs", fmt::format("{}", stats.write_backs_)},
+      {"pin_waits", fmt::format("{}", stats.pin_waits_)},
+      {"read_latency", buffer_pool_manager_->GetReadLatency().ToString()},
+      {"write_latency", buffer_pool_manager_->GetWriteLatency().ToString()},
+  };
+  writer.BeginTable(false);
+  writer.BeginHeader();
+  writer.WriteHeaderCell("name");
+  writer.WriteHeaderCell("value");
+  writer.EndHeader();
+  for (const auto &[name, value] : rows) {
+    writer.BeginRow();
+    writer.WriteCell(name);
+    writer.WriteCell(value);
+    writer.EndRow();
+  }
+  writer.EndTable();
+}
+
 void BustubInstance::WriteOneCell(const std::string &cell, ResultWriter &writer) {
   writer.BeginTable(true);
   writer.BeginRow();
@@ -176,6 +212,7 @@ void BustubInstance::CmdDisplayHelp(ResultWriter &writer) {
 
 \dt: show all tables
 \di: show all indices
+\stats: show the buffer pool counters, also available as `SHOW buffer_pool_stats`
 \help: show this message again
 
 BusTub shell currently only supports a small set of Postgres queries. We'll set
@@ -216,6 +253,10 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
       CmdDisplayIndices(writer);
       return true;
     }
+    if (sql == "\\stats") {
+      CmdDisplayBufferPoolStats(writer);
+      return true;
+    }
     if (sql == "\\help") {
       CmdDisplayHelp(writer);
       return true;
@@ -358,6 +399,9 @@ BustubInstance::~BustubInstance() {
   delete catalog_;
   delete checkpoint_manager_;
   delete log_manager_;
+  if (buffer_pool_manager_ != nullptr && !buffer_pool_dump_file_name_.empty()) {
+    buffer_pool_manager_->DumpResidentPages(buffer_pool_dump_file_name_);
+  }
   delete buffer_pool_manager_;
   delete lock_manager_;
   delete txn_manager_;
@@ -0,0 +1,100 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// metrics.cpp
+//
+// Identification: src/common/metrics.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/metrics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "fmt/format.h"
+
+namespace bustub {
+
+auto StripedCounter::StripeIndex() -> size_t {
+  // Hand out stripes round-robin, so that a handful of threads never share one.
+  static std::atomic<size_t> next_stripe{0};
+  thread_local size_t stripe = next_stripe.fetch_add(1, std::memory_order_relaxed) % NUM_STRIPES;
+  return stripe;
+}
+
+auto StripedCounter::Get() const -> uint64_t {
+  uint64_t sum = 0;
+  for (const auto &stripe : stripes_) {
+    sum += stripe.value_.load(std::memory_order_relaxed);
+  }
+  return sum;
+}
+
+void StripedCounter::Reset() {
+  for (auto &stripe : stripes_) {
+    stripe.value_.store(0, std::memory_order_relaxed);
+  }
+}
+
+/** @return the upper end of the given bucket in microseconds */
+static auto BucketBoundMicros(size_t bucket) -> uint64_t { return uint64_t{1} << bucket; }
+
+void LatencyHistogram::Record(std::chrono::nanoseconds latency) {
+  auto ns = static_cast<uint64_t>(std::max<int64_t>(latency.count(), 0));
+  uint64_t us = ns / 1000;
+  size_t bucket = 0;
+  while (us > 0 && bucket + 1 < NUM_BUCKETS) {
+    us >>= 1;
+    bucket++;
+  }
+  buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+  total_ns_.fetch_add(ns, std::memory_order_relaxed);
+}
+
+auto LatencyHistogram::Count() const -> uint64_t {
+  uint64_t count = 0;
+  for (const auto &bucket : buckets_) {
+    count += bucket.load(std::memory_order_relaxed);
+  }
+  return count;
+}
+
+auto LatencyHistogram::MeanMicros() const -> double {
+  auto count = Count();
+  return count == 0 ? 0.0 : static_cast<double>(total_ns_.load(std::memory_order_relaxed)) / 1000.0 / count;
+}
+
+auto LatencyHistogram::PercentileMicros(double percentile) const -> uint64_t {
+  auto count = Count();
+  if (count == 0) {
+    return 0;
+  }
+  auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(count * percentile / 100.0)));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+    seen += buckets_[i].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      return BucketBoundMicros(i);
+    }
+  }
+  // Latencies recorded while we were summing up.
+  return BucketBoundMicros(NUM_BUCKETS - 1);
+}
+
+auto LatencyHistogram::ToString() const -> std::string {
+  return fmt::format("count={} avg={:.1f}us p50<={}us p99<={}us max<={}us", Count(), MeanMicros(),
+                     PercentileMicros(50), PercentileMicros(99), PercentileMicros(100));
+}
+
+void LatencyHistogram::Reset() {
+  for (auto &bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  total_ns_.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace bustub
@@ -0,0 +1,186 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compression_util.cpp
+//
+// Identification: src/common/util/compression_util.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/util/compression_util.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace bustub {
+
+namespace {
+
+constexpr size_t MIN_MATCH = 4;
+/** The block format requires the last match to start at least this many bytes before the end of the input ... */
+constexpr size_t MF_LIMIT = 12;
+/** ... and the last bytes of the input to be literals. */
+constexpr size_t LAST_LITERALS = 5;
+constexpr size_t HASH_LOG = 12;
+constexpr size_t MAX_OFFSET = 65535;
+
+auto Read32(const uint8_t *p) -> uint32_t {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+auto Hash(uint32_t sequence) -> size_t { return (sequence * 2654435761U) >> (32 - HASH_LOG); }
+
+/** Appends to a bounded output buffer, remembering whether anything did not fit. */
+class Writer {
+ public:
+  Writer(uint8_t *dst, size_t capacity) : dst_(dst), capacity_(capacity) {}
+
+  void Put(uint8_t byte) {
+    if (size_ < capacity_) {
+      dst_[size_] = byte;
+    }
+    size_++;
+  }
+
+  void Put(const uint8_t *data, size_t n) {
+    if (size_ + n <= capacity_) {
+      memcpy(dst_ + size_, data, n);
+    }
+    size_ += n;
+  }
+
+  /** Write the part of a length that does not fit into its 4 bits of the token. */
+  void PutLength(size_t length) {
+    for (; length >= 255; length -= 255) {
+      Put(255);
+    }
+    Put(static_cast<uint8_t>(length));
+  }
+
+  auto Size() const -> size_t { return size_ <= capacity_ ? size_ : 0; }
+
+ private:
+  uint8_t *dst_;
+  size_t capacity_;
+  size_t size_{0};
+};
+
+void PutSequence(Writer &writer, const uint8_t *literals, size_t num_literals, size_t offset, size_t match_length) {
+  size_t match_code = match_length - MIN_MATCH;
+  auto token = static_cast<uint8_t>((num_literals < 15 ? num_literals : 15) << 4);
+  if (match_length > 0) {
+    token |= match_code < 15 ? match_code : 15;
+  }
+  writer.Put(token);
+  if (num_literals >= 15) {
+    writer.PutLength(num_literals - 15);
+  }
+  writer.Put(literals, num_literals);
+  if (match_length == 0) {
+    return;
+  }
+  writer.Put(static_cast<uint8_t>(offset & 0xff));
+  writer.Put(static_cast<uint8_t>(offset >> 8));
+  if (match_code >= 15) {
+    writer.PutLength(match_code - 15);
+  }
+}
+
+/** Read the extension of a length whose 4 bits in the token were all set. */
+auto GetLength(const uint8_t *src, size_t src_size, size_t *ip, size_t *length) -> bool {
+  uint8_t byte;
+  do {
+    if (*ip >= src_size) {
+      return false;
+    }
+    byte = src[(*ip)++];
+    *length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+}  // namespace
+
+auto CompressionUtil::Compress(const char *src, size_t src_size, char *dst, size_t dst_capacity) -> size_t {
+  if (src_size > MAX_INPUT_SIZE) {
+    return 0;
+  }
+  const auto *in = reinterpret_cast<const uint8_t *>(src);
+  Writer writer(reinterpret_cast<uint8_t *>(dst), dst_capacity);
+
+  // Positions of recent 4-byte sequences by hash, shifted by one so that 0 means "none".
+  std::array<uint32_t, size_t{1} << HASH_LOG> table{};
+  size_t anchor = 0;
+  size_t ip = 0;
+  while (src_size > MF_LIMIT && ip < src_size - MF_LIMIT) {
+    uint32_t sequence = Read32(in + ip);
+    auto &slot = table[Hash(sequence)];
+    size_t ref = slot;
+    slot = static_cast<uint32_t>(ip + 1);
+    if (ref == 0 || ip - (ref - 1) > MAX_OFFSET || Read32(in + ref - 1) != sequence) {
+      ip++;
+      continue;
+    }
+    ref--;
+    size_t match_length = MIN_MATCH;
+    while (ip + match_length < src_size - LAST_LITERALS && in[ref + match_length] == in[ip + match_length]) {
+      match_length++;
+    }
+    PutSequence(writer, in + anchor, ip - anchor, ip - ref, match_length);
+    ip += match_length;
+    anchor = ip;
+  }
+  PutSequence(writer, in + anchor, src_size - anchor, 0, 0);
+  return writer.Size();
+}
+
+auto CompressionUtil::Decompress(const char *src, size_t src_size, char *dst, size_t dst_size) -> bool {
+  const auto *in = reinterpret_cast<const uint8_t *>(src);
+  auto *out = reinterpret_cast<uint8_t *>(dst);
+  size_t ip = 0;
+  size_t op = 0;
+  while (ip < src_size) {
+    uint8_t token = in[ip++];
+    size_t num_literals = token >> 4;
+    if (num_literals == 15 && !GetLength(in, src_size, &ip, &num_literals)) {
+      return false;
+    }
+    if (num_literals > src_size - ip || num_literals > dst_size - op) {
+      return false;
+    }
+    memcpy(out + op, in + ip, num_literals);
+    ip += num_literals;
+    op += num_literals;
+    if (ip == src_size) {
+      // The last sequence has literals only.
+      break;
+    }
+
+    if (src_size - ip < 2) {
+      return false;
+    }
+    size_t offset = in[ip] | (static_cast<size_t>(in[ip + 1]) << 8);
+    ip += 2;
+    size_t match_length = token & 15;
+    if (match_length == 15 && !GetLength(in, src_size, &ip, &match_length)) {
+      return false;
+    }
+    match_length += MIN_MATCH;
+    if (offset == 0 || offset > op || match_length > dst_size - op) {
+      return false;
+    }
+    // The match may overlap the bytes it produces, so copy byte by byte.
+    for (size_t i = 0; i < match_length; i++, op++) {
+      out[op] = out[op - offset];
+    }
+  }
+  return op == dst_size;
+}
+
+}  // namespace bustub
@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.h
+//
+// Identification: src/include/buffer/arc_replacer.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * ARCReplacer implements the Adaptive Replacement Cache policy (Megiddo and Modha, FAST '03).
+ *
+ * Resident frames are split between T1, holding pages seen once since they entered the pool, and T2, holding pages
+ * seen at least twice. Both are kept in LRU order. The replacer also remembers the pages it recently evicted from T1
+ * and T2 in the ghost lists B1 and B2. When an evicted page comes back, the target size p of T1 is adapted towards
+ * the list the page was found in: a B1 hit means T1 was too small, a B2 hit that T2 was. Eviction takes the LRU frame
+ * of T1 while T1 is larger than p, and of T2 otherwise.
+ *
+ * The cache size c is the largest number of frames the replacer has tracked at once. Ghost hits need the page id of
+ * the accessed frame; scan accesses never move a page into T2 and never adapt p.
+ */
+class ARCReplacer : public Replacer {
+ public:
+  /**
+   * @brief Create a new ARCReplacer.
+   * @param num_frames the maximum number of frames the replacer will be required to store
+   */
+  explicit ARCReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(ARCReplacer);
+
+  ~ARCReplacer() override = default;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                    page_id_t page_id = INVALID_PAGE_ID) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+  auto GetEvictionOrder() -> std::vector<frame_id_t> override;
+
+ private:
+  struct ArcNode {
+    /** The resident list holding the frame, nullptr if the frame is not tracked. */
+    std::list<frame_id_t> *list_{nullptr};
+    std::list<frame_id_t>::iterator pos_;
+    page_id_t page_id_{INVALID_PAGE_ID};
+    bool is_evictable_{false};
+  };
+
+  struct Ghost {
+    /** The ghost list holding the page, b1_ or b2_. */
+    std::list<page_id_t> *list_;
+    std::list<page_id_t>::iterator pos_;
+  };
+
+  /** @return the least recently used evictable frame of the list, or list.end() */
+  static auto FindVictim(std::list<frame_id_t> &list, const std::vector<ArcNode> &nodes)
+      -> std::list<frame_id_t>::iterator;
+  /** Drop the least recently used ghosts until the ghost lists fit the cache size again. */
+  void TrimGhosts();
+  void DropGhost(std::list<page_id_t> &list);
+  void Untrack(frame_id_t frame_id);
+
+  std::vector<ArcNode> nodes_;
+  /** Resident frames seen once / more than once. Least recently used in front. */
+  std::list<frame_id_t> t1_;
+  std::list<frame_id_t> t2_;
+  /** Pages recently evicted from T1 / T2. Least recently evicted in front. */
+  std::list<page_id_t> b1_;
+  std::list<page_id_t> b2_;
+  std::unordered_map<page_id_t, Ghost> ghosts_;
+  /** The target size p of T1. */
+  size_t target_t1_{0};
+  /** The cache size c. */
+  size_t capacity_{0};
+  size_t evictable_size_{0};
+  std::mutex latch_;
+};
+
+}  // namespace bustub
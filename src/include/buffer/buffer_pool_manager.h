@@ -12,22 +12,89 @@
 
 #pragma once
 
+#include <algorithm>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
 #include <list>
 #include <memory>
 #include <mutex>  // NOLINT
+#include <set>
+#include <string>
 #include <unordered_map>
+#include <thread>  // NOLINT
+#include <unordered_set>
+#include <vector>
 
+#include "buffer/frame_arena.h"
 #include "buffer/lru_k_replacer.h"
+#include "buffer/replacer.h"
 #include "common/config.h"
+#include "common/metrics.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_scheduler.h"
 #include "storage/page/page.h"
 #include "storage/page/page_guard.h"
 
 namespace bustub {
 
+/** A snapshot of the counters of a buffer pool, see BufferPoolManager::GetStats(). */
+struct BufferPoolStats {
+  /** Pages asked for, through any of the fetch functions. */
+  uint64_t fetches_{0};
+  /** Fetches that found the page in the buffer pool, including pages still on their way in. */
+  uint64_t hits_{0};
+  /** Fetches that had to read the page from disk. */
+  uint64_t misses_{0};
+  /** Pages evicted to make room for other pages. */
+  uint64_t evictions_{0};
+  /** Dirty pages written back, by evictions, flushes and the background writer alike. */
+  uint64_t write_backs_{0};
+  /** Fetches that had to wait for another thread to finish moving the page between disk and memory. */
+  uint64_t pin_waits_{0};
+
+  /** @return the fraction of fetches that were hits, 0 if there were none */
+  auto HitRatio() const -> double { return fetches_ == 0 ? 0.0 : static_cast<double>(hits_) / fetches_; }
+};
+
+/**
+ * A run of contiguous page ids that one table heap or index allocates its pages from, so that its pages lie next to
+ * each other on disk instead of interleaving with the pages of everything else. See
+ * BufferPoolManager::NewPageInExtent().
+ */
+struct Extent {
+  /** The next page id to hand out. The extent is used up (or was never reserved) when it reaches end_page_id_. */
+  page_id_t next_page_id_{INVALID_PAGE_ID};
+  page_id_t end_page_id_{INVALID_PAGE_ID};
+  /** Serializes the allocations from this extent. */
+  std::mutex latch_;
+};
+
 /**
  * BufferPoolManager reads disk pages to and from its internal buffer pool.
+ *
+ * The pool can optionally be partitioned into several shards. Each shard owns a disjoint slice of the frames
+ * together with its own page table, free list, replacer and latch, and a page always lives in the shard
+ * `page_id % num_shards`. Operations on pages of different shards therefore never contend on the same latch.
+ *
+ * Shard latches are never held across disk I/O. A frame that is being read from disk is marked as "I/O in progress";
+ * other fetchers of the same page pin it and wait for the read to complete instead of issuing a read of their own.
+ *
+ * With read-ahead enabled, a fetch tagged AccessType::Scan that misses also starts asynchronous reads of the next
+ * pages in page id order, so that a sequential scan finds them resident (or already on their way) when it gets there.
+ *
+ * An optional background writer writes dirty, unpinned pages back ahead of eviction, so that evictions mostly find
+ * clean victims and foreground threads rarely have to wait for a write-back.
+ *
+ * Every frame carries a seqlock-style version (see Page::GetVersion()) that the buffer pool keeps odd while the frame
+ * holds no page or is being filled, so that FetchPageOptimistic() readers can detect evictions as well as writes.
+ *
+ * Deleted pages are reused by later allocations. With the space map loaded, the allocation state is also kept on disk
+ * so that the database file does not keep growing across restarts.
+ *
+ * NewPage() takes page ids in the order the shards hand them out, so the pages of different tables interleave on disk.
+ * NewPageInExtent() instead takes them from an extent of BUSTUB_EXTENT_SIZE contiguous page ids reserved for one table
+ * or index, which keeps its pages together, so that scans of it (and their read-ahead) read the file sequentially.
  */
 class BufferPoolManager {
  public:
@@ -37,9 +104,12 @@ class BufferPoolManager {
    * @param disk_manager the disk manager
    * @param replacer_k the lookback constant k for the LRU-K replacer
    * @param log_manager the log manager (for testing only: nullptr = disable logging). Please ignore this for P1.
+   * @param num_shards the number of independently latched partitions the frames are split into
+   * @param replacer_policy the replacement policy of the buffer pool
    */
   BufferPoolManager(size_t pool_size, DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
-                    LogManager *log_manager = nullptr);
+                    LogManager *log_manager = nullptr, size_t num_shards = 1,
+                    ReplacerPolicy replacer_policy = ReplacerPolicy::LRUK);
 
   /**
    * @brief Destroy an existing BufferPoolManager.
@@ -49,9 +119,80 @@ class BufferPoolManager {
   /** @brief Return the size (number of frames) of the buffer pool. */
   auto GetPoolSize() -> size_t { return pool_size_; }
 
+  /** @brief Return the size of a page (and of a frame) in byte, which the disk manager decides. */
+  auto GetPageSize() -> size_t { return page_size_; }
+
   /** @brief Return the pointer to all the pages in the buffer pool. */
   auto GetPages() -> Page * { return pages_; }
 
+  /** @brief Return the number of shards the buffer pool is partitioned into. */
+  auto GetNumShards() -> size_t { return shards_.size(); }
+
+  /** @brief Return the counters of the buffer pool. They are updated without any latch, so they are approximate. */
+  auto GetStats() -> BufferPoolStats;
+
+  /** @brief Return the time each disk read took. */
+  auto GetReadLatency() -> const LatencyHistogram & { return disk_scheduler_->GetReadLatency(); }
+
+  /** @brief Return the time each disk write took. */
+  auto GetWriteLatency() -> const LatencyHistogram & { return disk_scheduler_->GetWriteLatency(); }
+
+  /** @brief Set all counters and latency histograms back to zero. */
+  void ResetStats();
+
+  /**
+   * @brief Set the read-ahead window of sequential scans.
+   * @param pages the number of pages following a scan miss to prefetch asynchronously, 0 disables read-ahead
+   */
+  void SetReadAhead(size_t pages) { read_ahead_pages_ = pages; }
+
+  /** @brief Return the replacement policy the buffer pool currently runs with. */
+  auto GetReplacerPolicy() -> ReplacerPolicy { return replacer_policy_; }
+
+  /**
+   * @brief Switch the buffer pool to another replacement policy. The resident pages are handed over to the new
+   * replacers in page table order, without their access history.
+   * @param replacer_policy the new replacement policy
+   */
+  void SetReplacerPolicy(ReplacerPolicy replacer_policy);
+
+  /**
+   * @brief Start the background writer. Every interval, and whenever a shard goes over the high-water mark, it sweeps
+   * the frames of every shard and writes back up to BACKGROUND_WRITER_MAX_PAGES dirty unpinned pages, or as many as
+   * needed to bring the shard back under the mark.
+   * @param dirty_high_water the fraction of frames of a shard that may be dirty
+   * @param interval how long the writer sleeps between two rounds
+   */
+  void StartBackgroundWriter(double dirty_high_water = DIRTY_RATIO_HIGH_WATER,
+                             std::chrono::milliseconds interval = BACKGROUND_WRITER_INTERVAL);
+
+  /** @brief Stop the background writer, if it is running. */
+  void StopBackgroundWriter();
+
+  /**
+   * @brief Keep track of allocated and deallocated pages on disk. Reserves SPACE_MAP_PAGE_ID for the space map and
+   * loads the map if the database file already has one, so that pages deleted before a restart are reused after it.
+   * The map is written back by FlushAllPages() and on destruction. Must be called before any page is allocated.
+   */
+  void LoadSpaceMap();
+
+  /**
+   * @brief Save the ids of the resident pages to a file, coldest first as far as the replacers can tell, so that
+   * WarmUp() can bring them back after a restart.
+   * @param file_name the file to write, replaced as a whole
+   * @return false if the file could not be written
+   */
+  auto DumpResidentPages(const std::string &file_name) -> bool;
+
+  /**
+   * @brief Load the pages saved by DumpResidentPages(), the hottest ones if they do not all fit. The pages are read as
+   * one batch in page id order, and then accessed coldest first so that the replacers roughly recover the recency they
+   * had when they were saved. Pages that are no longer allocated are skipped, so the space map should be loaded first.
+   * @param file_name the file written by DumpResidentPages()
+   * @return the number of pages loaded, 0 if the file does not exist
+   */
+  auto WarmUp(const std::string &file_name) -> size_t;
+
   /**
    * TODO(P1): Add implementation
    *
@@ -85,11 +226,31 @@ class BufferPoolManager {
    */
   auto NewPageGuarded(page_id_t *page_id) -> BasicPageGuard;
 
+  /**
+   * @brief Create a new page like NewPage(), but take its id from the given extent. When the extent is used up, the
+   * next BUSTUB_EXTENT_SIZE page ids at the end of the database are reserved for it first.
+   *
+   * @param extent the extent of the table or index the page belongs to
+   * @param[out] page_id id of created page
+   * @return nullptr if all frames of the shard of the next page id are pinned, otherwise pointer to new page
+   */
+  auto NewPageInExtent(Extent *extent, page_id_t *page_id) -> Page *;
+
+  /** @brief PageGuard wrapper for NewPageInExtent. */
+  auto NewPageInExtentGuarded(Extent *extent, page_id_t *page_id) -> BasicPageGuard;
+
+  /**
+   * @brief Give the page ids of the extent that were never handed out back to the shards, for NewPage() to reuse.
+   * They are never allocated in the meantime; a space map saved before the release already lists them as free.
+   */
+  void ReleaseExtent(Extent *extent);
+
   /**
    * TODO(P1): Add implementation
    *
    * @brief Fetch the requested page from the buffer pool. Return nullptr if page_id needs to be fetched from the disk
-   * but all frames are currently in use and not evictable (in another word, pinned).
+   * but all frames are currently in use and not evictable (in another word, pinned), or if page_id is not allocated,
+   * e.g. because it was deleted.
    *
    * First search for page_id in the buffer pool. If not found, pick a replacement frame from either the free list or
    * the replacer (always find from the free list first), read the page from disk by calling disk_manager_->ReadPage(),
@@ -99,7 +260,7 @@ class BufferPoolManager {
    * In addition, remember to disable eviction and record the access history of the frame like you did for NewPage().
    *
    * @param page_id id of page to be fetched
-   * @param access_type type of access to the page, only needed for leaderboard tests.
+   * @param access_type type of access to the page. Pages first fetched by scans are evicted before other pages.
    * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
    */
   auto FetchPage(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> Page *;
@@ -115,11 +276,38 @@ class BufferPoolManager {
    * the returned page already has a read or write latch held, respectively.
    *
    * @param page_id, the id of the page to fetch
+   * @param access_type type of access to the page
    * @return PageGuard holding the fetched page
    */
-  auto FetchPageBasic(page_id_t page_id) -> BasicPageGuard;
-  auto FetchPageRead(page_id_t page_id) -> ReadPageGuard;
-  auto FetchPageWrite(page_id_t page_id) -> WritePageGuard;
+  auto FetchPageBasic(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> BasicPageGuard;
+  auto FetchPageRead(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> ReadPageGuard;
+  auto FetchPageWrite(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> WritePageGuard;
+
+  /**
+   * @brief Fetch several pages at once and read latch them. Each shard latch is taken once per phase rather than once
+   * per page, and the pages that are not resident are read as one asynchronous batch in page id order, after one batch
+   * of write-backs for dirty victims, so that a batch costs about one disk round trip instead of one per miss.
+   *
+   * The read latches are taken in page id order. Duplicate page ids are fine and yield guards on the same page, which
+   * share one read latch; it is released with the last of them.
+   *
+   * @param page_ids the ids of the pages to fetch
+   * @param access_type type of access to the pages
+   * @return one guard per page id, in the same order; a guard holds no page if its page could not be fetched
+   */
+  auto FetchPagesRead(const std::vector<page_id_t> &page_ids, AccessType access_type = AccessType::Unknown)
+      -> std::vector<ReadPageGuard>;
+
+  /**
+   * @brief Fetch a page for an optimistic read. A resident page is neither pinned nor latched, and the access is not
+   * recorded by the replacer. Pages found through the frame hints take no latch at all; the first optimistic fetch of
+   * a page after it was brought in looks it up in the page table under the shard latch. A page that is not resident is
+   * read in like by FetchPage() first. See OptimisticReadGuard for how to use the result.
+   *
+   * @param page_id the id of the page to fetch
+   * @return an OptimisticReadGuard on the page, or an invalid guard if the page could not be brought in
+   */
+  auto FetchPageOptimistic(page_id_t page_id) -> OptimisticReadGuard;
 
   /**
    * TODO(P1): Add implementation
@@ -143,17 +331,19 @@ class BufferPoolManager {
    * @brief Flush the target page to disk.
    *
    * Use the DiskManager::WritePage() method to flush a page to disk, REGARDLESS of the dirty flag.
-   * Unset the dirty flag of the page after flushing.
+   * Unset the dirty flag of the page after flushing. The page is durable when this returns; concurrent flushes share
+   * the DiskManager::SyncPages() call that makes them so.
    *
    * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
-   * @return false if the page could not be found in the page table, true otherwise
+   * @return false if the page could not be found in the page table or could not be written, true otherwise
    */
   auto FlushPage(page_id_t page_id) -> bool;
 
   /**
    * TODO(P1): Add implementation
    *
-   * @brief Flush all the pages in the buffer pool to disk.
+   * @brief Flush all the pages in the buffer pool to disk, and the space map if it is loaded, then make them durable
+   * with a single DiskManager::SyncPages() call.
    */
   void FlushAllPages();
 
@@ -173,40 +363,242 @@ class BufferPoolManager {
   auto DeletePage(page_id_t page_id) -> bool;
 
  private:
+  /**
+   * A shard of the buffer pool. Frame `frame_id` belongs to shard `frame_id % num_shards` and page `page_id`
+   * belongs to shard `page_id % num_shards`. Each shard allocates its own page ids, i.e.
+   * shard_index, shard_index + num_shards, shard_index + 2 * num_shards, ...
+   */
+  struct Shard {
+    Shard(size_t pool_size, size_t replacer_k, ReplacerPolicy replacer_policy, page_id_t first_page_id)
+        : replacer_(MakeReplacer(replacer_policy, pool_size, replacer_k)), next_page_id_(first_page_id) {}
+
+    /** Page table for keeping track of the pages held by this shard. */
+    std::unordered_map<page_id_t, frame_id_t> page_table_;
+    /** Replacer to find unpinned frames of this shard for replacement. */
+    std::unique_ptr<Replacer> replacer_;
+    /** List of free frames of this shard that don't have any pages on them. */
+    std::list<frame_id_t> free_list_;
+    /**
+     * Pages that are on their way between disk and a frame without being in the page table: evicted dirty pages
+     * whose write-back is in flight, and pages for which a fetcher is still acquiring a frame. Fetchers of these
+     * pages wait until they leave the set rather than reading them from disk.
+     */
+    std::unordered_set<page_id_t> in_transit_;
+    /** The next page id to be allocated by this shard. */
+    page_id_t next_page_id_;
+    /** Deallocated page ids of this shard, handed out again lowest first before next_page_id_ advances. */
+    std::set<page_id_t> free_pages_;
+    /**
+     * Page ids of this shard that an extent has reserved but not handed out yet. They are not allocated, and the space
+     * map lists them as free.
+     */
+    std::set<page_id_t> reserved_pages_;
+    /**
+     * Trunk pages of the space map on disk. They are listed there as free, but are not handed out before a later space
+     * map no longer points at them.
+     */
+    std::vector<page_id_t> trunk_pages_;
+    /** The frames owned by this shard. */
+    std::vector<frame_id_t> frames_;
+    /** Number of dirty frames of this shard. */
+    size_t num_dirty_{0};
+    /** Index into frames_ where the next sweep of the background writer starts. */
+    size_t writer_cursor_{0};
+    /** Protects the page table, free list and replacer of this shard and the metadata of the frames it owns. */
+    std::mutex latch_;
+    /** Signalled whenever a frame of this shard finishes its read or a page leaves in_transit_. */
+    std::condition_variable io_cv_;
+  };
+
   /** Number of pages in the buffer pool. */
   const size_t pool_size_;
-  /** The next page id to be allocated  */
-  std::atomic<page_id_t> next_page_id_ = 0;
+  /** Size of a page in byte. */
+  const size_t page_size_;
+  /** Shard to start searching from in the next NewPage call, so that new pages are spread across shards. */
+  std::atomic<size_t> next_shard_ = 0;
+  /** The lookback constant of LRU-K replacers. */
+  const size_t replacer_k_;
+  /** The replacement policy of all shards. */
+  std::atomic<ReplacerPolicy> replacer_policy_;
+  /** Number of pages to prefetch after a scan miss, 0 if read-ahead is disabled. */
+  std::atomic<size_t> read_ahead_pages_ = 0;
 
-  /** Array of buffer pool pages. */
+  /** Array of buffer pool pages, which hold the metadata of the frames. */
   Page *pages_;
+  /** The data of the frames. */
+  std::unique_ptr<FrameArena> arena_;
+  /**
+   * Where FetchPageOptimistic() last found each page, indexed by page id modulo pool_size_, so that its hits need no
+   * latch. A hint may be stale or collide with another page; readers check the frame before trusting it.
+   */
+  std::unique_ptr<std::atomic<frame_id_t>[]> frame_hints_;
   /** Pointer to the disk manager. */
   DiskManager *disk_manager_ __attribute__((__unused__));
+  /** Schedules the reads and write-backs of the buffer pool onto background I/O threads. */
+  std::unique_ptr<DiskScheduler> disk_scheduler_;
   /** Pointer to the log manager. Please ignore this for P1. */
   LogManager *log_manager_ __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  std::unordered_map<page_id_t, frame_id_t> page_table_;
-  /** Replacer to find unpinned pages for replacement. */
-  std::unique_ptr<LRUKReplacer> replacer_;
-  /** List of free frames that don't have any pages on them. */
-  std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
-  std::mutex latch_;
+  /** The shards of the buffer pool. */
+  std::vector<std::unique_ptr<Shard>> shards_;
+
+  /** The fraction of frames of a shard that may be dirty before the background writer is woken up. */
+  std::atomic<double> dirty_high_water_ = 1.0;
+  std::thread background_writer_;
+  bool background_writer_stop_ = false;
+  /** Protects background_writer_stop_. */
+  std::mutex background_writer_latch_;
+  std::condition_variable background_writer_cv_;
+
+  /** The counters behind GetStats(), striped so that the threads bumping them do not contend. */
+  StripedCounter fetch_cnt_;
+  StripedCounter hit_cnt_;
+  StripedCounter miss_cnt_;
+  StripedCounter eviction_cnt_;
+  StripedCounter write_back_cnt_;
+  StripedCounter pin_wait_cnt_;
+
+  /** Whether the space map is in use. Set by LoadSpaceMap() before the pool is used. */
+  bool space_map_loaded_ = false;
+  /** Serializes loading and saving the space map. */
+  std::mutex space_map_latch_;
+
+  /** @return the shard that is responsible for page_id */
+  auto GetShard(page_id_t page_id) -> Shard & { return *shards_[page_id % shards_.size()]; }
 
   /**
-   * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
-   * @return the id of the allocated page
+   * @brief Create a new page in the given shard. Shares the semantics of NewPage().
+   * @return nullptr if all frames of the shard are pinned, otherwise pointer to the new page
    */
-  auto AllocatePage() -> page_id_t;
+  auto NewPageInShard(Shard &shard, page_id_t *page_id) -> Page *;
+
+  /** @brief Map page_id to a free frame of the shard as a new, zeroed page pinned once. Caller holds the latch. */
+  auto InstallNewPage(Shard &shard, frame_id_t frame_id, page_id_t page_id) -> Page *;
 
   /**
-   * @brief Deallocate a page on disk. Caller should acquire the latch before calling this function.
-   * @param page_id id of the page to deallocate
+   * @brief Reserve the next BUSTUB_EXTENT_SIZE page ids at the end of the database for the extent. Page ids that the
+   * shards skip over on the way become free pages. Takes the latches of all shards, so the caller should hold none.
    */
-  void DeallocatePage(__attribute__((unused)) page_id_t page_id) {
-    // This is a no-nop right now without a more complex data structure to track deallocated pages
+  void ReserveExtent(Extent *extent);
+
+  /**
+   * @return true if page_id is allocated, i.e. neither beyond the end, free, reserved nor part of the space map. Caller
+   * holds the latch.
+   */
+  auto IsAllocated(Shard &shard, page_id_t page_id) -> bool {
+    return page_id >= 0 && page_id < shard.next_page_id_ && shard.free_pages_.count(page_id) == 0 &&
+           shard.reserved_pages_.count(page_id) == 0 && (!space_map_loaded_ || page_id != SPACE_MAP_PAGE_ID) &&
+           std::find(shard.trunk_pages_.begin(), shard.trunk_pages_.end(), page_id) == shard.trunk_pages_.end();
   }
 
-  // TODO(student): You may add additional private members and helper functions
+  /**
+   * @brief Check that page_id may be read into a frame, i.e. that it is allocated. Only allocated pages may enter the
+   * page table, or NewPage() could map a page id a second time. Without a space map, a page beyond the end may have
+   * been allocated before a restart; it counts as allocated from now on. Caller holds the latch.
+   */
+  auto ClaimFetchable(Shard &shard, page_id_t page_id) -> bool;
+
+  /**
+   * @brief Take a frame from the free list of the shard, or evict one, without waiting for any I/O. Caller should
+   * hold the shard latch. A dirty victim is removed from the page table and put in in_transit_; the caller is then
+   * responsible for writing it back before reusing the frame and for taking it out of in_transit_ afterwards.
+   * @param[out] frame_id the frame that is now free to hold another page
+   * @param[out] write_back_page_id the dirty page that still has to be written back, or INVALID_PAGE_ID
+   * @return false if all frames of the shard are pinned
+   */
+  auto TakeFrame(Shard &shard, frame_id_t *frame_id, page_id_t *write_back_page_id) -> bool;
+
+  /**
+   * @brief Take a frame from the free list of the shard, or evict one. Caller should hold the shard latch through
+   * `lock`. A dirty victim is removed from the page table and written back to disk with the latch released, so the
+   * caller must re-validate anything it looked up before the call.
+   * @param lock the caller's lock on the shard latch
+   * @param[out] frame_id the frame that is now free to hold another page
+   * @return false if all frames of the shard are pinned, or if the write-back of the victim failed
+   */
+  auto AcquireFrame(Shard &shard, std::unique_lock<std::mutex> &lock, frame_id_t *frame_id) -> bool;
+
+  /**
+   * @brief Put a victim whose write-back failed back into the frame it was evicted from, still dirty, and take it out
+   * of in_transit_. Caller holds the shard latch and has not read anything into the frame yet.
+   */
+  void RestoreVictim(Shard &shard, frame_id_t frame_id, page_id_t victim_page_id);
+
+  /**
+   * @brief Undo the install of the page in the frame after its read failed, or was never issued because the
+   * write-back of the victim failed. The frame goes back to the victim if there is one, or is freed once the last
+   * pin on it is dropped. Fetchers that pinned the frame for the page find it gone when they wake up and must drop
+   * their pins with UnpinFrame(). Caller holds the shard latch.
+   * @param victim_page_id the victim still occupying the frame, or INVALID_PAGE_ID
+   */
+  void AbandonRead(Shard &shard, frame_id_t frame_id, page_id_t victim_page_id);
+
+  /**
+   * @brief Drop a pin on the frame. The frame becomes evictable when the last pin is gone, or goes back to the free
+   * list if its page was abandoned meanwhile. Caller holds the shard latch.
+   */
+  void UnpinFrame(Shard &shard, frame_id_t frame_id);
+
+  /** @brief Set the dirty flag of a page of the shard, keeping the shard's dirty count up to date. */
+  void SetDirty(Shard &shard, Page &page, bool is_dirty);
+
+  /**
+   * @brief Write the pages in the given frames of the shard back to disk as one batch, regardless of their dirty
+   * flags, and wait for the writes to complete. The pages stay pinned while the latch is released for the I/O.
+   * @param lock the caller's lock on the shard latch
+   * @return false if some write failed; those pages stay dirty
+   */
+  auto WriteBack(Shard &shard, std::unique_lock<std::mutex> &lock, const std::vector<frame_id_t> &frame_ids) -> bool;
+
+  /** @brief Run one round of the background writer over the shard. */
+  void RunBackgroundWriter(Shard &shard);
+
+  /**
+   * @brief Pin a resident frame and wait until any in-flight read into it has completed. Caller should hold the
+   * shard latch through `lock`.
+   * @return the page, or nullptr if the read failed, in which case the pin has been dropped again
+   */
+  auto PinResidentFrame(Shard &shard, std::unique_lock<std::mutex> &lock, frame_id_t frame_id, AccessType access_type)
+      -> Page *;
+
+  /**
+   * @brief Pin the given pages, reading the ones that are not resident in batches. Shares the semantics of FetchPage()
+   * for every page.
+   * @return one page per page id, nullptr where a page could not be fetched
+   */
+  auto FetchPages(const std::vector<page_id_t> &page_ids, AccessType access_type) -> std::vector<Page *>;
+
+  /**
+   * @brief Start asynchronous reads of the read-ahead window following page_id. Caller should not hold any latch.
+   */
+  void ReadAhead(page_id_t page_id);
+
+  /**
+   * @brief Start an asynchronous read of page_id into an unpinned frame of the shard, unless the page is already
+   * resident or being moved. The frame becomes evictable once the read has completed. Never waits for I/O.
+   * @param mark whether a scan reaching the page should extend the read-ahead window
+   * @param[out] started true if a read was issued
+   * @return false if no frame could be found for the page
+   */
+  auto PrefetchPage(Shard &shard, page_id_t page_id, bool mark, bool *started) -> bool;
+
+  /** @brief Read or write a page through the disk scheduler, bypassing the pool. Caller should not hold any latch. */
+  void DiskIo(bool is_write, char *data, page_id_t page_id);
+
+  /** @brief Write the space map to disk, if it is loaded. Caller should not hold any latch. */
+  void SaveSpaceMap();
+
+  /**
+   * @brief Allocate a page on disk, reusing a deallocated page of the shard if there is one. Caller should acquire the
+   * shard latch before calling this function.
+   * @return the id of the allocated page
+   */
+  auto AllocatePage(Shard &shard) -> page_id_t;
+
+  /**
+   * @brief Deallocate a page on disk so that a later AllocatePage() can reuse it. Ids the shard never allocated are
+   * ignored. Caller should acquire the shard latch before calling this function.
+   * @param page_id id of the page to deallocate
+   */
+  void DeallocatePage(Shard &shard, page_id_t page_id);
 };
 }  // namespace bustub
@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// clock_pro_replacer.h
+//
+// Identification: src/include/buffer/clock_pro_replacer.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * ClockProReplacer implements the CLOCK-Pro policy (Jiang, Chen and Zhang, USENIX ATC '05), a clock approximation of
+ * LIRS that tells hot pages from cold ones by their reuse distance.
+ *
+ * Resident frames are either hot or cold and sit on one circle swept by two hands:
+ *  - The cold hand evicts cold frames whose reference bit is clear. A referenced cold frame that is still in its test
+ *    period has been reused within a short distance and becomes hot; otherwise it gets a fresh test period.
+ *  - The hot hand runs whenever there are more hot frames than the hot target allows. It turns unreferenced hot
+ *    frames cold and ends the test periods of the cold frames it passes.
+ * A cold page evicted during its test period is remembered as a non-resident test page. If it comes back before its
+ * test period ends, it is admitted hot and the cold target grows; test periods that expire without a reuse shrink
+ * it. Non-resident test pages are kept in FIFO order and expire once there are more than c of them, which stands in
+ * for the third (test) hand of the paper.
+ *
+ * The cache size c is the largest number of frames the replacer has tracked at once. Scan accesses never set the
+ * reference bit and never start a test period, so pages seen only by scans cannot become hot.
+ */
+class ClockProReplacer : public Replacer {
+ public:
+  /**
+   * @brief Create a new ClockProReplacer.
+   * @param num_frames the maximum number of frames the replacer will be required to store
+   */
+  explicit ClockProReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(ClockProReplacer);
+
+  ~ClockProReplacer() override = default;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                    page_id_t page_id = INVALID_PAGE_ID) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+  auto GetEvictionOrder() -> std::vector<frame_id_t> override;
+
+ private:
+  struct ClockProNode {
+    bool is_present_{false};
+    bool is_evictable_{false};
+    bool hot_{false};
+    bool ref_{false};
+    /** True while a cold frame is in its test period. */
+    bool test_{false};
+    page_id_t page_id_{INVALID_PAGE_ID};
+    /** Neighbours on the circle, valid while the frame is present. */
+    frame_id_t prev_{-1};
+    frame_id_t next_{-1};
+  };
+
+  /** Take a present frame off the circle and forget about it. */
+  void Unlink(frame_id_t frame_id);
+  /** Move the hot hand until it has turned one hot frame cold. */
+  void RunHandHot();
+  /** Run the hot hand until the hot frames fit the hot target again. */
+  void BalanceHot();
+  /** Remember an evicted cold page whose test period is still running. */
+  void AddTestPage(page_id_t page_id);
+
+  std::vector<ClockProNode> nodes_;
+  /** Frames the hands point at, -1 if the circle is empty. */
+  frame_id_t hand_cold_{-1};
+  frame_id_t hand_hot_{-1};
+  /** Non-resident test pages, oldest in front. */
+  std::list<page_id_t> test_pages_;
+  std::unordered_map<page_id_t, std::list<page_id_t>::iterator> test_page_index_;
+  size_t num_present_{0};
+  size_t num_hot_{0};
+  size_t evictable_size_{0};
+  /** The cold target m_c; at most c - m_c frames may be hot. */
+  size_t cold_target_{1};
+  /** The cache size c. */
+  size_t capacity_{0};
+  std::mutex latch_;
+};
+
+}  // namespace bustub
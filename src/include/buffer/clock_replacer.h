@@ -12,17 +12,21 @@
 
 #pragma once
 
-#include <list>
 #include <mutex>  // NOLINT
 #include <vector>
 
 #include "buffer/replacer.h"
 #include "common/config.h"
+#include "common/macros.h"
 
 namespace bustub {
 
 /**
  * ClockReplacer implements the clock replacement policy, which approximates the Least Recently Used policy.
+ *
+ * The tracked frames form a circular list in the order they entered the replacer. Every access sets the frame's
+ * reference bit; the clock hand sweeps the circle, clearing reference bits, and evicts the first evictable frame whose
+ * bit is already clear. Scans do not set the reference bit, so pages touched only by scans leave on the next sweep.
  */
 class ClockReplacer : public Replacer {
  public:
@@ -32,21 +36,44 @@ class ClockReplacer : public Replacer {
    */
   explicit ClockReplacer(size_t num_pages);
 
+  DISALLOW_COPY_AND_MOVE(ClockReplacer);
+
   /**
    * Destroys the ClockReplacer.
    */
   ~ClockReplacer() override;
 
-  auto Victim(frame_id_t *frame_id) -> bool override;
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                    page_id_t page_id = INVALID_PAGE_ID) override;
 
-  void Pin(frame_id_t frame_id) override;
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
 
-  void Unpin(frame_id_t frame_id) override;
+  void Remove(frame_id_t frame_id) override;
 
   auto Size() -> size_t override;
 
+  auto GetEvictionOrder() -> std::vector<frame_id_t> override;
+
  private:
-  // TODO(student): implement me!
+  struct ClockNode {
+    bool is_present_{false};
+    bool is_evictable_{false};
+    bool ref_{false};
+    /** Neighbours in the circle, valid while the frame is present. */
+    frame_id_t prev_{-1};
+    frame_id_t next_{-1};
+  };
+
+  /** Take a present frame out of the circle and forget about it. */
+  void Unlink(frame_id_t frame_id);
+
+  std::vector<ClockNode> nodes_;
+  /** The frame the clock hand points at, -1 if the circle is empty. */
+  frame_id_t hand_{-1};
+  size_t evictable_size_{0};
+  std::mutex latch_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.h
+//
+// Identification: src/include/buffer/frame_arena.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * The bytes after each frame that are kept poisoned when building with AddressSanitizer, so that page overflows are
+ * caught inside the arena too. One smallest page keeps the frames aligned.
+ */
+#ifdef BUSTUB_ASAN
+static constexpr size_t FRAME_RED_ZONE_SIZE = BUSTUB_PAGE_SIZE;
+#else
+static constexpr size_t FRAME_RED_ZONE_SIZE = 0;
+#endif
+
+/**
+ * FrameArena is a single contiguous allocation holding the data of every frame of the buffer pool. It is mmap'ed, so
+ * every frame is aligned to the OS page size, which is what O_DIRECT I/O requires, and it starts out zeroed.
+ *
+ * With huge pages requested, the arena is backed by explicit huge pages (MAP_HUGETLB) when the system has some
+ * reserved, and is otherwise marked for transparent huge pages, which cuts the TLB misses of touching many frames.
+ *
+ * The frames are contiguous, except that with AddressSanitizer each one is followed by a poisoned red zone of
+ * FRAME_RED_ZONE_SIZE bytes.
+ */
+class FrameArena {
+ public:
+  /**
+   * @brief Map the arena. Throws if the memory cannot be mapped.
+   * @param num_frames the number of frames
+   * @param frame_size the size of a frame in byte, i.e. the page size
+   * @param use_huge_pages whether to back the arena with huge pages if possible
+   */
+  FrameArena(size_t num_frames, size_t frame_size, bool use_huge_pages);
+
+  ~FrameArena();
+
+  FrameArena(const FrameArena &) = delete;
+  auto operator=(const FrameArena &) -> FrameArena & = delete;
+
+  /** @return the data of the given frame */
+  auto GetFrame(frame_id_t frame_id) -> char * { return data_ + static_cast<size_t>(frame_id) * frame_stride_; }
+
+  /** @return true if the arena is backed by explicit huge pages */
+  auto UsesHugeTlb() const -> bool { return huge_tlb_; }
+
+ private:
+  char *data_;
+  /** The distance between the starts of neighbouring frames, i.e. the frame size plus the red zone. */
+  size_t frame_stride_;
+  /** The mapped size, which may be rounded up to a multiple of the huge page size. */
+  size_t size_;
+  bool huge_tlb_{false};
+};
+
+}  // namespace bustub
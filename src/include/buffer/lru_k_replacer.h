@@ -13,30 +13,31 @@
 #pragma once
 
 #include <cstddef>
-#include <limits>
-#include <list>
 #include <mutex>  // NOLINT
-#include <unordered_map>
 #include <vector>
 
+#include "buffer/replacer.h"
 #include "common/config.h"
 #include "common/macros.h"
 
 namespace bustub {
 
-enum class AccessType { Unknown = 0, Get, Scan };
-
+/**
+ * Replacement metadata of a single frame. The frame's last k access timestamps live in a fixed-size ring owned by the
+ * replacer, so recording an access never allocates.
+ */
 class LRUKNode {
  public:
-  /** History of last seen K timestamps of this page. Least recent timestamp stored in front. */
-  // Remove maybe_unused if you start using them. Feel free to change the member variables as you want.
-
-  std::list<size_t> history_;
-  frame_id_t fid_;
-  size_t min_history_size_;
+  /** Number of timestamps in the history ring, at most k. */
+  size_t history_size_{0};
+  /** Slot of the ring the next timestamp is written to. Once the ring is full, this is the oldest timestamp. */
+  size_t history_next_{0};
+  /** Position of the frame in the eviction heap, valid while the frame is evictable. */
+  size_t heap_index_{0};
+  bool is_present_{false};
   bool is_evictable_{false};
-
-  bool over_k_{false};
+  /** True while the frame has only been touched by scans and sits in the probationary queue. */
+  bool in_probation_{false};
 };
 
 /**
@@ -49,8 +50,19 @@ class LRUKNode {
  * A frame with less than k historical references is given
  * +inf as its backward k-distance. When multipe frames have +inf backward k-distance,
  * classical LRU algorithm is used to choose victim.
+ *
+ * To keep large scans from flushing the working set, the replacer is scan resistant in the spirit of the 2Q A1in
+ * queue: a frame first brought in by an AccessType::Scan access enters a FIFO probationary queue instead of the
+ * LRU-k history, and probationary frames are always evicted before any other frame. Further scan accesses neither
+ * move it in the queue nor add history; the first non-scan access promotes it into the LRU-k history. Scan accesses
+ * to frames that are already in the LRU-k history are ignored.
+ *
+ * The evictable frames are kept in an indexed binary min-heap ordered by (class, oldest recorded timestamp), where
+ * the classes are probationary < fewer than k accesses < k accesses. Within the last class the oldest of the last k
+ * timestamps is exactly the one that determines the backward k-distance, so the heap top is always the victim:
+ * Evict, RecordAccess, SetEvictable and Remove are O(log n), and none of them allocate memory.
  */
-class LRUKReplacer {
+class LRUKReplacer : public Replacer {
  public:
   /**
    *
@@ -68,7 +80,7 @@ class LRUKReplacer {
    *
    * @brief Destroys the LRUReplacer.
    */
-  ~LRUKReplacer() = default;
+  ~LRUKReplacer() override = default;
 
   /**
    * TODO(P1): Add implementation
@@ -86,7 +98,7 @@ class LRUKReplacer {
    * @param[out] frame_id id of frame that is evicted.
    * @return true if a frame is evicted successfully, false if no frames can be evicted.
    */
-  auto Evict(frame_id_t *frame_id) -> bool;
+  auto Evict(frame_id_t *frame_id) -> bool override;
 
   /**
    * TODO(P1): Add implementation
@@ -98,10 +110,11 @@ class LRUKReplacer {
    * also use BUSTUB_ASSERT to abort the process if frame id is invalid.
    *
    * @param frame_id id of frame that received a new access.
-   * @param access_type type of access that was received. This parameter is only needed for
-   * leaderboard tests.
+   * @param access_type type of access that was received. Scan accesses are kept out of the LRU-k history.
+   * @param page_id unused, LRU-k forgets a page as soon as its frame is evicted
    */
-  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown);
+  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                    page_id_t page_id = INVALID_PAGE_ID) override;
 
   /**
    * TODO(P1): Add implementation
@@ -120,7 +133,7 @@ class LRUKReplacer {
    * @param frame_id id of frame whose 'evictable' status will be modified
    * @param set_evictable whether the given frame is evictable or not
    */
-  void SetEvictable(frame_id_t frame_id, bool set_evictable);
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
 
   /**
    * TODO(P1): Add implementation
@@ -139,7 +152,7 @@ class LRUKReplacer {
    *
    * @param frame_id id of frame to be removed
    */
-  void Remove(frame_id_t frame_id);
+  void Remove(frame_id_t frame_id) override;
 
   /**
    * TODO(P1): Add implementation
@@ -148,22 +161,33 @@ class LRUKReplacer {
    *
    * @return size_t
    */
-  auto Size() -> size_t;
+  auto Size() -> size_t override;
+
+  /** @brief List the tracked frames in eviction order: probationary, then +inf k-distance, then by k-distance. */
+  auto GetEvictionOrder() -> std::vector<frame_id_t> override;
 
  private:
-  // TODO(student): implement me! You can replace these member variables as you like.
-  // Remove maybe_unused if you start using them.
-  [[maybe_unused]] std::unordered_map<frame_id_t, LRUKNode> node_store_;
+  /** @return whether the heap entry of frame a should be evicted before the one of frame b */
+  auto EvictsBefore(frame_id_t a, frame_id_t b) const -> bool;
+  /** @return the oldest timestamp in the history ring of the frame */
+  auto OldestTimestamp(frame_id_t frame_id) const -> size_t;
+  void HeapPush(frame_id_t frame_id);
+  void HeapErase(frame_id_t frame_id);
+  void HeapSiftUp(size_t index);
+  void HeapSiftDown(size_t index);
+  void HeapSwap(size_t a, size_t b);
+  /** Forget the frame's history; the frame must not be in the heap. */
+  void ResetNode(frame_id_t frame_id);
+
+  std::vector<LRUKNode> node_store_;
+  /** The history rings of all frames, k timestamps per frame, back to back. */
+  std::vector<size_t> history_;
+  /** Evictable frames, as a binary min-heap under EvictsBefore. */
+  std::vector<frame_id_t> heap_;
   size_t current_timestamp_{0};
-  size_t curr_size_{0};
-  size_t evictable_size_{0};
   size_t replacer_size_;
   size_t k_;
   std::mutex latch_;
-
-  std::list<LRUKNode> over_k_nodes_;
-  std::list<LRUKNode> less_k_nodes_;
-  std::unordered_map<frame_id_t, std::list<LRUKNode>::iterator> hash_cache_;
 };
 
 }  // namespace bustub
@@ -12,41 +12,27 @@
 
 #pragma once
 
-#include <list>
-#include <mutex>  // NOLINT
-#include <vector>
-
-#include "buffer/replacer.h"
+#include "buffer/lru_k_replacer.h"
 #include "common/config.h"
 
 namespace bustub {
 
 /**
- * LRUReplacer implements the Least Recently Used replacement policy.
+ * LRUReplacer implements the Least Recently Used replacement policy, which is LRU-k with k = 1: the backward
+ * 1-distance of a frame is the time since its most recent access.
  */
-class LRUReplacer : public Replacer {
+class LRUReplacer : public LRUKReplacer {
  public:
   /**
    * Create a new LRUReplacer.
    * @param num_pages the maximum number of pages the LRUReplacer will be required to store
    */
-  explicit LRUReplacer(size_t num_pages);
+  explicit LRUReplacer(size_t num_pages) : LRUKReplacer(num_pages, 1) {}
 
   /**
    * Destroys the LRUReplacer.
    */
-  ~LRUReplacer() override;
-
-  auto Victim(frame_id_t *frame_id) -> bool override;
-
-  void Pin(frame_id_t frame_id) override;
-
-  void Unpin(frame_id_t frame_id) override;
-
-  auto Size() -> size_t override;
-
- private:
-  // TODO(student): implement me!
+  ~LRUReplacer() override = default;
 };
 
 }  // namespace bustub
@@ -12,12 +12,25 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "common/config.h"
 
 namespace bustub {
 
+enum class AccessType { Unknown = 0, Get, Scan };
+
+/** The replacement policies the buffer pool can run with. */
+enum class ReplacerPolicy { LRUK = 0, LRU, Clock, ARC, ClockPro };
+
 /**
- * Replacer is an abstract class that tracks page usage.
+ * Replacer is an abstract class that tracks frame usage and picks the frames to evict.
+ *
+ * A frame enters the replacer on its first RecordAccess() and starts out non-evictable. The buffer pool toggles
+ * SetEvictable() as the frame is pinned and unpinned, and Evict() only ever returns evictable frames. Evict() and
+ * Remove() make the replacer forget the frame, which may then enter again with a different page.
  */
 class Replacer {
  public:
@@ -25,26 +38,61 @@ class Replacer {
   virtual ~Replacer() = default;
 
   /**
-   * Remove the victim frame as defined by the replacement policy.
-   * @param[out] frame_id id of frame that was removed, nullptr if no victim was found
-   * @return true if a victim frame was found, false otherwise
+   * @brief Remove the victim frame as defined by the replacement policy.
+   * @param[out] frame_id id of frame that was evicted
+   * @return true if a victim frame was found, false if no frames can be evicted
+   */
+  virtual auto Evict(frame_id_t *frame_id) -> bool = 0;
+
+  /**
+   * @brief Record that the given frame was accessed. Throws if the frame id is out of range.
+   * @param frame_id id of frame that received a new access
+   * @param access_type type of access that was received
+   * @param page_id the page held by the frame. Policies that remember evicted pages (ARC, CLOCK-Pro) use it to
+   * recognize a page coming back; INVALID_PAGE_ID disables that.
    */
-  virtual auto Victim(frame_id_t *frame_id) -> bool = 0;
+  virtual void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                            page_id_t page_id = INVALID_PAGE_ID) = 0;
 
   /**
-   * Pins a frame, indicating that it should not be victimized until it is unpinned.
-   * @param frame_id the id of the frame to pin
+   * @brief Toggle whether a frame may be evicted. Throws if the frame is not tracked by the replacer.
+   * @param frame_id id of frame whose 'evictable' status will be modified
+   * @param set_evictable whether the given frame is evictable or not
    */
-  virtual void Pin(frame_id_t frame_id) = 0;
+  virtual void SetEvictable(frame_id_t frame_id, bool set_evictable) = 0;
 
   /**
-   * Unpins a frame, indicating that it can now be victimized.
-   * @param frame_id the id of the frame to unpin
+   * @brief Forget an evictable frame regardless of the policy, e.g. because its page was deleted. Does nothing if the
+   * frame is not tracked, and throws if it is not evictable.
+   * @param frame_id id of frame to be removed
    */
-  virtual void Unpin(frame_id_t frame_id) = 0;
+  virtual void Remove(frame_id_t frame_id) = 0;
 
-  /** @return the number of elements in the replacer that can be victimized */
+  /** @return the number of evictable frames */
   virtual auto Size() -> size_t = 0;
+
+  /**
+   * @brief List all tracked frames, evictable or not, in the order the policy would evict them if they all were, i.e.
+   * coldest first. Policies that do not keep a total order list their best approximation.
+   */
+  virtual auto GetEvictionOrder() -> std::vector<frame_id_t> = 0;
 };
 
+/**
+ * @brief Create a replacer running the given policy.
+ * @param policy the replacement policy
+ * @param num_frames the number of frame ids the replacer must accept, i.e. [0, num_frames)
+ * @param k the lookback constant of LRU-K, ignored by the other policies
+ */
+auto MakeReplacer(ReplacerPolicy policy, size_t num_frames, size_t k) -> std::unique_ptr<Replacer>;
+
+/**
+ * @brief Parse a policy name ("lru_k", "lru", "clock", "arc" or "clock_pro", case-insensitive).
+ * @return false if the name is unknown
+ */
+auto ReplacerPolicyFromString(const std::string &name, ReplacerPolicy *policy) -> bool;
+
+/** @return the name of the policy as accepted by ReplacerPolicyFromString() */
+auto ReplacerPolicyToString(ReplacerPolicy policy) -> std::string;
+
 }  // namespace bustub
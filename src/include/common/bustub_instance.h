@@ -218,9 +218,20 @@ class BustubInstance {
   auto MakeExecutorContext(Transaction *txn, bool is_modify) -> std::unique_ptr<ExecutorContext>;
 
  public:
-  explicit BustubInstance(const std::string &db_file_name);
+  /** Frames of the buffer pool by default. GenerateTestTable needs more than the BUFFER_POOL_SIZE of `config.h`. */
+  static constexpr size_t DEFAULT_POOL_SIZE = 128;
 
-  BustubInstance();
+  /**
+   * Open (or create) a database file.
+   * @param db_file_name the database file
+   * @param pool_size the number of frames of the buffer pool
+   * @param page_size the page size of a new database file; an existing one keeps the page size it was created with
+   */
+  explicit BustubInstance(const std::string &db_file_name, size_t pool_size = DEFAULT_POOL_SIZE,
+                          size_t page_size = BUSTUB_PAGE_SIZE);
+
+  /** Create an in-memory database. */
+  explicit BustubInstance(size_t pool_size = DEFAULT_POOL_SIZE, size_t page_size = BUSTUB_PAGE_SIZE);
 
   ~BustubInstance();
 
@@ -278,6 +289,7 @@ class BustubInstance {
  private:
   void CmdDisplayTables(ResultWriter &writer);
   void CmdDisplayIndices(ResultWriter &writer);
+  void CmdDisplayBufferPoolStats(ResultWriter &writer);
   void CmdDisplayHelp(ResultWriter &writer);
   void WriteOneCell(const std::string &cell, ResultWriter &writer);
 
@@ -288,6 +300,8 @@ class BustubInstance {
   void HandleVariableSetStatement(Transaction *txn, const VariableSetStatement &stmt, ResultWriter &writer);
 
   std::unordered_map<std::string, std::string> session_variables_;
+  /** Where the resident pages of the buffer pool are saved on shutdown, empty for in-memory instances. */
+  std::string buffer_pool_dump_file_name_;
 };
 
 }  // namespace bustub
@@ -27,15 +27,30 @@ extern std::atomic<bool> enable_logging;
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
 extern std::chrono::duration<int64_t> log_timeout;
 
+/** True if buffer pools should back their frames with huge pages when the system provides them. */
+extern std::atomic<bool> enable_huge_pages;
+
 static constexpr int INVALID_PAGE_ID = -1;                                           // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                            // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                               // invalid log sequence number
 static constexpr int HEADER_PAGE_ID = 0;                                             // the header page id
-static constexpr int BUSTUB_PAGE_SIZE = 4096;                                        // size of a data page in byte
+static constexpr int SPACE_MAP_PAGE_ID = 0;                                          // the page holding the space map
+static constexpr int BUSTUB_PAGE_SIZE = 4096;                                        // default and smallest page size
+static constexpr int BUSTUB_MAX_PAGE_SIZE = 32768;                                   // largest page size, see TablePage
 static constexpr int BUFFER_POOL_SIZE = 10;                                          // size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
-static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+
+static constexpr int LRUK_REPLACER_K = 10;              // lookback window for lru-k replacer
+static constexpr int DISK_SCHEDULER_NUM_WORKERS = 4;    // number of background threads serving disk requests
+static constexpr int SCAN_READ_AHEAD_PAGES = 8;         // pages prefetched after a sequential scan miss
+static constexpr int BUSTUB_EXTENT_SIZE = 64;           // contiguous pages reserved at once for a table or index
+static constexpr double BULK_LOAD_FILL_FACTOR = 0.9;    // how full B+ tree bulk loading packs the pages
+static constexpr int OPTIMISTIC_DESCENT_ATTEMPTS = 3;   // latch-free B+ tree descents before latch crabbing
+static constexpr int BACKGROUND_WRITER_MAX_PAGES = 16;  // pages written back per shard and background writer round
+static constexpr double DIRTY_RATIO_HIGH_WATER = 0.25;  // fraction of the frames of a shard allowed to be dirty
+
+static constexpr std::chrono::milliseconds BACKGROUND_WRITER_INTERVAL{50};  // sleep between background writer rounds
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
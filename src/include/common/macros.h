@@ -28,6 +28,15 @@ namespace bustub {
 
 #define UNREACHABLE(message) throw std::logic_error(message)
 
+// Defined when building with AddressSanitizer, with either GCC or Clang.
+#if defined(__SANITIZE_ADDRESS__)
+#define BUSTUB_ASAN
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define BUSTUB_ASAN
+#endif
+#endif
+
 // Macros to disable copying and moving
 #define DISALLOW_COPY(cname)                                    \
   cname(const cname &) = delete;                   /* NOLINT */ \
@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// metrics.h
+//
+// Identification: src/include/common/metrics.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <string>
+
+namespace bustub {
+
+/**
+ * A counter that many threads can bump without contending on one cache line. Every thread adds to one of a fixed
+ * number of stripes, picked once per thread, and readers sum the stripes up. Reads are not synchronized with
+ * concurrent adds, so a value read while the counter is busy is only approximate.
+ */
+class StripedCounter {
+ public:
+  static constexpr size_t NUM_STRIPES = 16;
+
+  /** Add n to the counter. */
+  void Add(uint64_t n = 1) { stripes_[StripeIndex()].value_.fetch_add(n, std::memory_order_relaxed); }
+
+  /** @return the sum of all stripes */
+  auto Get() const -> uint64_t;
+
+  /** Set the counter back to zero. */
+  void Reset();
+
+ private:
+  /** @return the stripe of the calling thread */
+  static auto StripeIndex() -> size_t;
+
+  struct alignas(64) Stripe {
+    std::atomic<uint64_t> value_{0};
+  };
+  std::array<Stripe, NUM_STRIPES> stripes_;
+};
+
+/**
+ * A histogram of latencies with power-of-two buckets: bucket 0 counts latencies below 1us and bucket i > 0 those in
+ * [2^(i-1), 2^i) us. The last bucket also takes everything longer. Recording is lock-free.
+ */
+class LatencyHistogram {
+ public:
+  static constexpr size_t NUM_BUCKETS = 28;
+
+  /** Record one latency. */
+  void Record(std::chrono::nanoseconds latency);
+
+  /** @return the number of recorded latencies */
+  auto Count() const -> uint64_t;
+
+  /** @return the mean latency in microseconds, 0 if nothing was recorded */
+  auto MeanMicros() const -> double;
+
+  /**
+   * @return an upper bound of the given percentile in microseconds, i.e. the upper end of the bucket the percentile
+   * falls in, 0 if nothing was recorded
+   * @param percentile the percentile in [0, 100]
+   */
+  auto PercentileMicros(double percentile) const -> uint64_t;
+
+  /** @return the number of latencies in the given bucket */
+  auto BucketCount(size_t bucket) const -> uint64_t { return buckets_[bucket].load(std::memory_order_relaxed); }
+
+  /** @return the count, mean and some percentiles, e.g. "count=12 avg=35.2us p50<=32us p99<=128us max<=128us" */
+  auto ToString() const -> std::string;
+
+  /** Forget every recorded latency. */
+  void Reset();
+
+ private:
+  std::array<std::atomic<uint64_t>, NUM_BUCKETS> buckets_{};
+  std::atomic<uint64_t> total_ns_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,42 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compression_util.h
+//
+// Identification: src/include/common/util/compression_util.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+namespace bustub {
+
+/**
+ * CompressionUtil compresses small buffers, such as pages, with a fast LZ77 scheme that writes the LZ4 block format:
+ * a sequence of (token, literals, match offset, match length) records. It favours speed over ratio, with a greedy
+ * single-probe match finder, and only handles inputs of up to 64 KiB.
+ */
+class CompressionUtil {
+ public:
+  /** The largest input Compress() accepts. */
+  static constexpr size_t MAX_INPUT_SIZE = 65536;
+
+  /**
+   * Compress src into dst.
+   * @return the compressed size, or 0 if the input is too large or the output does not fit into dst_capacity bytes
+   */
+  static auto Compress(const char *src, size_t src_size, char *dst, size_t dst_capacity) -> size_t;
+
+  /**
+   * Decompress the output of Compress() into dst.
+   * @return false if src is malformed or does not decompress to exactly dst_size bytes
+   */
+  static auto Decompress(const char *src, size_t src_size, char *dst, size_t dst_size) -> bool;
+};
+
+}  // namespace bustub
@@ -13,9 +13,9 @@
 #pragma once
 
 #include <atomic>
-#include <fstream>
-#include <future>  // NOLINT
-#include <mutex>   // NOLINT
+#include <condition_variable>  // NOLINT
+#include <future>              // NOLINT
+#include <mutex>               // NOLINT
 #include <string>
 
 #include "common/config.h"
@@ -25,24 +25,30 @@ namespace bustub {
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
+ *
+ * Pages are read and written with positional I/O (pread / pwrite), so concurrent page I/O shares no file cursor and
+ * takes no latch. A written page is not durable until the next SyncPages() returns.
  */
 class DiskManager {
  public:
   /**
    * Creates a new disk manager that writes to the specified database file.
    * @param db_file the file name of the database file to write to
+   * @param page_size the page size of a new database file. A file that already holds a space map keeps the page size
+   * recorded there, so this only matters the first time a file is opened.
    */
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::string &db_file, size_t page_size = BUSTUB_PAGE_SIZE);
 
   /** FOR TEST / LEADERBOARD ONLY, used by DiskManagerMemory */
   DiskManager() = default;
 
-  virtual ~DiskManager() = default;
+  /** Closes the files if ShutDown() has not. */
+  virtual ~DiskManager();
 
   /**
-   * Shut down the disk manager and close all the file resources.
+   * Shut down the disk manager, make the written pages durable and close all the file resources.
    */
-  void ShutDown();
+  virtual void ShutDown();
 
   /**
    * Write a page to the database file.
@@ -59,7 +65,14 @@ class DiskManager {
   virtual void ReadPage(page_id_t page_id, char *page_data);
 
   /**
-   * Flush the entire log buffer into disk.
+   * Make all the pages written before the call durable. Concurrent callers are served by a single fdatasync whenever
+   * possible: a caller that arrives while a sync is in progress waits for the next one, which covers everyone who
+   * arrived in the meantime.
+   */
+  virtual void SyncPages();
+
+  /**
+   * Flush the entire log buffer into disk, returning once it is durable.
    * @param log_data raw log data
    * @param size size of log entry
    */
@@ -74,6 +87,15 @@ class DiskManager {
    */
   auto ReadLog(char *log_data, int size, int offset) -> bool;
 
+  /** @return the size of the pages of this database in byte */
+  auto GetPageSize() const -> size_t { return page_size_; }
+
+  /**
+   * @return true if pages of the given size can be used: a power of two between BUSTUB_PAGE_SIZE and
+   * BUSTUB_MAX_PAGE_SIZE
+   */
+  static auto IsValidPageSize(size_t page_size) -> bool;
+
   /** @return the number of disk flushes */
   auto GetNumFlushes() const -> int;
 
@@ -83,6 +105,9 @@ class DiskManager {
   /** @return the number of disk writes */
   auto GetNumWrites() const -> int;
 
+  /** @return the number of fdatasync calls made for the database file */
+  auto GetNumSyncs() const -> int { return num_syncs_; }
+
   /**
    * Sets the future which is used to check for non-blocking flushes.
    * @param f the non-blocking flush check
@@ -93,19 +118,40 @@ class DiskManager {
   inline auto HasFlushLogFuture() -> bool { return flush_log_f_ != nullptr; }
 
  protected:
+  /** Set the page size, throwing if it is not a valid one. */
+  void SetPageSize(size_t page_size);
+
   auto GetFileSize(const std::string &file_name) -> int;
-  // stream to write log file
-  std::fstream log_io_;
+
+  /**
+   * Write / read exactly size bytes at the given offset of a file, retrying short transfers.
+   * @return the number of bytes transferred, which is less than size only on error or, for reads, at the end of file
+   */
+  static auto PwriteFull(int fd, const char *data, size_t size, size_t offset) -> size_t;
+  static auto PreadFull(int fd, char *data, size_t size, size_t offset) -> size_t;
+
+  // file descriptor of the log file, opened for appending
+  int log_fd_{-1};
   std::string log_name_;
-  // stream to write db file
-  std::fstream db_io_;
+  // file descriptor of the db file
+  int db_fd_{-1};
   std::string file_name_;
+  size_t page_size_{BUSTUB_PAGE_SIZE};
   int num_flushes_{0};
-  int num_writes_{0};
+  std::atomic<int> num_writes_{0};
+  std::atomic<int> num_syncs_{0};
   bool flush_log_{false};
   std::future<void> *flush_log_f_{nullptr};
-  // With multiple buffer pool instances, need to protect file access
+  // Page I/O needs no latch; subclasses use it to protect the metadata of the file, such as a page map
   std::mutex db_io_latch_;
+
+ private:
+  /** Group flush state of SyncPages(). A sync with a larger number started after one with a smaller number. */
+  std::mutex sync_latch_;
+  std::condition_variable sync_cv_;
+  uint64_t syncs_started_{0};
+  uint64_t syncs_completed_{0};
+  bool sync_in_progress_{false};
 };
 
 }  // namespace bustub
@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_compressed.h
+//
+// Identification: src/include/storage/disk/disk_manager_compressed.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * DiskManagerCompressed stores every page of the database file compressed (see CompressionUtil), so that reading and
+ * writing a page moves fewer bytes to and from disk. Pages are only compressed on their way to disk; callers always
+ * see them uncompressed.
+ *
+ * A compressed page occupies a run of COMPRESSED_PAGE_GRANULE-byte granules of the database file. The page map
+ * records, for every page, where its run starts, how many granules it spans and the compressed length. A page that
+ * does not get smaller is stored as it is. Every write of a page goes to a fresh run, taken from the free runs or from
+ * the end of the file, so the runs the saved page map points at are never overwritten. The runs a page leaves behind
+ * are reused by writes after the next save of the page map, but adjacent free runs are not merged.
+ *
+ * The page map lives in memory and is saved to a file next to the database file (`<db>.pmap`) by SyncPages()
+ * (and so by ShutDown()) and on destruction, and it also records the page size of the database. The log file is
+ * handled by the DiskManager base class as usual.
+ *
+ * The latch only guards the page map and the free runs; reads and writes of the database file, and the saves of the
+ * page map, run without it. A run that is being read is not reused until the read is done.
+ *
+ * With a buffer pool on top, pages are read and written by the DiskScheduler's worker threads, so compression and
+ * decompression never run on the threads that fetch the pages.
+ */
+class DiskManagerCompressed : public DiskManager {
+ public:
+  /** The unit of space of the database file. */
+  static constexpr size_t COMPRESSED_PAGE_GRANULE = 512;
+
+  /**
+   * Creates a new disk manager that writes compressed pages to the specified database file.
+   * @param db_file the file name of the database file to write to
+   * @param page_size the page size of a new database file. An existing one keeps the page size recorded in its page
+   * map.
+   */
+  explicit DiskManagerCompressed(const std::string &db_file, size_t page_size = BUSTUB_PAGE_SIZE);
+
+  /** Saves the page map. */
+  ~DiskManagerCompressed() override;
+
+  /** Make the written pages durable, then save the page map. */
+  void SyncPages() override;
+
+  /**
+   * Compress a page and write it to the database file.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   */
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  /**
+   * Read a page from the database file and decompress it. Pages that were never written read as zeroes.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /** Make the runs the page map points at durable, then write the page map to its file, replacing the previous one. */
+  void SavePageMap();
+
+  /** @return the number of bytes of the database file in use or free for reuse, i.e. its length */
+  auto GetFileBytes() -> uint64_t;
+
+  /** @return the sum of the compressed lengths of all pages */
+  auto GetCompressedBytes() -> uint64_t;
+
+ private:
+  /** Where a page is stored. A page that was never written has no granules. */
+  struct PageExtent {
+    uint64_t offset_{0};
+    uint32_t length_{0};
+    uint32_t granules_{0};
+  };
+  static_assert(sizeof(PageExtent) == 16, "the page map file stores extents as they are in memory");
+
+  /** Tells a page map file apart from anything else. */
+  static constexpr uint32_t PAGE_MAP_MAGIC = 0x42545043;
+
+  /** Read the page map file, if there is one, and rebuild the list of free runs from it. */
+  void LoadPageMap();
+
+  /** Durably replace the page map file with the given contents. @return false on an I/O error */
+  auto WritePageMapFile(const std::vector<char> &buffer) -> bool;
+
+  /** Drop a reader of the run at the given offset, freeing the run if it was only kept for its readers. Caller holds
+   * db_io_latch_. */
+  void ReleaseRun(uint64_t offset);
+
+  /** Take a run of the given number of granules, reusing a free run if possible. Caller holds db_io_latch_. */
+  auto AllocateGranules(uint32_t granules) -> uint64_t;
+
+  std::string page_map_name_;
+  /** Serializes the saves of the page map, so that an older map never replaces a newer one. */
+  std::mutex save_latch_;
+  /** The page map, indexed by page id. Protected by db_io_latch_. */
+  std::vector<PageExtent> page_map_;
+  /** Free runs by their number of granules. Protected by db_io_latch_. */
+  std::multimap<uint32_t, uint64_t> free_runs_;
+  /** Runs freed since the page map was last saved, which it may still point at. Protected by db_io_latch_. */
+  std::vector<std::pair<uint32_t, uint64_t>> pending_free_runs_;
+  /** The number of reads in progress on each run, by offset. Protected by db_io_latch_. */
+  std::map<uint64_t, uint32_t> run_readers_;
+  /** Runs that are free but still being read, by offset. Protected by db_io_latch_. */
+  std::map<uint64_t, uint32_t> retired_runs_;
+  /** The length of the database file. Protected by db_io_latch_. */
+  uint64_t end_offset_{0};
+  /** True if the page map changed since it was last saved. Protected by db_io_latch_. */
+  bool page_map_dirty_{false};
+};
+
+}  // namespace bustub
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 #include <array>
+#include <chrono>  // NOLINT
 #include <cstring>
 #include <fstream>
 #include <future>  // NOLINT
@@ -35,7 +36,7 @@ namespace bustub {
  */
 class DiskManagerMemory : public DiskManager {
  public:
-  explicit DiskManagerMemory(size_t pages);
+  explicit DiskManagerMemory(size_t pages, size_t page_size = BUSTUB_PAGE_SIZE);
 
   ~DiskManagerMemory() override { delete[] memory_; }
 
@@ -58,71 +59,108 @@ class DiskManagerMemory : public DiskManager {
 };
 
 /**
- * DiskManagerMemory replicates the utility of DiskManager on memory. It is primarily used for
- * data structure performance testing.
+ * IoLatency describes the latency that DiskManagerUnlimitedMemory adds to every page I/O, so that benchmarks can stand
+ * in for a real device: a fixed latency, a latency uniformly distributed over a range, or a heavy-tailed (Pareto)
+ * latency, where most I/Os take about the minimum and a few take far longer, as on a busy SSD.
+ */
+class IoLatency {
+ public:
+  enum class Distribution { None, Fixed, Uniform, HeavyTailed };
+
+  /** No latency at all. */
+  IoLatency() = default;
+
+  /** Every I/O takes the given time. */
+  static auto Fixed(std::chrono::nanoseconds latency) -> IoLatency;
+
+  /** I/Os take between min and max, uniformly distributed. */
+  static auto Uniform(std::chrono::nanoseconds min, std::chrono::nanoseconds max) -> IoLatency;
+
+  /**
+   * I/Os take at least min, following a Pareto distribution of the given shape and capped at max. The smaller the
+   * shape, the heavier the tail; with a shape above 1 the mean is min * shape / (shape - 1).
+   */
+  static auto HeavyTailed(std::chrono::nanoseconds min, double shape, std::chrono::nanoseconds max) -> IoLatency;
+
+  /** @return a latency drawn from the distribution, using a random generator of the calling thread */
+  auto Sample() const -> std::chrono::nanoseconds;
+
+  /**
+   * Wait for a latency drawn from the distribution. Sleeping overshoots short waits by tens of microseconds, so
+   * those are spun instead.
+   */
+  void Wait() const;
+
+  auto GetDistribution() const -> Distribution { return distribution_; }
+
+ private:
+  Distribution distribution_{Distribution::None};
+  std::chrono::nanoseconds min_{0};
+  std::chrono::nanoseconds max_{0};
+  double shape_{0};
+};
+
+/**
+ * DiskManagerUnlimitedMemory replicates the utility of DiskManager on memory, growing as pages are written. It is
+ * primarily used for data structure performance testing.
+ *
+ * Pages live in a directory of NUM_SHARDS shards, each with its own reader-writer latch that is only taken exclusively
+ * to add a page, and every page has a latch of its own. Pages are never freed, so a page found in the directory may
+ * be copied after the shard latch is released. Concurrent I/O to different pages therefore hardly ever contends.
  */
 class DiskManagerUnlimitedMemory : public DiskManager {
  public:
-  DiskManagerUnlimitedMemory() = default;
+  /** The number of shards of the page directory. */
+  static constexpr size_t NUM_SHARDS = 16;
+
+  explicit DiskManagerUnlimitedMemory(size_t page_size = BUSTUB_PAGE_SIZE) { SetPageSize(page_size); }
 
   /**
    * Write a page to the database file.
    * @param page_id id of the page
    * @param page_data raw page data
    */
-  void WritePage(page_id_t page_id, const char *page_data) override {
-    if (latency_ > 0) {
-      std::this_thread::sleep_for(std::chrono::milliseconds(latency_));
-    }
-
-    std::unique_lock<std::mutex> l(mutex_);
-    if (page_id >= static_cast<int>(data_.size())) {
-      data_.resize(page_id + 1);
-    }
-    if (data_[page_id] == nullptr) {
-      data_[page_id] = std::make_shared<ProtectedPage>();
-    }
-    std::shared_ptr<ProtectedPage> ptr = data_[page_id];
-    std::unique_lock<std::shared_mutex> l_page(ptr->second);
-    l.unlock();
-
-    memcpy(ptr->first.data(), page_data, BUSTUB_PAGE_SIZE);
-  }
+  void WritePage(page_id_t page_id, const char *page_data) override;
 
   /**
    * Read a page from the database file.
    * @param page_id id of the page
    * @param[out] page_data output buffer
    */
-  void ReadPage(page_id_t page_id, char *page_data) override {
-    if (latency_ > 0) {
-      std::this_thread::sleep_for(std::chrono::milliseconds(latency_));
-    }
-
-    std::unique_lock<std::mutex> l(mutex_);
-    if (page_id >= static_cast<int>(data_.size()) || page_id < 0) {
-      LOG_WARN("page not exist");
-      return;
-    }
-    if (data_[page_id] == nullptr) {
-      LOG_WARN("page not exist");
-      return;
-    }
-    std::shared_ptr<ProtectedPage> ptr = data_[page_id];
-    std::shared_lock<std::shared_mutex> l_page(ptr->second);
-    l.unlock();
-
-    memcpy(page_data, ptr->first.data(), BUSTUB_PAGE_SIZE);
-  }
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /** Add a fixed latency of the given number of milliseconds to every read and write. */
+  void SetLatency(size_t latency_ms) { SetLatency(IoLatency::Fixed(std::chrono::milliseconds(latency_ms))); }
 
-  void SetLatency(size_t latency_ms) { latency_ = latency_ms; }
+  /**
+   * Set the latency of reads and writes. Not synchronized with I/O in progress, so set it before the disk manager is
+   * shared between threads or while they are quiescent.
+   */
+  void SetLatency(const IoLatency &latency) { SetLatency(latency, latency); }
+  void SetLatency(const IoLatency &read_latency, const IoLatency &write_latency) {
+    read_latency_ = read_latency;
+    write_latency_ = write_latency;
+  }
 
  private:
-  std::mutex mutex_;
-  using Page = std::array<char, BUSTUB_PAGE_SIZE>;
-  using ProtectedPage = std::pair<Page, std::shared_mutex>;
-  std::vector<std::shared_ptr<ProtectedPage>> data_;
-  size_t latency_{0};
+  struct ProtectedPage {
+    explicit ProtectedPage(size_t page_size) : data_(page_size) {}
+    std::vector<char> data_;
+    std::shared_mutex latch_;
+  };
+
+  struct Shard {
+    std::shared_mutex latch_;
+    /** The pages of the shard, by page id / NUM_SHARDS. */
+    std::vector<std::unique_ptr<ProtectedPage>> pages_;
+  };
+
+  /** @return the page with the given id, creating it if asked to, or nullptr if it does not exist */
+  auto GetPage(page_id_t page_id, bool create) -> ProtectedPage *;
+
+  std::array<Shard, NUM_SHARDS> shards_;
+  IoLatency read_latency_;
+  IoLatency write_latency_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_uring.h
+//
+// Identification: src/include/storage/disk/disk_manager_uring.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * DiskManagerUring performs page I/O on the database file with io_uring. The file is opened with O_DIRECT where
+ * the file system supports it, bypassing the OS page cache.
+ *
+ * Instead of one stream behind one latch, the disk manager keeps several submission rings, each with its own latch
+ * and a set of page-aligned bounce buffers, so that as many I/Os as there are rings can be in flight at once. Caller
+ * buffers that are already page aligned are handed to the kernel directly; others are copied through a bounce
+ * buffer.
+ *
+ * The rings are set up with the io_uring system calls directly, without liburing. When BusTub is built without
+ * io_uring (see the BUSTUB_USE_IO_URING CMake option, on by default on Linux), or the kernel refuses to set up a ring,
+ * the same interface is served with positional pread / pwrite calls.
+ *
+ * Like DiskManager, a page that cannot be read reads as zeroes, and a write that fails is logged. A short write is
+ * retried. A ring that fails as a whole throws, and the DiskScheduler hands that exception to the issuer.
+ *
+ * The log file is still handled by the DiskManager base class.
+ */
+class DiskManagerUring : public DiskManager {
+ public:
+  /** A single page read or write of a batch. */
+  struct PageIo {
+    /** Flag indicating whether the I/O is a write or a read. */
+    bool is_write_;
+    /** ID of the page being read from / written to disk. */
+    page_id_t page_id_;
+    /** The page data to write, or the buffer to read the page into. */
+    char *data_;
+  };
+
+  /**
+   * Creates a new io_uring disk manager that writes to the specified database file.
+   * @param db_file the file name of the database file to write to
+   * @param num_rings the number of independent submission rings, i.e. the number of concurrent callers served at once
+   * @param queue_depth the number of entries of each ring, i.e. the number of I/Os one batch submission keeps in flight
+   * @param page_size the page size of a new database file, see DiskManager::DiskManager
+   */
+  explicit DiskManagerUring(const std::string &db_file, size_t num_rings = 8, size_t queue_depth = 32,
+                            size_t page_size = BUSTUB_PAGE_SIZE);
+
+  ~DiskManagerUring() override;
+
+  /**
+   * Write a page to the database file.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   */
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  /**
+   * Read a page from the database file.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /**
+   * Submit a batch of page reads and writes with a single system call per queue_depth entries, and wait for all of
+   * them to complete. The I/Os of one batch may complete in any order, so a batch must not touch the same page twice.
+   * @param batch the I/Os to perform
+   */
+  void SubmitBatch(const std::vector<PageIo> &batch);
+
+  /** @return true if I/O goes through io_uring, false if it falls back to pread / pwrite */
+  auto IsUsingIoUring() const -> bool { return use_io_uring_; }
+
+  /** @return true if the database file is opened with O_DIRECT */
+  auto IsDirectIo() const -> bool { return direct_io_; }
+
+ private:
+  /** A submission ring together with its latch and bounce buffers. Defined in the source file. */
+  struct Ring;
+
+  /** @return a ring that is locked for the caller, preferring one that nobody else is using */
+  auto AcquireRing() -> std::pair<Ring *, std::unique_lock<std::mutex>>;
+
+  /** Perform at most queue_depth_ I/Os on a locked ring and wait for them to complete. */
+  void SubmitOnRing(Ring *ring, const PageIo *ios, size_t count);
+
+  /** File descriptor of the database file. */
+  int fd_{-1};
+  /** True if fd_ was opened with O_DIRECT. */
+  bool direct_io_{false};
+  /** True if the rings are backed by io_uring. */
+  bool use_io_uring_{false};
+  /** The number of entries of each ring. */
+  size_t queue_depth_;
+  /** The rings. */
+  std::vector<std::unique_ptr<Ring>> rings_;
+  /** The ring to try first in the next AcquireRing call. */
+  std::atomic<size_t> next_ring_{0};
+};
+
+}  // namespace bustub
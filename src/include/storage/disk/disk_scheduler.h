@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler.h
+//
+// Identification: src/include/storage/disk/disk_scheduler.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <future>  // NOLINT
+#include <optional>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/channel.h"
+#include "common/config.h"
+#include "common/macros.h"
+#include "common/metrics.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * @brief Represents a Write or Read request for the DiskManager to execute.
+ */
+struct DiskRequest {
+  /** Flag indicating whether the request is a write or a read. */
+  bool is_write_;
+
+  /**
+   *  Pointer to the start of the memory location where a page is either:
+   *   1. being read into from disk (on a read).
+   *   2. being written out to disk (on a write).
+   */
+  char *data_;
+
+  /** ID of the page being read from / written to disk. */
+  page_id_t page_id_;
+
+  /** Callback used to signal to the request issuer when the request has been completed. */
+  std::promise<bool> callback_;
+
+  /**
+   * Optional function run by the worker thread once the I/O has completed, before the promise is fulfilled, with
+   * whether it succeeded. Lets fire-and-forget issuers (e.g. read-ahead) publish the result without a thread of their
+   * own waiting on it.
+   */
+  std::function<void(bool)> on_complete_{};
+};
+
+/**
+ * @brief The DiskScheduler schedules disk read and write operations.
+ *
+ * A request is scheduled by calling DiskScheduler::Schedule() with an appropriate DiskRequest object. A pool of
+ * background worker threads takes requests off a shared queue and hands them to the disk manager, so several
+ * requests can be in flight at once. The issuer learns about completion through the request's promise, which holds
+ * the exception if the disk manager threw one. The scheduler does not order requests for the same page; callers must
+ * not issue a request that conflicts with one that has not completed yet.
+ */
+class DiskScheduler {
+ public:
+  /**
+   * @brief Creates a new DiskScheduler and starts its worker threads.
+   * @param disk_manager the disk manager that executes the requests
+   * @param num_workers the number of background threads serving requests
+   */
+  explicit DiskScheduler(DiskManager *disk_manager, size_t num_workers = DISK_SCHEDULER_NUM_WORKERS);
+
+  /** @brief Stops the worker threads once every scheduled request has been served. */
+  ~DiskScheduler();
+
+  DISALLOW_COPY_AND_MOVE(DiskScheduler);
+
+  /**
+   * @brief Schedules a request for the DiskManager to execute.
+   *
+   * @param r The request to be scheduled.
+   */
+  void Schedule(DiskRequest r);
+
+  /**
+   * @brief Schedules a batch of requests, enqueueing them all at once so that the workers can serve them in
+   * parallel.
+   *
+   * @param requests The requests to be scheduled.
+   */
+  void Schedule(std::vector<DiskRequest> requests);
+
+  using DiskSchedulerPromise = std::promise<bool>;
+
+  /**
+   * @brief Create a Promise object. If you want to implement your own version of promise, you can change this
+   * function so that our test cases can use your promise implementation.
+   *
+   * @return std::promise<bool>
+   */
+  auto CreatePromise() -> DiskSchedulerPromise { return {}; };
+
+  /** @return the time the disk manager took to serve each read, not counting the time spent in the queue */
+  auto GetReadLatency() -> LatencyHistogram & { return read_latency_; }
+
+  /** @return the time the disk manager took to serve each write, not counting the time spent in the queue */
+  auto GetWriteLatency() -> LatencyHistogram & { return write_latency_; }
+
+ private:
+  /**
+   * @brief Worker loop that processes scheduled requests until it dequeues std::nullopt.
+   */
+  void StartWorkerThread();
+
+  /** Pointer to the disk manager. */
+  DiskManager *disk_manager_;
+  /** A shared queue to concurrently schedule and process requests. When the DiskScheduler's destructor is called,
+   * one `std::nullopt` per worker is put into the queue to signal the workers to stop execution. */
+  Channel<std::optional<DiskRequest>> request_queue_;
+  /** The background threads responsible for issuing scheduled requests to the disk manager. */
+  std::vector<std::thread> background_threads_;
+  LatencyHistogram read_latency_;
+  LatencyHistogram write_latency_;
+};
+
+}  // namespace bustub
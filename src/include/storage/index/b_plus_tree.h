@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <deque>
+#include <fstream>
 #include <iostream>
 #include <optional>
 #include <queue>
@@ -24,8 +25,7 @@
 #include "concurrency/transaction.h"
 #include "storage/index/index_iterator.h"
 #include "storage/page/b_plus_tree_header_page.h"
-#include "storage/page/b_plus_tree_internal_page.h"
-#include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/b_plus_tree_page_types.h"
 #include "storage/page/page_guard.h"
 
 namespace bustub {
@@ -35,46 +35,72 @@ struct PrintableBPlusTree;
 /**
  * @brief Definition of the Context class.
  *
- * Hint: This class is designed to help you keep track of the pages
- * that you're modifying or accessing.
+ * The pages latched by the pessimistic path of an insert or remove, which write-latches from the header page down and
+ * lets go of everything above a page that the operation cannot split or merge. The optimistic path does not need it.
  */
 class Context {
  public:
-  // When you insert into / remove from the B+ tree, store the write guard of header page here.
-  // Remember to drop the header page guard and set it to nullopt when you want to unlock all.
+  // The write guard of the header page, held as long as the operation may change the root.
   std::optional<WritePageGuard> header_page_{std::nullopt};
 
   // Save the root page id here so that it's easier to know if the current page is the root page.
   page_id_t root_page_id_{INVALID_PAGE_ID};
 
-  // Store the write guards of the pages that you're modifying here.
+  // The write guards of the pages that the operation may still modify, from the top down.
   std::deque<WritePageGuard> write_set_;
 
   // You may want to use this when getting value, but not necessary.
   std::deque<ReadPageGuard> read_set_;
 
   auto IsRootPage(page_id_t page_id) -> bool { return page_id == root_page_id_; }
+
+  // Unlatch the header page and all pages above the last one in write_set_.
+  void ReleaseAncestors() {
+    header_page_ = std::nullopt;
+    while (write_set_.size() > 1) {
+      write_set_.pop_front();
+    }
+  }
 };
 
 #define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
 
-// Main class providing the API for the Interactive B+ Tree.
+/**
+ * Main class providing the API for the Interactive B+ Tree.
+ *
+ * Readers walk down the internal pages with optimistic reads (see OptimisticReadGuard), which neither pin nor latch
+ * them, and read-latch only the leaf; if the parent of the leaf changed in the meantime they start over, and after a
+ * few failed attempts they crab down with read latches instead. Writers first try the optimistic path: descend the
+ * same way and write-latch only the leaf. That is enough unless the leaf splits or merges, in which case the writer
+ * lets go and starts over on the pessimistic path, which write-latches from the header page down (see Context). Since
+ * most inserts and removes leave the shape of the tree alone, writers rarely latch the header or the root exclusively.
+ *
+ * Latches are taken top-down, and leaves left to right, so that writers, readers and iterators cannot deadlock.
+ *
+ * The pages store keys as BPlusTreePageTypes picks for the key type, and decide when they split and merge themselves:
+ * by the number of entries for fixed-size keys, by the bytes in use for normalized keys. The max sizes are in the same
+ * unit.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
-  using InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>;
-  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+  using InternalPage = typename BPlusTreePageTypes<KeyType, ValueType, KeyComparator>::InternalPage;
+  using LeafPage = typename BPlusTreePageTypes<KeyType, ValueType, KeyComparator>::LeafPage;
 
  public:
   explicit BPlusTree(std::string name, page_id_t header_page_id, BufferPoolManager *buffer_pool_manager,
-                     const KeyComparator &comparator, int leaf_max_size = LEAF_PAGE_SIZE,
-                     int internal_max_size = INTERNAL_PAGE_SIZE);
+                     const KeyComparator &comparator, int leaf_max_size = LeafPage::MaxSizeForPage(BUSTUB_PAGE_SIZE),
+                     int internal_max_size = InternalPage::MaxSizeForPage(BUSTUB_PAGE_SIZE));
 
   // Returns true if this B+ tree has no keys and values.
   auto IsEmpty() const -> bool;
 
-  // Insert a key-value pair into this B+ tree.
+  // Insert a key-value pair into this B+ tree. Throws if the key is too long for the pages.
   auto Insert(const KeyType &key, const ValueType &value, Transaction *txn = nullptr) -> bool;
 
+  // Build this B+ tree bottom-up from entries, in any order, keeping the first of equal keys. Leaves and internal pages
+  // are packed to fill_factor of their max size. If the tree is not empty, the entries are inserted one by one instead.
+  void BulkLoad(std::vector<MappingType> entries, double fill_factor = BULK_LOAD_FILL_FACTOR);
+
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *txn);
 
@@ -116,6 +142,9 @@ class BPlusTree {
   // read data from file and remove one by one
   void RemoveFromFile(const std::string &file_name, Transaction *txn = nullptr);
 
+  // Give the unused pages of the tree's extent back to the buffer pool, e.g. when the index is dropped.
+  void ReleaseExtent();
+
  private:
   /* Debug Routines for FREE!! */
   void ToGraph(page_id_t page_id, const BPlusTreePage *page, std::ofstream &out);
@@ -130,6 +159,46 @@ class BPlusTree {
    */
   auto ToPrintableBPlusTree(page_id_t root_id) -> PrintableBPlusTree;
 
+  enum class Operation { INSERT, REMOVE };
+
+  // Whether op leaves page without splitting or merging it, so that the latches above it are not needed.
+  auto IsSafe(const BPlusTreePage *page, Operation op, bool is_root) const -> bool;
+
+  // Walk down to the leaf that covers key (or the leftmost leaf if key is nullptr) with optimistic reads only, copying
+  // each internal page into buffer to look it up. On success, leaf_page_id is the leaf (INVALID_PAGE_ID if the tree is
+  // empty) and parent_guard is on the page that points at it. False if a writer got in the way.
+  auto DescendOptimistic(const KeyType *key, char *buffer, page_id_t *leaf_page_id, OptimisticReadGuard *parent_guard,
+                         bool *is_root) -> bool;
+
+  // Read-latch the leaf that covers key (or the leftmost leaf if key is nullptr). Invalid if tree is empty. The
+  // internal pages are read optimistically, with a fallback to read-latch crabbing under contention.
+  auto FindLeafRead(const KeyType *key) -> ReadPageGuard;
+
+  // The optimistic descent: read the internal pages down to the leaf that covers key optimistically (or read-latch
+  // them under contention), and write-latch only the leaf. Invalid if the tree is empty.
+  auto FindLeafOptimistic(const KeyType &key, bool *is_root) -> WritePageGuard;
+
+  // The pessimistic descent: write-latch from the header page down to the leaf that covers key into ctx, keeping only
+  // the latches that op may need.
+  void FindLeafPessimistic(const KeyType &key, Operation op, Context &ctx);
+
+  // Link the new page right_id, split from left_id, into the parent of left_id, splitting the parent if it is full.
+  void InsertIntoParent(Context &ctx, const KeyType &key, page_id_t left_id, page_id_t right_id);
+
+  // Fix up the last page in ctx.write_set_ after an entry was removed from it, merging it with or borrowing from a
+  // sibling if it is too small and shrinking the tree if the root is left with nothing to separate.
+  void HandleUnderflow(Context &ctx);
+
+  // Merge the siblings left and right if they fit in one page, otherwise move entries over to the one that underflowed
+  // (left if borrow_into_left) until it is large enough, as long as the parent has room for the new separator and the
+  // pages for the moved entry. right_index is the index of right in parent. Returns true if they were merged and right
+  // was deleted.
+  auto MergeOrBorrow(WritePageGuard &left, WritePageGuard &right, InternalPage *parent, int right_index,
+                     bool borrow_into_left) -> bool;
+
+  // Throw if key does not fit into the pages of this tree.
+  void CheckKeyFits(const KeyType &key) const;
+
   // member variable
   std::string index_name_;
   BufferPoolManager *bpm_;
@@ -138,6 +207,8 @@ class BPlusTree {
   int leaf_max_size_;
   int internal_max_size_;
   page_id_t header_page_id_;
+  // Where new tree pages come from (NewPageInExtentGuarded), so that the leaves lie next to each other on disk.
+  Extent extent_;
 };
 
 /**
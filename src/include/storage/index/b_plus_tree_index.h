@@ -29,12 +29,17 @@ class BPlusTreeIndex : public Index {
  public:
   BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager);
 
+  ~BPlusTreeIndex() override;
+
   auto InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool override;
 
   void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  // Fill the index with entries at once, see BPlusTree::BulkLoad().
+  void BulkLoad(std::vector<MappingType> entries);
+
   auto GetBeginIterator() -> INDEXITERATOR_TYPE;
 
   auto GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE;
@@ -59,4 +64,12 @@ using BPlusTreeIndexIteratorForTwoIntegerColumn =
     IndexIterator<IntegerKeyType, IntegerValueType, IntegerComparatorType>;
 using IntegerHashFunctionType = HashFunction<IntegerKeyType>;
 
+/** Index over keys of any types and length, stored as normalized keys in slotted pages. */
+using BPlusTreeIndexForNormalizedKey = BPlusTreeIndex<NormalizedKey, RID, NormalizedComparator>;
+using BPlusTreeIndexIteratorForNormalizedKey = IndexIterator<NormalizedKey, RID, NormalizedComparator>;
+
+/** Index over one integer column, stored in separate key and value arrays that are searched with SIMD. */
+using BPlusTreeIndexForBigInt = BPlusTreeIndex<IntegerKey, RID, IntegerComparator>;
+using BPlusTreeIndexIteratorForBigInt = IndexIterator<IntegerKey, RID, IntegerComparator>;
+
 }  // namespace bustub
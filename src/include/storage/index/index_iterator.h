@@ -13,17 +13,28 @@
  * For range scan of b+ tree
  */
 #pragma once
-#include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/b_plus_tree_page_types.h"
+#include "storage/page/page_guard.h"
 
 namespace bustub {
 
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
 
+/**
+ * Walks the leaves of a B+ tree from left to right. The iterator keeps the current leaf read-latched, and latches the
+ * next leaf before it lets go of the current one, so that a concurrent merge cannot pull the next leaf away under it.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
+  using LeafPage = typename BPlusTreePageTypes<KeyType, ValueType, KeyComparator>::LeafPage;
+
  public:
-  // you may define your own constructor based on your member variables
+  // The end iterator.
   IndexIterator();
+  // An iterator at entry index of the leaf held by guard, moved on to the next leaf if index is past its end.
+  IndexIterator(BufferPoolManager *bpm, ReadPageGuard guard, int index);
+  IndexIterator(IndexIterator &&that) noexcept = default;
+  auto operator=(IndexIterator &&that) noexcept -> IndexIterator & = default;
   ~IndexIterator();  // NOLINT
 
   auto IsEnd() -> bool;
@@ -32,12 +43,21 @@ class IndexIterator {
 
   auto operator++() -> IndexIterator &;
 
-  auto operator==(const IndexIterator &itr) const -> bool { throw std::runtime_error("unimplemented"); }
+  auto operator==(const IndexIterator &itr) const -> bool { return page_id_ == itr.page_id_ && index_ == itr.index_; }
 
-  auto operator!=(const IndexIterator &itr) const -> bool { throw std::runtime_error("unimplemented"); }
+  auto operator!=(const IndexIterator &itr) const -> bool { return !(*this == itr); }
 
  private:
-  // add your own private member variables here
+  // Move on to the first entry of the next non-empty leaf if index_ is past the end of the current one, and copy the
+  // entry out.
+  void SkipExhaustedLeaves();
+
+  BufferPoolManager *bpm_{nullptr};
+  ReadPageGuard guard_;
+  page_id_t page_id_{INVALID_PAGE_ID};
+  int index_{0};
+  // A copy of the current entry, since slotted leaves do not store key/value pairs.
+  MappingType item_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// integer_key.h
+//
+// Identification: src/include/storage/index/integer_key.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * Integer key is used for indexing a single integer column as a signed 64-bit integer.
+ *
+ * Unlike GenericKey<8>, whose bytes can hold any key tuple and are ordered by the key schema, this key is known to be
+ * a number. B+ trees keep these keys in a page layout of their own that searches them with SIMD instructions, see
+ * BPlusTreeIntegerLeafPage.
+ */
+class IntegerKey {
+ public:
+  inline void SetFromKey(const Tuple &tuple, const Schema &key_schema) {
+    key_ = tuple.GetValue(&key_schema, 0).CastAs(TypeId::BIGINT).GetAs<int64_t>();
+  }
+
+  inline void SetFromInteger(int64_t key) { key_ = key; }
+
+  inline auto GetInteger() const -> int64_t { return key_; }
+
+  // NOTE: for test purpose only
+  inline auto ToString() const -> int64_t { return key_; }
+
+  // NOTE: for test purpose only
+  friend auto operator<<(std::ostream &os, const IntegerKey &key) -> std::ostream & {
+    os << key.key_;
+    return os;
+  }
+
+ private:
+  int64_t key_;
+};
+
+/**
+ * Function object that orders integer keys by their number.
+ */
+class IntegerComparator {
+ public:
+  inline auto operator()(const IntegerKey &lhs, const IntegerKey &rhs) const -> int {
+    return (lhs.GetInteger() > rhs.GetInteger()) - (lhs.GetInteger() < rhs.GetInteger());
+  }
+
+  IntegerComparator(const IntegerComparator &other) = default;
+
+  // constructor, the key schema is not needed to compare integer keys
+  explicit IntegerComparator(Schema * /* key_schema */) {}
+};
+
+}  // namespace bustub
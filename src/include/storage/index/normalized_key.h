@@ -0,0 +1,170 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// normalized_key.h
+//
+// Identification: src/include/storage/index/normalized_key.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <string>
+
+#include "common/exception.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * Normalized key is used for indexing with keys of any length.
+ *
+ * The key tuple is encoded into a byte string whose memcmp order is the order of the key tuples, so that comparing
+ * two keys never decodes a Value. The columns follow each other, each behind a marker byte that puts NULL first.
+ * Integers and timestamps are stored big-endian with the sign bit flipped, decimals with their IEEE 754 bits flipped
+ * so that negative numbers sort first, and varchars with their zero bytes escaped and a terminator, so that a string
+ * sorts before the longer strings it is a prefix of.
+ *
+ * B+ trees keep these keys in slotted pages, see BPlusTreeSlottedLeafPage.
+ */
+class NormalizedKey {
+ public:
+  inline void SetFromKey(const Tuple &tuple, const Schema &key_schema) {
+    data_.clear();
+    for (uint32_t i = 0; i < key_schema.GetColumnCount(); i++) {
+      AppendValue(tuple.GetValue(&key_schema, i));
+    }
+  }
+
+  // NOTE: for test purpose only
+  // encode key as a single BIGINT column
+  inline void SetFromInteger(int64_t key) {
+    data_.clear();
+    AppendValue(Value(TypeId::BIGINT, key));
+  }
+
+  inline void SetFromBytes(const char *data, size_t size) { data_.assign(data, size); }
+
+  inline auto GetData() const -> const char * { return data_.data(); }
+
+  inline auto GetSize() const -> size_t { return data_.size(); }
+
+  // NOTE: for test purpose only
+  // decode a key made by SetFromInteger, or the least such key a separator cut short stands for
+  inline auto ToString() const -> int64_t {
+    uint64_t bits = 0;
+    for (size_t i = 1; i <= sizeof(uint64_t); i++) {
+      bits = (bits << 8) | (i < data_.size() ? static_cast<uint8_t>(data_[i]) : 0);
+    }
+    return static_cast<int64_t>(bits ^ SIGN_BIT_64);
+  }
+
+  // NOTE: for test purpose only
+  // print the bytes in hex
+  friend auto operator<<(std::ostream &os, const NormalizedKey &key) -> std::ostream & {
+    auto flags = os.flags();
+    for (char c : key.data_) {
+      os << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(static_cast<uint8_t>(c));
+    }
+    os.flags(flags);
+    return os;
+  }
+
+ private:
+  static constexpr uint64_t SIGN_BIT_64 = uint64_t{1} << 63;
+  static constexpr char NULL_MARKER = 0;
+  static constexpr char VALUE_MARKER = 1;
+
+  inline void AppendBigEndian(uint64_t bits, size_t size) {
+    for (size_t i = size; i > 0; i--) {
+      data_.push_back(static_cast<char>(bits >> ((i - 1) * 8)));
+    }
+  }
+
+  inline void AppendSigned(int64_t value, size_t size) {
+    AppendBigEndian(static_cast<uint64_t>(value) ^ (uint64_t{1} << (size * 8 - 1)), size);
+  }
+
+  inline void AppendValue(const Value &value) {
+    if (value.IsNull()) {
+      data_.push_back(NULL_MARKER);
+      return;
+    }
+    data_.push_back(VALUE_MARKER);
+    switch (value.GetTypeId()) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        AppendSigned(value.GetAs<int8_t>(), sizeof(int8_t));
+        break;
+      case TypeId::SMALLINT:
+        AppendSigned(value.GetAs<int16_t>(), sizeof(int16_t));
+        break;
+      case TypeId::INTEGER:
+        AppendSigned(value.GetAs<int32_t>(), sizeof(int32_t));
+        break;
+      case TypeId::BIGINT:
+        AppendSigned(value.GetAs<int64_t>(), sizeof(int64_t));
+        break;
+      case TypeId::TIMESTAMP:
+        AppendBigEndian(value.GetAs<uint64_t>(), sizeof(uint64_t));
+        break;
+      case TypeId::DECIMAL: {
+        double number = value.GetAs<double>();
+        uint64_t bits;
+        memcpy(&bits, &number, sizeof(bits));
+        AppendBigEndian((bits & SIGN_BIT_64) != 0 ? ~bits : bits | SIGN_BIT_64, sizeof(uint64_t));
+        break;
+      }
+      case TypeId::VARCHAR: {
+        // The length includes the terminating zero of the stored string.
+        const char *str = value.GetData();
+        uint32_t len = value.GetLength() - 1;
+        for (uint32_t i = 0; i < len; i++) {
+          data_.push_back(str[i]);
+          if (str[i] == 0) {
+            data_.push_back(static_cast<char>(0xFF));
+          }
+        }
+        data_.push_back(0);
+        data_.push_back(0);
+        break;
+      }
+      default:
+        throw Exception(ExceptionType::UNKNOWN_TYPE, "cannot normalize the key column");
+    }
+  }
+
+  std::string data_;
+};
+
+/**
+ * Function object that orders normalized keys bytewise, like memcmp with the shorter key first on a tie.
+ */
+class NormalizedComparator {
+ public:
+  inline auto operator()(const NormalizedKey &lhs, const NormalizedKey &rhs) const -> int {
+    return Compare(lhs.GetData(), lhs.GetSize(), rhs.GetData(), rhs.GetSize());
+  }
+
+  static inline auto Compare(const char *lhs, size_t lhs_size, const char *rhs, size_t rhs_size) -> int {
+    int ret = memcmp(lhs, rhs, std::min(lhs_size, rhs_size));
+    if (ret != 0 || lhs_size == rhs_size) {
+      return ret;
+    }
+    return lhs_size < rhs_size ? -1 : 1;
+  }
+
+  NormalizedComparator(const NormalizedComparator &other) = default;
+
+  // constructor, the key schema is not needed to compare normalized keys
+  explicit NormalizedComparator(Schema * /* key_schema */) {}
+};
+
+}  // namespace bustub
@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/include/page/b_plus_tree_integer_internal_page.h
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <string>
+
+#include "storage/page/b_plus_tree_integer_page.h"
+
+namespace bustub {
+
+/**
+ * Internal page of a B+ tree over integer keys, storing n separator keys and n+1 child page ids in separate arrays
+ * (see BPlusTreeIntegerPage). It offers the same operations as BPlusTreeInternalPage, and splits and merges by the same
+ * number of children. The first key is invalid, as in BPlusTreeInternalPage.
+ */
+class BPlusTreeIntegerInternalPage : public BPlusTreeIntegerPage<page_id_t> {
+ public:
+  // Deleted to disallow initialization
+  BPlusTreeIntegerInternalPage() = delete;
+  BPlusTreeIntegerInternalPage(const BPlusTreeIntegerInternalPage &other) = delete;
+
+  /**
+   * Writes the necessary header information to a newly created page, must be called after
+   * the creation of a new page to make a valid BPlusTreeIntegerInternalPage
+   * @param max_size Maximal size of the page
+   */
+  void Init(int max_size = MaxSizeForPage(BUSTUB_PAGE_SIZE));
+
+  /**
+   * @param index The index of the key to set. Index must be non-zero.
+   * @param key The new value for key
+   */
+  void SetKeyAt(int index, const IntegerKey &key);
+
+  /**
+   * @param value the value to search for
+   */
+  auto ValueIndex(const page_id_t &value) const -> int;
+
+  /**
+   * @return the child whose subtree covers key
+   */
+  auto Lookup(const IntegerKey &key, const IntegerComparator &comparator) const -> page_id_t;
+
+  /**
+   * Make this empty page the root above old_value and new_value, separated by key.
+   */
+  void PopulateNewRoot(const page_id_t &old_value, const IntegerKey &key, const page_id_t &new_value);
+
+  /**
+   * Insert key & new_value right after old_value. The caller makes sure that the page has room for one more entry.
+   */
+  void InsertNodeAfter(const page_id_t &old_value, const IntegerKey &key, const page_id_t &new_value);
+
+  /**
+   * Insert key & new_value right after old_value into this page, which is full, and move the upper half of the
+   * children to the empty page recipient.
+   * @return the key that separates recipient from this page
+   */
+  auto InsertAndSplit(const page_id_t &old_value, const IntegerKey &key, const page_id_t &new_value,
+                      BPlusTreeIntegerInternalPage *recipient) -> IntegerKey;
+
+  /**
+   * Remove the key & value at index, shifting the later entries down.
+   */
+  void Remove(int index);
+
+  // Whether the page can take another child without splitting.
+  auto IsInsertSafe() const -> bool;
+  // Whether the page has room for another child with key.
+  auto HasRoomFor(const IntegerKey &key) const -> bool;
+  // Whether the page stays at least at its min size when a child is removed.
+  auto IsRemoveSafe() const -> bool;
+  auto IsUnderfull() const -> bool;
+  // Whether the children of this page and of right, its right sibling separated by middle_key, fit into one page.
+  auto CanMergeWith(const BPlusTreeIntegerInternalPage *right, const IntegerKey &middle_key) const -> bool;
+  // Keys have a fixed size, so any key at index can be replaced.
+  auto CanReplaceKey(int index, const IntegerKey &key) const -> bool { return true; }
+
+  // Whether key & value can be appended.
+  auto CanAppend(const IntegerKey &key) const -> bool;
+  // Append key & value, which come after all keys of the page. The key of the first entry is ignored.
+  void Append(const IntegerKey &key, const page_id_t &value);
+  // The share of the children the page can hold that it holds.
+  auto FillFactor() const -> double;
+
+  // Append all entries to recipient, the left sibling of this page. middle_key separates the two in the parent.
+  void MoveAllTo(BPlusTreeIntegerInternalPage *recipient, const IntegerKey &middle_key);
+  // Move the first child to the end of recipient, the left sibling of this page. Always succeeds.
+  auto MoveFirstToEndOf(BPlusTreeIntegerInternalPage *recipient, const IntegerKey &middle_key) -> bool;
+  // Move the last child to the front of recipient, the right sibling of this page. Always succeeds.
+  auto MoveLastToFrontOf(BPlusTreeIntegerInternalPage *recipient, const IntegerKey &middle_key) -> bool;
+
+  /**
+   * @brief For test only, return a string representing all keys in
+   * this internal page, formatted as "(key1,key2,key3,...)"
+   *
+   * @return std::string
+   */
+  auto ToString() const -> std::string {
+    std::string kstr = "(";
+    bool first = true;
+
+    // first key of internal page is always invalid
+    for (int i = 1; i < GetSize(); i++) {
+      IntegerKey key = KeyAt(i);
+      if (first) {
+        first = false;
+      } else {
+        kstr.append(",");
+      }
+
+      kstr.append(std::to_string(key.ToString()));
+    }
+    kstr.append(")");
+
+    return kstr;
+  }
+};
+}  // namespace bustub
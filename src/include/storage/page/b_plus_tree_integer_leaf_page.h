@@ -0,0 +1,121 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/include/page/b_plus_tree_integer_leaf_page.h
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <string>
+
+#include "common/rid.h"
+#include "storage/page/b_plus_tree_integer_page.h"
+
+namespace bustub {
+
+/**
+ * Leaf page of a B+ tree over integer keys, storing the keys and their record ids in separate arrays (see
+ * BPlusTreeIntegerPage). It offers the same operations as BPlusTreeLeafPage, and splits and merges by the same number
+ * of entries.
+ */
+class BPlusTreeIntegerLeafPage : public BPlusTreeIntegerPage<RID> {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  BPlusTreeIntegerLeafPage() = delete;
+  BPlusTreeIntegerLeafPage(const BPlusTreeIntegerLeafPage &other) = delete;
+
+  /**
+   * After creating a new leaf page from buffer pool, must call initialize
+   * method to set default values
+   * @param max_size Max size of the leaf node
+   */
+  void Init(int max_size = MaxSizeForPage(BUSTUB_PAGE_SIZE));
+
+  // helper methods
+  auto GetNextPageId() const -> page_id_t;
+  void SetNextPageId(page_id_t next_page_id);
+
+  /**
+   * @return the index of the first key that is not less than key, or GetSize() if there is none
+   */
+  auto KeyIndex(const IntegerKey &key, const IntegerComparator &comparator) const -> int;
+
+  /**
+   * @param[out] value the value stored for key, if any
+   * @return true if the page contains key
+   */
+  auto Lookup(const IntegerKey &key, RID *value, const IntegerComparator &comparator) const -> bool;
+
+  /**
+   * Insert key & value in key order. The caller makes sure that the page has room for one more entry.
+   * @return false if key is already present
+   */
+  auto Insert(const IntegerKey &key, const RID &value, const IntegerComparator &comparator) -> bool;
+
+  /**
+   * @return false if key is not present
+   */
+  auto Remove(const IntegerKey &key, const IntegerComparator &comparator) -> bool;
+
+  // Whether the page can take another entry without reaching its max size.
+  auto IsInsertSafe() const -> bool;
+  // Whether the page has reached its max size and has to be split.
+  auto IsOverfull() const -> bool;
+  // Whether the page stays at least at its min size when an entry is removed.
+  auto IsRemoveSafe() const -> bool;
+  auto IsUnderfull() const -> bool;
+  // Whether the entries of this page and of right, its next page, fit into one page below its max size.
+  auto CanMergeWith(const BPlusTreeIntegerLeafPage *right) const -> bool;
+
+  // Whether key & value can be appended without reaching the max size.
+  auto CanAppend(const IntegerKey &key) const -> bool;
+  // Append key & value, which come after all keys of the page.
+  void Append(const IntegerKey &key, const RID &value);
+  // The share of the entries the page can hold before it splits that it holds.
+  auto FillFactor() const -> double;
+
+  // The key that separates left, the last key of a page, from right, the first key of its next page.
+  static auto Separator(const IntegerKey &left, const IntegerKey &right) -> IntegerKey { return right; }
+
+  /**
+   * Move the upper half of the entries to the empty page recipient, which becomes the next page of this one.
+   * @return the key that separates the two pages
+   */
+  auto MoveHalfTo(BPlusTreeIntegerLeafPage *recipient) -> IntegerKey;
+  // Append all entries to recipient, the previous page of this one, and unlink this page.
+  void MoveAllTo(BPlusTreeIntegerLeafPage *recipient);
+  // Move the first entry to the end of recipient, the previous page of this one. Always succeeds.
+  auto MoveFirstToEndOf(BPlusTreeIntegerLeafPage *recipient, const IntegerKey &separator) -> bool;
+  // Move the last entry to the front of recipient, the next page of this one. Always succeeds.
+  auto MoveLastToFrontOf(BPlusTreeIntegerLeafPage *recipient, const IntegerKey &separator) -> bool;
+
+  /**
+   * @brief for test only return a string representing all keys in
+   * this leaf page formatted as "(key1,key2,key3,...)"
+   *
+   * @return std::string
+   */
+  auto ToString() const -> std::string {
+    std::string kstr = "(";
+    bool first = true;
+
+    for (int i = 0; i < GetSize(); i++) {
+      IntegerKey key = KeyAt(i);
+      if (first) {
+        first = false;
+      } else {
+        kstr.append(",");
+      }
+
+      kstr.append(std::to_string(key.ToString()));
+    }
+    kstr.append(")");
+
+    return kstr;
+  }
+};
+}  // namespace bustub
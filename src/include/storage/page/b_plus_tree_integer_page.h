@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/include/page/b_plus_tree_integer_page.h
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <cstdint>
+
+#include "storage/index/integer_key.h"
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define INTEGER_PAGE_HEADER_SIZE 16
+
+/**
+ * Both integer leaf and internal pages are inherited from this page. They store integer keys apart from their values,
+ * so that a search only touches the keys, and reads them as one array of 64-bit integers.
+ *
+ * A search narrows the keys down by binary search to a window of a few cache lines, then counts the keys in the window
+ * that are less than the key it looks for. The count is done with AVX2 or SSE4.2 compares if the build targets them
+ * (see BUSTUB_USE_NATIVE_ARCH), one key at a time otherwise.
+ *
+ * MaxSize is the number of entries the key and value arrays have room for, and CurrentSize the number of entries.
+ *
+ * Integer page format (keys are stored in order):
+ *  ------------------------------------------------------------------------------------
+ * | HEADER | KEY(1) | KEY(2) | ... | KEY(max) | VALUE(1) | VALUE(2) | ... | VALUE(max) |
+ *  ------------------------------------------------------------------------------------
+ *
+ * Header format (size in byte, 16 bytes in total):
+ *  ---------------------------------------------------------------
+ * | PageType (4) | CurrentSize (4) | MaxSize (4) | NextPageId (4) |
+ *  ---------------------------------------------------------------
+ */
+template <typename ValueType>
+class BPlusTreeIntegerPage : public BPlusTreePage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  BPlusTreeIntegerPage() = delete;
+  BPlusTreeIntegerPage(const BPlusTreeIntegerPage &other) = delete;
+
+  auto KeyAt(int index) const -> IntegerKey;
+  auto ValueAt(int index) const -> ValueType;
+  void SetValueAt(int index, const ValueType &value);
+
+  // Keys have a fixed size, so any key fits.
+  static auto KeyFits(const IntegerKey &key, int max_size) -> bool { return true; }
+  // The max size of a page that fills page_size bytes.
+  static auto MaxSizeForPage(int page_size) -> int {
+    return (page_size - INTEGER_PAGE_HEADER_SIZE) / (sizeof(int64_t) + sizeof(ValueType));
+  }
+  // Pages do not keep fence keys.
+  void SetFences(const IntegerKey &low_fence, const IntegerKey *high_fence) {}
+
+ protected:
+  void InitInteger(IndexPageType page_type, int max_size);
+
+  auto Values() -> ValueType * { return reinterpret_cast<ValueType *>(keys_ + GetMaxSize()); }
+  auto Values() const -> const ValueType * { return reinterpret_cast<const ValueType *>(keys_ + GetMaxSize()); }
+
+  // The index of the first key in [begin, GetSize()) that is not less than key (upper: greater than key).
+  auto LowerBound(int begin, int64_t key) const -> int;
+  auto UpperBound(int begin, int64_t key) const -> int;
+
+  void SetKeyAt(int index, int64_t key) { keys_[index] = key; }
+  // Insert an entry at index, shifting the later entries up. The caller makes sure that the page has room for it.
+  void InsertAt(int index, int64_t key, const ValueType &value);
+  // Remove the entry at index, shifting the later entries down.
+  void RemoveAt(int index);
+  // Append the entries from begin on to recipient, and remove them from this page.
+  void MoveTailTo(int begin, BPlusTreeIntegerPage *recipient);
+
+  page_id_t next_page_id_;
+  // Flexible array member for the keys, followed by the values.
+  int64_t keys_[0];
+};
+
+}  // namespace bustub
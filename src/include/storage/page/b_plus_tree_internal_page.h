@@ -19,7 +19,9 @@ namespace bustub {
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
 #define INTERNAL_PAGE_HEADER_SIZE 12
-#define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
+// The number of key/child pairs that fit in an internal page of the given size.
+#define INTERNAL_PAGE_SLOT_CNT(page_size) (((page_size)-INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
+#define INTERNAL_PAGE_SIZE INTERNAL_PAGE_SLOT_CNT(BUSTUB_PAGE_SIZE)
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
  * Pointer PAGE_ID(i) points to a subtree in which all keys K satisfy:
@@ -73,6 +75,73 @@ class BPlusTreeInternalPage : public BPlusTreePage {
    */
   auto ValueAt(int index) const -> ValueType;
 
+  /**
+   * @param index the index
+   * @param value the new value at the index
+   */
+  void SetValueAt(int index, const ValueType &value);
+
+  /**
+   * @return the child whose subtree covers key
+   */
+  auto Lookup(const KeyType &key, const KeyComparator &comparator) const -> ValueType;
+
+  /**
+   * Make this empty page the root above old_value and new_value, separated by key.
+   */
+  void PopulateNewRoot(const ValueType &old_value, const KeyType &key, const ValueType &new_value);
+
+  /**
+   * Insert key & new_value right after old_value. The caller makes sure that the page has room for one more entry.
+   */
+  void InsertNodeAfter(const ValueType &old_value, const KeyType &key, const ValueType &new_value);
+
+  /**
+   * Insert key & new_value right after old_value into this page, which is full, and move the upper half of the
+   * children to the empty page recipient.
+   * @return the key that separates recipient from this page
+   */
+  auto InsertAndSplit(const ValueType &old_value, const KeyType &key, const ValueType &new_value,
+                      BPlusTreeInternalPage *recipient) -> KeyType;
+
+  /**
+   * Remove the key & value at index, shifting the later entries down.
+   */
+  void Remove(int index);
+
+  // Whether the page can take another child without splitting.
+  auto IsInsertSafe() const -> bool;
+  // Whether the page has room for another child with key.
+  auto HasRoomFor(const KeyType &key) const -> bool;
+  // Whether the page stays at least at its min size when a child is removed.
+  auto IsRemoveSafe() const -> bool;
+  auto IsUnderfull() const -> bool;
+  // Whether the children of this page and of right, its right sibling separated by middle_key, fit into one page.
+  auto CanMergeWith(const BPlusTreeInternalPage *right, const KeyType &middle_key) const -> bool;
+  // Keys have a fixed size, so any key at index can be replaced.
+  auto CanReplaceKey(int index, const KeyType &key) const -> bool { return true; }
+
+  // Whether key & value can be appended.
+  auto CanAppend(const KeyType &key) const -> bool;
+  // Append key & value, which come after all keys of the page. The key of the first entry is ignored.
+  void Append(const KeyType &key, const ValueType &value);
+  // The share of the children the page can hold that it holds.
+  auto FillFactor() const -> double;
+
+  // Keys have a fixed size, so any key fits.
+  static auto KeyFits(const KeyType &key, int max_size) -> bool { return true; }
+  // The max size of a page that fills page_size bytes.
+  static auto MaxSizeForPage(int page_size) -> int { return INTERNAL_PAGE_SLOT_CNT(page_size); }
+  // Pages do not keep fence keys.
+  void SetFences(const KeyType &low_fence, const KeyType *high_fence) {}
+
+  // Append all entries to recipient, the left sibling of this page. middle_key separates the two in the parent.
+  void MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key);
+  // Move the first child to the end of recipient, the left sibling of this page. Always succeeds.
+  auto MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key) -> bool;
+  // Move the last child to the front of recipient, the right sibling of this page. Always succeeds.
+  auto MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key) -> bool;
+
   /**
    * @brief For test only, return a string representing all keys in
    * this internal page, formatted as "(key1,key2,key3,...)"
@@ -20,7 +20,9 @@ namespace bustub {
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
 #define LEAF_PAGE_HEADER_SIZE 16
-#define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
+// The number of key/value pairs that fit in a leaf page of the given size.
+#define LEAF_PAGE_SLOT_CNT(page_size) (((page_size)-LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
+#define LEAF_PAGE_SIZE LEAF_PAGE_SLOT_CNT(BUSTUB_PAGE_SIZE)
 
 /**
  * Store indexed key and record id(record id = page id combined with slot id,
@@ -58,6 +60,70 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   auto GetNextPageId() const -> page_id_t;
   void SetNextPageId(page_id_t next_page_id);
   auto KeyAt(int index) const -> KeyType;
+  auto ValueAt(int index) const -> ValueType;
+  auto ItemAt(int index) const -> const MappingType &;
+
+  /**
+   * @return the index of the first key that is not less than key, or GetSize() if there is none
+   */
+  auto KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int;
+
+  /**
+   * @param[out] value the value stored for key, if any
+   * @return true if the page contains key
+   */
+  auto Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const -> bool;
+
+  /**
+   * Insert key & value in key order. The caller makes sure that the page has room for one more entry.
+   * @return false if key is already present
+   */
+  auto Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) -> bool;
+
+  /**
+   * @return false if key is not present
+   */
+  auto Remove(const KeyType &key, const KeyComparator &comparator) -> bool;
+
+  // Whether the page can take another entry without reaching its max size.
+  auto IsInsertSafe() const -> bool;
+  // Whether the page has reached its max size and has to be split.
+  auto IsOverfull() const -> bool;
+  // Whether the page stays at least at its min size when an entry is removed.
+  auto IsRemoveSafe() const -> bool;
+  auto IsUnderfull() const -> bool;
+  // Whether the entries of this page and of right, its next page, fit into one page below its max size.
+  auto CanMergeWith(const BPlusTreeLeafPage *right) const -> bool;
+
+  // Whether key & value can be appended without reaching the max size.
+  auto CanAppend(const KeyType &key) const -> bool;
+  // Append key & value, which come after all keys of the page.
+  void Append(const KeyType &key, const ValueType &value);
+  // The share of the entries the page can hold before it splits that it holds.
+  auto FillFactor() const -> double;
+
+  // Keys have a fixed size, so any key fits.
+  static auto KeyFits(const KeyType &key, int max_size) -> bool { return true; }
+  // The max size of a page that fills page_size bytes.
+  static auto MaxSizeForPage(int page_size) -> int { return LEAF_PAGE_SLOT_CNT(page_size); }
+  // The key that separates left, the last key of a page, from right, the first key of its next page. Keys have a
+  // fixed size, so it is right.
+  static auto Separator(const KeyType &left, const KeyType &right) -> KeyType { return right; }
+  // Pages do not keep fence keys.
+  void SetFences(const KeyType &low_fence, const KeyType *high_fence) {}
+
+  /**
+   * Move the upper half of the entries to the empty page recipient, which becomes the next page of this one.
+   * @return the key that separates the two pages
+   */
+  auto MoveHalfTo(BPlusTreeLeafPage *recipient) -> KeyType;
+  // Append all entries to recipient, the previous page of this one, and unlink this page.
+  void MoveAllTo(BPlusTreeLeafPage *recipient);
+  // Move the first entry to the end of recipient, the previous page of this one. The two are separated by separator
+  // afterwards. Always succeeds.
+  auto MoveFirstToEndOf(BPlusTreeLeafPage *recipient, const KeyType &separator) -> bool;
+  // Move the last entry to the front of recipient, the next page of this one. Always succeeds.
+  auto MoveLastToFrontOf(BPlusTreeLeafPage *recipient, const KeyType &separator) -> bool;
 
   /**
    * @brief for test only return a string representing all keys in
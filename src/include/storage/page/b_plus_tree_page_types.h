@@ -0,0 +1,48 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/include/page/b_plus_tree_page_types.h
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/rid.h"
+#include "storage/index/integer_key.h"
+#include "storage/index/normalized_key.h"
+#include "storage/page/b_plus_tree_integer_internal_page.h"
+#include "storage/page/b_plus_tree_integer_leaf_page.h"
+#include "storage/page/b_plus_tree_internal_page.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/b_plus_tree_slotted_internal_page.h"
+#include "storage/page/b_plus_tree_slotted_leaf_page.h"
+
+namespace bustub {
+
+/**
+ * The page layouts of a B+ tree over the given key type. Fixed-size keys are stored in arrays of key/value pairs,
+ * normalized keys of any length in slotted pages, and integer keys in separate key and value arrays that are searched
+ * with SIMD. All offer the same operations to the tree.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+struct BPlusTreePageTypes {
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+  using InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>;
+};
+
+template <>
+struct BPlusTreePageTypes<NormalizedKey, RID, NormalizedComparator> {
+  using LeafPage = BPlusTreeSlottedLeafPage;
+  using InternalPage = BPlusTreeSlottedInternalPage;
+};
+
+template <>
+struct BPlusTreePageTypes<IntegerKey, RID, IntegerComparator> {
+  using LeafPage = BPlusTreeIntegerLeafPage;
+  using InternalPage = BPlusTreeIntegerInternalPage;
+};
+
+}  // namespace bustub
@@ -0,0 +1,139 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/include/page/b_plus_tree_slotted_internal_page.h
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <string>
+
+#include "storage/page/b_plus_tree_slotted_page.h"
+
+namespace bustub {
+
+/**
+ * Internal page of a B+ tree over normalized keys, storing n separator keys and n+1 child page ids in a slotted page
+ * (see BPlusTreeSlottedPage). It offers the same operations as BPlusTreeInternalPage, with sizes in bytes instead of
+ * entries. The first key is invalid, as in BPlusTreeInternalPage, and kept empty.
+ *
+ * Like slotted leaves, an internal page stores its separators without the common prefix of its fences, which are the
+ * separators of its parent around it. An internal page splits when a new separator does not fit anymore. Since
+ * separators differ in length, replacing one may not fit either (see CanReplaceKey()).
+ */
+class BPlusTreeSlottedInternalPage : public BPlusTreeSlottedPage<page_id_t> {
+ public:
+  // Deleted to disallow initialization
+  BPlusTreeSlottedInternalPage() = delete;
+  BPlusTreeSlottedInternalPage(const BPlusTreeSlottedInternalPage &other) = delete;
+
+  /**
+   * Writes the necessary header information to a newly created page, must be called after
+   * the creation of a new page to make a valid BPlusTreeSlottedInternalPage
+   * @param max_size Maximal size of the page in bytes
+   */
+  void Init(int max_size = BUSTUB_PAGE_SIZE);
+
+  /**
+   * @param index The index of the key to set. Index must be non-zero.
+   * @param key The new value for key, which the page must have room for
+   */
+  void SetKeyAt(int index, const NormalizedKey &key);
+
+  /**
+   * @param value the value to search for
+   */
+  auto ValueIndex(const page_id_t &value) const -> int;
+
+  /**
+   * @return the child whose subtree covers key
+   */
+  auto Lookup(const NormalizedKey &key, const NormalizedComparator &comparator) const -> page_id_t;
+
+  /**
+   * Make this empty page the root above old_value and new_value, separated by key.
+   */
+  void PopulateNewRoot(const page_id_t &old_value, const NormalizedKey &key, const page_id_t &new_value);
+
+  /**
+   * Insert key & new_value right after old_value. The caller makes sure that the page has room for key.
+   */
+  void InsertNodeAfter(const page_id_t &old_value, const NormalizedKey &key, const page_id_t &new_value);
+
+  /**
+   * Insert key & new_value right after old_value into this page, which has no room for it, and move the upper half of
+   * the bytes to the empty page recipient.
+   * @return the key that separates recipient from this page
+   */
+  auto InsertAndSplit(const page_id_t &old_value, const NormalizedKey &key, const page_id_t &new_value,
+                      BPlusTreeSlottedInternalPage *recipient) -> NormalizedKey;
+
+  /**
+   * Remove the key & value at index, shifting the later entries down.
+   */
+  void Remove(int index);
+
+  // Whether the page has room for any separator key.
+  auto IsInsertSafe() const -> bool;
+  // Whether the page has room for key.
+  auto HasRoomFor(const NormalizedKey &key) const -> bool;
+  // Whether the page stays at least at its min size when any entry is removed.
+  auto IsRemoveSafe() const -> bool;
+  // Whether the entries of this page and of right, its right sibling separated by middle_key, fit into one page.
+  auto CanMergeWith(const BPlusTreeSlottedInternalPage *right, const NormalizedKey &middle_key) const -> bool;
+  // Whether the key at index can be replaced by key.
+  auto CanReplaceKey(int index, const NormalizedKey &key) const -> bool;
+
+  // Whether key & value can be appended.
+  auto CanAppend(const NormalizedKey &key) const -> bool;
+  // Append key & value, which come after all keys of the page. The key of the first entry is ignored.
+  void Append(const NormalizedKey &key, const page_id_t &value);
+
+  // Append all entries to recipient, the left sibling of this page. middle_key separates the two in the parent.
+  void MoveAllTo(BPlusTreeSlottedInternalPage *recipient, const NormalizedKey &middle_key);
+  /**
+   * Move the first child to the end of recipient, the left sibling of this page.
+   * @return false if either page would not fit with the new prefixes, in which case nothing moves
+   */
+  auto MoveFirstToEndOf(BPlusTreeSlottedInternalPage *recipient, const NormalizedKey &middle_key) -> bool;
+  // Move the last child to the front of recipient, the right sibling of this page, like MoveFirstToEndOf().
+  auto MoveLastToFrontOf(BPlusTreeSlottedInternalPage *recipient, const NormalizedKey &middle_key) -> bool;
+
+  /**
+   * @brief For test only, return a string representing all keys in
+   * this internal page, formatted as "(key1,key2,key3,...)"
+   *
+   * @return std::string
+   */
+  auto ToString() const -> std::string {
+    std::string kstr = "(";
+    bool first = true;
+
+    // first key of internal page is always invalid
+    for (int i = 1; i < GetSize(); i++) {
+      NormalizedKey key = KeyAt(i);
+      if (first) {
+        first = false;
+      } else {
+        kstr.append(",");
+      }
+
+      kstr.append(std::to_string(key.ToString()));
+    }
+    kstr.append(")");
+
+    return kstr;
+  }
+
+ private:
+  // Lay out left_entries in left and right_entries from right_begin on in right, which are separated by separator,
+  // unless either would not fit.
+  auto Redistribute(const EntryList &left_entries, const EntryList &right_entries, int right_begin,
+                    BPlusTreeSlottedInternalPage *left, BPlusTreeSlottedInternalPage *right,
+                    const NormalizedKey &separator) -> bool;
+};
+}  // namespace bustub
@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/include/page/b_plus_tree_slotted_leaf_page.h
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <string>
+
+#include "common/rid.h"
+#include "storage/page/b_plus_tree_slotted_page.h"
+
+namespace bustub {
+
+/**
+ * Leaf page of a B+ tree over normalized keys, storing each key with its record id in a slotted page (see
+ * BPlusTreeSlottedPage). It offers the same operations as BPlusTreeLeafPage, with sizes in bytes instead of entries.
+ *
+ * A leaf keeps room for one entry of the max size, so that any insert fits, and splits once it has less. The key
+ * pushed up by a split is cut down to the shortest one that still separates the two halves (see Separator()), which
+ * keeps separators short in internal pages and gives both halves a longer common prefix.
+ */
+class BPlusTreeSlottedLeafPage : public BPlusTreeSlottedPage<RID> {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  BPlusTreeSlottedLeafPage() = delete;
+  BPlusTreeSlottedLeafPage(const BPlusTreeSlottedLeafPage &other) = delete;
+
+  /**
+   * After creating a new leaf page from buffer pool, must call initialize
+   * method to set default values
+   * @param max_size Max size of the leaf node in bytes
+   */
+  void Init(int max_size = BUSTUB_PAGE_SIZE);
+
+  // helper methods
+  auto GetNextPageId() const -> page_id_t;
+  void SetNextPageId(page_id_t next_page_id);
+
+  /**
+   * @return the index of the first key that is not less than key, or GetSize() if there is none
+   */
+  auto KeyIndex(const NormalizedKey &key, const NormalizedComparator &comparator) const -> int;
+
+  /**
+   * @param[out] value the value stored for key, if any
+   * @return true if the page contains key
+   */
+  auto Lookup(const NormalizedKey &key, RID *value, const NormalizedComparator &comparator) const -> bool;
+
+  /**
+   * Insert key & value in key order. The caller makes sure that the page is not overfull.
+   * @return false if key is already present
+   */
+  auto Insert(const NormalizedKey &key, const RID &value, const NormalizedComparator &comparator) -> bool;
+
+  /**
+   * @return false if key is not present
+   */
+  auto Remove(const NormalizedKey &key, const NormalizedComparator &comparator) -> bool;
+
+  // Whether the page can take any entry without becoming overfull.
+  auto IsInsertSafe() const -> bool;
+  // Whether the page has to be split, because it may not have room for another entry.
+  auto IsOverfull() const -> bool;
+  // Whether the page stays at least at its min size when any entry is removed.
+  auto IsRemoveSafe() const -> bool;
+  // Whether the entries of this page and of right, its next page, fit into one page that is not overfull.
+  auto CanMergeWith(const BPlusTreeSlottedLeafPage *right) const -> bool;
+
+  // Whether key & value can be appended without making the page overfull.
+  auto CanAppend(const NormalizedKey &key) const -> bool;
+  // Append key & value, which come after all keys of the page.
+  void Append(const NormalizedKey &key, const RID &value);
+
+  // The shortest key between left and right, the last key of a page and the first key of its next page.
+  static auto Separator(const NormalizedKey &left, const NormalizedKey &right) -> NormalizedKey {
+    return ShortestSeparator(left, right);
+  }
+
+  /**
+   * Move the upper half of the bytes to the empty page recipient, which becomes the next page of this one.
+   * @return the shortest key that separates the two pages, which becomes their fence
+   */
+  auto MoveHalfTo(BPlusTreeSlottedLeafPage *recipient) -> NormalizedKey;
+  // Append all entries to recipient, the previous page of this one, and unlink this page.
+  void MoveAllTo(BPlusTreeSlottedLeafPage *recipient);
+  /**
+   * Move the first entry to the end of recipient, the previous page of this one, which then are separated by
+   * separator.
+   * @return false if either page would be overfull with the new prefixes, in which case nothing moves
+   */
+  auto MoveFirstToEndOf(BPlusTreeSlottedLeafPage *recipient, const NormalizedKey &separator) -> bool;
+  // Move the last entry to the front of recipient, the next page of this one, like MoveFirstToEndOf().
+  auto MoveLastToFrontOf(BPlusTreeSlottedLeafPage *recipient, const NormalizedKey &separator) -> bool;
+
+  /**
+   * @brief for test only return a string representing all keys in
+   * this leaf page formatted as "(key1,key2,key3,...)"
+   *
+   * @return std::string
+   */
+  auto ToString() const -> std::string {
+    std::string kstr = "(";
+    bool first = true;
+
+    for (int i = 0; i < GetSize(); i++) {
+      NormalizedKey key = KeyAt(i);
+      if (first) {
+        first = false;
+      } else {
+        kstr.append(",");
+      }
+
+      kstr.append(std::to_string(key.ToString()));
+    }
+    kstr.append(")");
+
+    return kstr;
+  }
+
+ private:
+  // Lay out left_entries in left and right_entries from right_begin on in right, which are separated by separator,
+  // unless either would be overfull.
+  auto Redistribute(const EntryList &left_entries, const EntryList &right_entries, int right_begin,
+                    BPlusTreeSlottedLeafPage *left, BPlusTreeSlottedLeafPage *right, const NormalizedKey &separator)
+      -> bool;
+};
+}  // namespace bustub
@@ -0,0 +1,163 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/include/page/b_plus_tree_slotted_page.h
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "storage/index/normalized_key.h"
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define SLOTTED_PAGE_HEADER_SIZE 28
+
+/**
+ * Both slotted leaf and internal pages are inherited from this page. They store normalized keys of any length.
+ *
+ * The slots grow up from the header and the keys grow down from the fence keys at the end of the page into the key
+ * heap. A slot holds the offset and size of its key in the heap, and the value. Only the slots are kept in key order,
+ * so inserting or removing an entry shifts slots but not keys. The space of removed keys is reclaimed by compacting
+ * the heap once a new key does not fit otherwise.
+ *
+ * The fence keys bound the keys that belong in the page: the low fence is not greater than any of them, and the high
+ * fence (if any) is greater than all of them. So every key of the page starts with the common prefix of the fences,
+ * which is stored once, in the low fence, and cut off the keys in the heap. Fences change only when the tree splits,
+ * merges or rebalances pages, which re-encode their keys (see Rebuild()).
+ *
+ * MaxSize is the number of bytes of the page in use, and CurrentSize the number of entries. Pages are split and merged
+ * by the bytes their slots, keys and fences take up: a page is underfull below a quarter of its space, and an entry may
+ * take up an eighth of it at most (see KeyFits()).
+ *
+ * Slotted page format:
+ *  -----------------------------------------------------------------------------------------------------------
+ * | HEADER | SLOT(1) | ... | SLOT(n) | FREE SPACE | KEY(2) | ... | KEY(n) | KEY(1) | LOW FENCE | HIGH FENCE |
+ *  -----------------------------------------------------------------------------------------------------------
+ *
+ * Header format (size in byte, 28 bytes in total):
+ *  -----------------------------------------------------------------------------------------------------------
+ * | PageType (4) | CurrentSize (4) | MaxSize (4) | NextPageId (4) | HeapBegin (2) | KeyBytes (2) | PrefixSize (2) |
+ *  -----------------------------------------------------------------------------------------------------------
+ *  -----------------------------------------------------------------------------------------------------------
+ * | LowFenceSize (2) | HighFenceSize (2) | HasHighFence (2) |
+ *  -----------------------------------------------------------------------------------------------------------
+ *
+ * Slot format:
+ *  ----------------------------------------------------
+ * | KeyOffset (2) | KeySize (2, without prefix) | Value |
+ *  ----------------------------------------------------
+ */
+template <typename ValueType>
+class BPlusTreeSlottedPage : public BPlusTreePage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  BPlusTreeSlottedPage() = delete;
+  BPlusTreeSlottedPage(const BPlusTreeSlottedPage &other) = delete;
+
+  // The key at index, with the prefix of the page.
+  auto KeyAt(int index) const -> NormalizedKey;
+  auto ValueAt(int index) const -> ValueType;
+  void SetValueAt(int index, const ValueType &value);
+
+  // The bytes taken up by the slots, keys and fences.
+  auto GetUsedBytes() const -> int;
+  // The bytes left for slots and keys, including those of removed keys that are not reclaimed yet.
+  auto GetFreeBytes() const -> int;
+  // The number of bytes below which the page is underfull.
+  auto GetMinSize() const -> int;
+  auto IsUnderfull() const -> bool;
+  auto FillFactor() const -> double;
+
+  // The number of leading bytes that all keys of the page share, and that are stored once.
+  auto GetPrefixSize() const -> int { return prefix_size_; }
+  auto GetLowFence() const -> NormalizedKey;
+  // @return false if the page has no high fence, i.e. it is the rightmost page of its level
+  auto GetHighFence(NormalizedKey *high_fence) const -> bool;
+  // Narrow or widen the key range of the page to [low_fence, high_fence), which must hold its keys, and re-encode the
+  // keys with the new prefix. No high_fence means no upper bound.
+  void SetFences(const NormalizedKey &low_fence, const NormalizedKey *high_fence);
+
+  // Whether an entry with key fits into a page of max_size bytes.
+  static auto KeyFits(const NormalizedKey &key, int max_size) -> bool;
+  // The max size of a page that fills page_size bytes.
+  static auto MaxSizeForPage(int page_size) -> int { return page_size; }
+  // The shortest key that is greater than left and not greater than right, which is a prefix of right.
+  static auto ShortestSeparator(const NormalizedKey &left, const NormalizedKey &right) -> NormalizedKey;
+
+ protected:
+  struct Slot {
+    uint16_t offset_;
+    uint16_t size_;
+    ValueType value_;
+  };
+
+  using EntryList = std::vector<std::pair<NormalizedKey, ValueType>>;
+
+  static auto EntryBytes(int key_size) -> int { return sizeof(Slot) + key_size; }
+  // The bytes an entry may take up at most in a page of max_size bytes.
+  static auto MaxEntryBytes(int max_size) -> int { return (max_size - SLOTTED_PAGE_HEADER_SIZE) / 8; }
+  // The index to split entries of the given sizes at so that both halves take up about as many bytes, leaving at least
+  // min_entries on either side.
+  static auto SplitIndex(const std::vector<int> &entry_bytes, int min_entries) -> int;
+  // The bytes that entries [begin, end) take up in a page with the given fences. Empty keys stay empty.
+  static auto EncodedBytes(const EntryList &entries, int begin, int end, const NormalizedKey &low_fence,
+                           const NormalizedKey *high_fence) -> int;
+
+  void InitSlotted(IndexPageType page_type, int max_size);
+  auto GetUsableBytes() const -> int { return GetMaxSize() - SLOTTED_PAGE_HEADER_SIZE; }
+  auto GetMaxEntryBytes() const -> int { return MaxEntryBytes(GetMaxSize()); }
+
+  // All entries of the page, with full keys.
+  auto GetEntries() const -> EntryList;
+  // Replace the entries of the page by entries [begin, end) and its fences by the given ones. The caller makes sure
+  // that they fit (see EncodedBytes()).
+  void Rebuild(const EntryList &entries, int begin, int end, const NormalizedKey &low_fence,
+               const NormalizedKey *high_fence);
+
+  auto KeyData(int index) const -> const char * { return reinterpret_cast<const char *>(this) + slots_[index].offset_; }
+  auto KeySize(int index) const -> int { return slots_[index].size_; }
+  // The bytes of key stored in a slot: key without the prefix, or nothing for an empty key.
+  auto SuffixSize(const NormalizedKey &key) const -> int;
+  // Compare key with the prefix of the page: < 0 if key sorts before all keys with the prefix, > 0 if after them.
+  auto ComparePrefix(const NormalizedKey &key) const -> int;
+  // Compare the key at index with key, like NormalizedComparator.
+  auto CompareAt(int index, const NormalizedKey &key) const -> int;
+  // The index of the first key in [begin, GetSize()) that is not less than key (upper: greater than key).
+  auto LowerBound(int begin, const NormalizedKey &key) const -> int;
+  auto UpperBound(int begin, const NormalizedKey &key) const -> int;
+
+  // Insert an entry at index, shifting the later slots up. The caller makes sure that the page has room for it.
+  void InsertAt(int index, const NormalizedKey &key, const ValueType &value);
+  // Remove the entry at index, shifting the later slots down.
+  void RemoveAt(int index);
+  // Replace the key at index. The caller makes sure that the page has room for it.
+  void SetKeyBytesAt(int index, const NormalizedKey &key);
+  // Move the keys together below the fences, so that all free space lies between the slots and the key heap.
+  void Compact();
+
+  page_id_t next_page_id_;
+  uint16_t heap_begin_;
+  uint16_t key_bytes_;
+  uint16_t prefix_size_;
+  uint16_t low_fence_size_;
+  uint16_t high_fence_size_;
+  uint16_t has_high_fence_;
+  // Flexible array member for the slots.
+  Slot slots_[0];
+
+ private:
+  auto FencesBegin() const -> int { return GetMaxSize() - low_fence_size_ - high_fence_size_; }
+  auto SuffixData(const NormalizedKey &key) const -> const char *;
+  auto CompareSuffixAt(int index, const char *suffix, int suffix_size) const -> int;
+};
+
+}  // namespace bustub
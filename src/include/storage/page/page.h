@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstring>
 #include <iostream>
 
@@ -24,8 +25,11 @@ namespace bustub {
  * Page is the basic unit of storage within the database system. Page provides a wrapper for actual data pages being
  * held in main memory. Page also contains book-keeping information that is used by the buffer pool manager, e.g.
  * pin count, dirty flag, page id, etc.
+ *
+ * In the buffer pool, the data of all frames lives in one FrameArena and the pages form a separate array of metadata,
+ * each page on cache lines of its own so that threads working on different frames do not contend on them.
  */
-class Page {
+class alignas(64) Page {
   // There is book-keeping information inside the page that should only be relevant to the buffer pool manager.
   friend class BufferPoolManager;
 
@@ -37,13 +41,20 @@ class Page {
   }
 
   /** Default destructor. */
-  ~Page() { delete[] data_; }
+  ~Page() {
+    if (owns_data_) {
+      delete[] data_;
+    }
+  }
 
   /** @return the actual data contained within this page */
   inline auto GetData() -> char * { return data_; }
 
+  /** @return the size of the data of this page in byte */
+  inline auto GetSize() const -> size_t { return size_; }
+
   /** @return the page id of this page */
-  inline auto GetPageId() -> page_id_t { return page_id_; }
+  inline auto GetPageId() const -> page_id_t { return page_id_.load(std::memory_order_relaxed); }
 
   /** @return the pin count of this page */
   inline auto GetPinCount() -> int { return pin_count_; }
@@ -51,11 +62,17 @@ class Page {
   /** @return true if the page in memory has been modified from the page on disk, false otherwise */
   inline auto IsDirty() -> bool { return is_dirty_; }
 
-  /** Acquire the page write latch. */
-  inline void WLatch() { rwlatch_.WLock(); }
+  /** Acquire the page write latch. The page version stays odd until the latch is released. */
+  inline void WLatch() {
+    rwlatch_.WLock();
+    BeginWrite();
+  }
 
   /** Release the page write latch. */
-  inline void WUnlatch() { rwlatch_.WUnlock(); }
+  inline void WUnlatch() {
+    EndWrite();
+    rwlatch_.WUnlock();
+  }
 
   /** Acquire the page read latch. */
   inline void RLatch() { rwlatch_.RLock(); }
@@ -69,6 +86,13 @@ class Page {
   /** Sets the page LSN. */
   inline void SetLSN(lsn_t lsn) { memcpy(GetData() + OFFSET_LSN, &lsn, sizeof(lsn_t)); }
 
+  /**
+   * @return the version of the frame. It is odd while the page is write latched or the buffer pool is replacing it,
+   * and changes with every such modification. A reader that sees the same even version before and after reading the
+   * page without any latch has read a consistent page.
+   */
+  inline auto GetVersion() -> uint64_t { return version_.load(std::memory_order_acquire); }
+
  protected:
   static_assert(sizeof(page_id_t) == 4);
   static_assert(sizeof(lsn_t) == 4);
@@ -78,21 +102,53 @@ class Page {
   static constexpr size_t OFFSET_LSN = 4;
 
  private:
+  /** Wraps size bytes of data owned by someone else, e.g. a frame of the buffer pool's arena, as they are. */
+  Page(char *data, size_t size) : data_(data), size_(size), owns_data_(false) {}
+
+  /** Sets the page id. Only the buffer pool manager does, with the shard latch held and the version odd. */
+  inline void SetPageId(page_id_t page_id) { page_id_.store(page_id, std::memory_order_relaxed); }
+
   /** Zeroes out the data that is held within the page. */
-  inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, BUSTUB_PAGE_SIZE); }
+  inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, size_); }
+
+  /** Make the version odd before modifying the page. */
+  inline void BeginWrite() {
+    version_.fetch_add(1, std::memory_order_relaxed);
+    // Keep the modifications that follow from becoming visible before the odd version.
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  /** Make the version even again once the modifications are complete. */
+  inline void EndWrite() { version_.fetch_add(1, std::memory_order_release); }
 
   /** The actual data that is stored within a page. */
   // Usually this should be stored as `char data_[BUSTUB_PAGE_SIZE]{};`. But to enable ASAN to detect page overflow,
-  // we store it as a ptr.
+  // we store it as a ptr: to a heap allocation of its own, or to a frame of the buffer pool's arena, where poisoned red
+  // zones separate the frames.
   char *data_;
-  /** The ID of this page. */
-  page_id_t page_id_ = INVALID_PAGE_ID;
+  /** The size of data_ in byte. */
+  size_t size_ = BUSTUB_PAGE_SIZE;
+  /** False if data_ belongs to someone else. */
+  bool owns_data_ = true;
+  /**
+   * The ID of this page. Atomic because optimistic readers look at it without any latch; the frame's version tells
+   * them whether what they saw is consistent, so relaxed accesses suffice.
+   */
+  std::atomic<page_id_t> page_id_{INVALID_PAGE_ID};
   /** The pin count of this page. */
   int pin_count_ = 0;
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
   bool is_dirty_ = false;
+  /** True while the buffer pool manager is reading the page from disk into this frame. */
+  bool io_in_progress_ = false;
+  /** Set on the first page of a read-ahead window; the next scan that touches it extends the window. */
+  bool read_ahead_mark_ = false;
+  /** The number of pins held by buffer pool write-backs rather than by users of the page. */
+  int write_back_pins_ = 0;
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
+  /** Seqlock-style version of the frame, see GetVersion(). */
+  std::atomic<uint64_t> version_{0};
 };
 
 }  // namespace bustub
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <memory>
+#include <utility>
+
 #include "storage/page/page.h"
 
 namespace bustub {
@@ -59,6 +62,9 @@ class BasicPageGuard {
    */
   ~BasicPageGuard();
 
+  /** @return false if the guard holds no page, e.g. because the fetch failed or the guard was dropped */
+  auto IsValid() const -> bool { return page_ != nullptr; }
+
   auto PageId() -> page_id_t { return page_->GetPageId(); }
 
   auto GetData() -> const char * { return page_->GetData(); }
@@ -91,6 +97,15 @@ class ReadPageGuard {
  public:
   ReadPageGuard() = default;
   ReadPageGuard(BufferPoolManager *bpm, Page *page) : guard_(bpm, page) {}
+
+  /**
+   * @brief Create one of several guards on the same page that share one read latch, which a thread cannot take twice.
+   * Each guard holds a pin of its own; the latch is released with the last of them.
+   * @param shared_latch owns the read latch, and releases it when destroyed
+   */
+  ReadPageGuard(BufferPoolManager *bpm, Page *page, std::shared_ptr<void> shared_latch)
+      : guard_(bpm, page), shared_latch_(std::move(shared_latch)) {}
+
   ReadPageGuard(const ReadPageGuard &) = delete;
   auto operator=(const ReadPageGuard &) -> ReadPageGuard & = delete;
 
@@ -133,6 +148,8 @@ class ReadPageGuard {
    */
   ~ReadPageGuard();
 
+  auto IsValid() const -> bool { return guard_.IsValid(); }
+
   auto PageId() -> page_id_t { return guard_.PageId(); }
 
   auto GetData() -> const char * { return guard_.GetData(); }
@@ -143,8 +160,13 @@ class ReadPageGuard {
   }
 
  private:
+  /** Release the read latch, or this guard's share of it. */
+  void Unlatch();
+
   // You may choose to get rid of this and add your own private variables.
   BasicPageGuard guard_;
+  /** The read latch shared with other guards on the page, if any. */
+  std::shared_ptr<void> shared_latch_;
 };
 
 class WritePageGuard {
@@ -193,6 +215,8 @@ class WritePageGuard {
    */
   ~WritePageGuard();
 
+  auto IsValid() const -> bool { return guard_.IsValid(); }
+
   auto PageId() -> page_id_t { return guard_.PageId(); }
 
   auto GetData() -> const char * { return guard_.GetData(); }
@@ -214,4 +238,49 @@ class WritePageGuard {
   BasicPageGuard guard_;
 };
 
+/**
+ * OptimisticReadGuard reads a page without pinning or latching it, in the style of a seqlock. Taking one records the
+ * version of the frame; Validate() tells whether the page was modified, evicted or replaced since. A writer can change
+ * the page at any time, so anything read through the guard must be treated as garbage until Validate() succeeds, and
+ * the reader retries (or falls back to a ReadPageGuard) when it fails:
+ *
+ *   while (true) {
+ *     auto guard = bpm->FetchPageOptimistic(page_id);
+ *     auto child = guard.As<InternalPage>()->Lookup(key);
+ *     if (guard.Validate()) { break; }
+ *   }
+ *
+ * The frame memory outlives any page it holds, so reading it is always safe, only possibly inconsistent. Pages read
+ * optimistically must only be modified through a write latch (WritePageGuard, or Page::WLatch()).
+ */
+class OptimisticReadGuard {
+ public:
+  OptimisticReadGuard() = default;
+  OptimisticReadGuard(Page *page, page_id_t page_id, uint64_t version)
+      : page_(page), page_id_(page_id), version_(version) {}
+
+  /** @return false for a default-constructed guard, which has no page and never validates */
+  auto IsValid() const -> bool { return page_ != nullptr; }
+
+  /**
+   * @return true if no writer has touched the page since the guard was taken, i.e. everything read through the guard
+   * so far is consistent. Always false if the page was being modified when the guard was taken.
+   */
+  auto Validate() const -> bool;
+
+  auto PageId() -> page_id_t { return page_id_; }
+
+  auto GetData() -> const char * { return page_->GetData(); }
+
+  template <class T>
+  auto As() -> const T * {
+    return reinterpret_cast<const T *>(GetData());
+  }
+
+ private:
+  Page *page_{nullptr};
+  page_id_t page_id_{INVALID_PAGE_ID};
+  uint64_t version_{0};
+};
+
 }  // namespace bustub
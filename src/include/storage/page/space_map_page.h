@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// space_map_page.h
+//
+// Identification: src/include/storage/page/space_map_page.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * Header page of the space map, which records what part of the database file is in use so that deleted pages can be
+ * reused after a restart. It lives at SPACE_MAP_PAGE_ID and holds the page size of the file and, for every shard of
+ * the buffer pool, the next page id the shard would allocate and the first trunk page of its list of deallocated pages.
+ * The page size comes first so that DiskManager can read it before it knows how large page 0 is.
+ *
+ * Header format (size in byte):
+ * -------------------------------------------------------------------------------------------------
+ * | Magic (4) | PageSize (4) | NumShards (4) | NextPageId_0 (4) | FirstTrunkPageId_0 (4) | ...
+ * -------------------------------------------------------------------------------------------------
+ */
+class SpaceMapHeaderPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  SpaceMapHeaderPage() = delete;
+  SpaceMapHeaderPage(const SpaceMapHeaderPage &other) = delete;
+
+  struct ShardEntry {
+    page_id_t next_page_id_;
+    page_id_t first_trunk_page_id_;
+  };
+
+  /** Tells a written space map apart from a fresh (zeroed) database file. */
+  static constexpr uint32_t MAGIC = 0x42545346;
+  /** Sized for the smallest page, so that the shard count a file can hold does not depend on its page size. */
+  static constexpr size_t MAX_SHARDS = (BUSTUB_PAGE_SIZE - 3 * sizeof(uint32_t)) / sizeof(ShardEntry);
+
+  uint32_t magic_;
+  uint32_t page_size_;
+  uint32_t num_shards_;
+  ShardEntry shards_[MAX_SHARDS];
+};
+
+/**
+ * Trunk page of the list of deallocated pages of one shard. Trunk pages are stored in deallocated pages themselves,
+ * which are listed as well, so the list takes no space of its own. The buffer pool does not reuse a trunk page before
+ * a newer header that no longer points at it is durable.
+ *
+ * Trunk format (size in byte):
+ * ----------------------------------------------------------------------
+ * | NextTrunkPageId (4) | Size (4) | PageId_0 (4) | PageId_1 (4) | ...
+ * ----------------------------------------------------------------------
+ */
+class SpaceMapTrunkPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  SpaceMapTrunkPage() = delete;
+  SpaceMapTrunkPage(const SpaceMapTrunkPage &other) = delete;
+
+  /** @return the number of page ids a trunk page of the given size holds */
+  static constexpr auto Capacity(size_t page_size) -> size_t {
+    return (page_size - sizeof(page_id_t) - sizeof(uint32_t)) / sizeof(page_id_t);
+  }
+
+  page_id_t next_trunk_page_id_;
+  uint32_t size_;
+  // Flexible array member, Capacity(page size) entries long.
+  page_id_t page_ids_[0];
+};
+
+static_assert(sizeof(SpaceMapHeaderPage) <= BUSTUB_PAGE_SIZE);
+
+}  // namespace bustub
@@ -15,6 +15,7 @@
 #include <mutex>  // NOLINT
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "common/config.h"
@@ -29,13 +30,15 @@ namespace bustub {
 
 /**
  * TableHeap represents a physical table on disk.
- * This is just a doubly-linked list of pages.
+ * This is just a doubly-linked list of pages, allocated from extents of contiguous pages so that a scan of the table
+ * reads the database file sequentially.
  */
 class TableHeap {
   friend class TableIterator;
 
  public:
-  ~TableHeap() = default;
+  /** Gives the unused pages of the table's extent back to the buffer pool. */
+  ~TableHeap();
 
   /**
    * Create a table heap without a transaction. (open table)
@@ -67,6 +70,14 @@ class TableHeap {
    */
   auto GetTuple(RID rid) -> std::pair<TupleMeta, Tuple>;
 
+  /**
+   * Read several tuples from the table, fetching the pages they live on as one batch. The pages that do not fit in the
+   * buffer pool along with the rest of the batch are fetched one at a time afterwards.
+   * @param rids rids of the tuples to read
+   * @return the meta and tuple of every rid, in the same order
+   */
+  auto GetTuples(const std::vector<RID> &rids) -> std::vector<std::pair<TupleMeta, Tuple>>;
+
   /**
    * Read a tuple meta from the table. Note: if you want to get tuple and meta together, use `GetTuple` insead
    * to ensure atomicity.
@@ -98,6 +109,7 @@ class TableHeap {
 
   std::mutex latch_;
   page_id_t last_page_id_{INVALID_PAGE_ID}; /* protected by latch_ */
+  Extent extent_;                           /* where the pages of the table come from */
 };
 
 }  // namespace bustub
@@ -10,8 +10,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <cassert>
+#include <cerrno>
 #include <cstring>
 #include <iostream>
 #include <mutex>  // NOLINT
@@ -20,7 +23,9 @@
 
 #include "common/exception.h"
 #include "common/logger.h"
+#include "fmt/format.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/page/space_map_page.h"
 
 namespace bustub {
 
@@ -30,7 +35,8 @@ static char *buffer_used;
  * Constructor: open/create a single database file & log file
  * @input db_file: database file name
  */
-DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
+DiskManager::DiskManager(const std::string &db_file, size_t page_size) : file_name_(db_file) {
+  SetPageSize(page_size);
   std::string::size_type n = file_name_.rfind('.');
   if (n == std::string::npos) {
     LOG_DEBUG("wrong file format");
@@ -38,87 +44,109 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
   }
   log_name_ = file_name_.substr(0, n) + ".log";
 
-  log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::app | std::ios::out);
-  // directory or file does not exist
-  if (!log_io_.is_open()) {
-    log_io_.clear();
-    // create a new file
-    log_io_.open(log_name_, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
-    if (!log_io_.is_open()) {
-      throw Exception("can't open dblog file");
-    }
+  log_fd_ = open(log_name_.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+  if (log_fd_ < 0) {
+    throw Exception("can't open dblog file");
   }
 
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
-    if (!db_io_.is_open()) {
-      throw Exception("can't open db file");
-    }
+  db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
+  if (db_fd_ < 0) {
+    close(log_fd_);
+    log_fd_ = -1;
+    throw Exception("can't open db file");
+  }
+
+  // An existing database keeps the page size it was created with, which its space map header records.
+  uint32_t header[2] = {0, 0};
+  if (PreadFull(db_fd_, reinterpret_cast<char *>(header), sizeof(header), 0) == sizeof(header) &&
+      header[0] == SpaceMapHeaderPage::MAGIC) {
+    SetPageSize(header[1]);
   }
   buffer_used = nullptr;
 }
 
+DiskManager::~DiskManager() {
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+  }
+  if (log_fd_ >= 0) {
+    close(log_fd_);
+  }
+}
+
+auto DiskManager::IsValidPageSize(size_t page_size) -> bool {
+  return page_size >= BUSTUB_PAGE_SIZE && page_size <= BUSTUB_MAX_PAGE_SIZE && (page_size & (page_size - 1)) == 0;
+}
+
+void DiskManager::SetPageSize(size_t page_size) {
+  if (!IsValidPageSize(page_size)) {
+    throw Exception(fmt::format("invalid page size {}", page_size));
+  }
+  page_size_ = page_size;
+}
+
 /**
- * Close all file streams
+ * Sync and close all files
  */
 void DiskManager::ShutDown() {
-  {
-    std::scoped_lock scoped_db_io_latch(db_io_latch_);
-    db_io_.close();
+  SyncPages();
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+    db_fd_ = -1;
+  }
+  if (log_fd_ >= 0) {
+    close(log_fd_);
+    log_fd_ = -1;
   }
-  log_io_.close();
 }
 
 /**
  * Write the contents of the specified page into disk file
  */
 void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  size_t offset = static_cast<size_t>(page_id) * BUSTUB_PAGE_SIZE;
-  // set write cursor to offset
+  size_t offset = static_cast<size_t>(page_id) * page_size_;
   num_writes_ += 1;
-  db_io_.seekp(offset);
-  db_io_.write(page_data, BUSTUB_PAGE_SIZE);
-  // check for I/O error
-  if (db_io_.bad()) {
+  if (PwriteFull(db_fd_, page_data, page_size_, offset) != page_size_) {
     LOG_DEBUG("I/O error while writing");
-    return;
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
 }
 
 /**
  * Read the contents of the specified page into the given memory area
  */
 void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  int offset = page_id * BUSTUB_PAGE_SIZE;
-  // check if read beyond file length
-  if (offset > GetFileSize(file_name_)) {
-    LOG_DEBUG("I/O error reading past end of file");
-    // std::cerr << "I/O error while reading" << std::endl;
-  } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, BUSTUB_PAGE_SIZE);
-    if (db_io_.bad()) {
-      LOG_DEBUG("I/O error while reading");
-      return;
+  size_t offset = static_cast<size_t>(page_id) * page_size_;
+  size_t read_count = PreadFull(db_fd_, page_data, page_size_, offset);
+  // if file ends before reading a whole page
+  if (read_count < page_size_) {
+    LOG_DEBUG("Read less than a page");
+    memset(page_data + read_count, 0, page_size_ - read_count);
+  }
+}
+
+void DiskManager::SyncPages() {
+  if (db_fd_ < 0) {
+    return;
+  }
+  std::unique_lock lock(sync_latch_);
+  // A sync that is already running may have missed our writes, so we need one that starts from now on.
+  uint64_t target = syncs_started_ + 1;
+  while (syncs_completed_ < target) {
+    if (sync_in_progress_) {
+      sync_cv_.wait(lock);
+      continue;
     }
-    // if file ends before reading BUSTUB_PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < BUSTUB_PAGE_SIZE) {
-      LOG_DEBUG("Read less than a page");
-      db_io_.clear();
-      // std::cerr << "Read less than a page" << std::endl;
-      memset(page_data + read_count, 0, BUSTUB_PAGE_SIZE - read_count);
+    sync_in_progress_ = true;
+    uint64_t sync = ++syncs_started_;
+    lock.unlock();
+    if (fdatasync(db_fd_) != 0) {
+      LOG_DEBUG("I/O error while syncing");
     }
+    num_syncs_ += 1;
+    lock.lock();
+    syncs_completed_ = sync;
+    sync_in_progress_ = false;
+    sync_cv_.notify_all();
   }
 }
 
@@ -143,16 +171,23 @@ void DiskManager::WriteLog(char *log_data, int size) {
   }
 
   num_flushes_ += 1;
-  // sequence write
-  log_io_.write(log_data, size);
-
-  // check for I/O error
-  if (log_io_.bad()) {
-    LOG_DEBUG("I/O error while writing log");
+  // sequence write, the log file is opened for appending
+  for (int written = 0; written < size;) {
+    ssize_t rc = write(log_fd_, log_data + written, size - written);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc <= 0) {
+      LOG_DEBUG("I/O error while writing log");
+      return;
+    }
+    written += rc;
+  }
+  // needs to sync to make the log durable
+  if (fdatasync(log_fd_) != 0) {
+    LOG_DEBUG("I/O error while syncing log");
     return;
   }
-  // needs to flush to keep disk file in sync
-  log_io_.flush();
   flush_log_ = false;
 }
 
@@ -167,17 +202,9 @@ auto DiskManager::ReadLog(char *log_data, int size, int offset) -> bool {
     // LOG_DEBUG("file size is %d", GetFileSize(log_name_));
     return false;
   }
-  log_io_.seekp(offset);
-  log_io_.read(log_data, size);
-
-  if (log_io_.bad()) {
-    LOG_DEBUG("I/O error while reading log");
-    return false;
-  }
+  size_t read_count = PreadFull(log_fd_, log_data, size, offset);
   // if log file ends before reading "size"
-  int read_count = log_io_.gcount();
-  if (read_count < size) {
-    log_io_.clear();
+  if (read_count < static_cast<size_t>(size)) {
     memset(log_data + read_count, 0, size - read_count);
   }
 
@@ -208,4 +235,34 @@ auto DiskManager::GetFileSize(const std::string &file_name) -> int {
   return rc == 0 ? static_cast<int>(stat_buf.st_size) : -1;
 }
 
+auto DiskManager::PwriteFull(int fd, const char *data, size_t size, size_t offset) -> size_t {
+  size_t done = 0;
+  while (done < size) {
+    ssize_t rc = pwrite(fd, data + done, size - done, offset + done);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc <= 0) {
+      break;
+    }
+    done += rc;
+  }
+  return done;
+}
+
+auto DiskManager::PreadFull(int fd, char *data, size_t size, size_t offset) -> size_t {
+  size_t done = 0;
+  while (done < size) {
+    ssize_t rc = pread(fd, data + done, size - done, offset + done);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc <= 0) {
+      break;
+    }
+    done += rc;
+  }
+  return done;
+}
+
 }  // namespace bustub
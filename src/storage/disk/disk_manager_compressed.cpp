@@ -0,0 +1,269 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_compressed.cpp
+//
+// Identification: src/storage/disk/disk_manager_compressed.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_compressed.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/util/compression_util.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+DiskManagerCompressed::DiskManagerCompressed(const std::string &db_file, size_t page_size)
+    : DiskManager(db_file, page_size) {
+  // The base class may have taken the page size from what it believed to be a space map; the page map knows better.
+  SetPageSize(page_size);
+  page_map_name_ = db_file.substr(0, db_file.rfind('.')) + ".pmap";
+  LoadPageMap();
+}
+
+DiskManagerCompressed::~DiskManagerCompressed() { SavePageMap(); }
+
+void DiskManagerCompressed::SyncPages() {
+  // Saving the page map syncs the pages it points at first. Without changes to the map, no page was written.
+  SavePageMap();
+}
+
+void DiskManagerCompressed::LoadPageMap() {
+  std::ifstream in(page_map_name_, std::ios::binary);
+  if (!in.is_open()) {
+    if (GetFileSize(file_name_) > 0) {
+      throw Exception(fmt::format("{} has no page map, it is not a compressed database file", file_name_));
+    }
+    return;
+  }
+
+  uint32_t header[4];
+  in.read(reinterpret_cast<char *>(header), sizeof(header));
+  if (!in || header[0] != PAGE_MAP_MAGIC || header[3] != COMPRESSED_PAGE_GRANULE) {
+    throw Exception(fmt::format("corrupted page map {}", page_map_name_));
+  }
+  SetPageSize(header[1]);
+  page_map_.resize(header[2]);
+  in.read(reinterpret_cast<char *>(page_map_.data()), page_map_.size() * sizeof(PageExtent));
+  if (!in) {
+    throw Exception(fmt::format("corrupted page map {}", page_map_name_));
+  }
+
+  // Everything between the runs of the pages is free.
+  std::vector<std::pair<uint64_t, uint32_t>> runs;
+  for (const auto &extent : page_map_) {
+    if (extent.granules_ > 0) {
+      runs.emplace_back(extent.offset_, extent.granules_);
+    }
+  }
+  std::sort(runs.begin(), runs.end());
+  for (auto [offset, granules] : runs) {
+    if (offset > end_offset_) {
+      free_runs_.emplace((offset - end_offset_) / COMPRESSED_PAGE_GRANULE, end_offset_);
+    }
+    end_offset_ = std::max(end_offset_, offset + granules * COMPRESSED_PAGE_GRANULE);
+  }
+}
+
+void DiskManagerCompressed::SavePageMap() {
+  std::scoped_lock scoped_save_latch(save_latch_);
+  // Take a snapshot of the map. The runs freed before it are no longer in it, so they can be reused once it is saved;
+  // the ones freed after it may still be in it.
+  std::vector<char> buffer;
+  std::vector<std::pair<uint32_t, uint64_t>> released_runs;
+  {
+    std::scoped_lock scoped_db_io_latch(db_io_latch_);
+    if (!page_map_dirty_) {
+      return;
+    }
+    buffer.resize(sizeof(uint32_t) * 4 + page_map_.size() * sizeof(PageExtent));
+    uint32_t header[4] = {PAGE_MAP_MAGIC, static_cast<uint32_t>(page_size_), static_cast<uint32_t>(page_map_.size()),
+                          COMPRESSED_PAGE_GRANULE};
+    memcpy(buffer.data(), header, sizeof(header));
+    memcpy(buffer.data() + sizeof(header), page_map_.data(), page_map_.size() * sizeof(PageExtent));
+    page_map_dirty_ = false;
+    released_runs.swap(pending_free_runs_);
+  }
+
+  // The snapshot only points at runs whose writes have completed, and they must be durable before it is.
+  DiskManager::SyncPages();
+  bool saved = WritePageMapFile(buffer);
+
+  std::scoped_lock scoped_db_io_latch(db_io_latch_);
+  if (!saved) {
+    LOG_DEBUG("I/O error while writing the page map");
+    page_map_dirty_ = true;
+    pending_free_runs_.insert(pending_free_runs_.end(), released_runs.begin(), released_runs.end());
+    return;
+  }
+  for (auto [granules, offset] : released_runs) {
+    if (run_readers_.count(offset) > 0) {
+      retired_runs_.emplace(offset, granules);
+    } else {
+      free_runs_.emplace(granules, offset);
+    }
+  }
+}
+
+auto DiskManagerCompressed::WritePageMapFile(const std::vector<char> &buffer) -> bool {
+  // The new map must be on disk before it replaces the old one, and the rename must be on disk before the runs the old
+  // map still points at are reused.
+  auto temp_name = page_map_name_ + ".tmp";
+  int fd = open(temp_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return false;
+  }
+  bool written = PwriteFull(fd, buffer.data(), buffer.size(), 0) == buffer.size() && fsync(fd) == 0;
+  close(fd);
+  if (!written || std::rename(temp_name.c_str(), page_map_name_.c_str()) != 0) {
+    return false;
+  }
+  auto slash = page_map_name_.rfind('/');
+  int dir_fd = open(slash == std::string::npos ? "." : page_map_name_.substr(0, slash + 1).c_str(), O_RDONLY);
+  bool renamed = dir_fd >= 0 && fsync(dir_fd) == 0;
+  if (dir_fd >= 0) {
+    close(dir_fd);
+  }
+  return renamed;
+}
+
+void DiskManagerCompressed::ReleaseRun(uint64_t offset) {
+  auto it = run_readers_.find(offset);
+  if (--it->second > 0) {
+    return;
+  }
+  run_readers_.erase(it);
+  auto retired = retired_runs_.find(offset);
+  if (retired != retired_runs_.end()) {
+    free_runs_.emplace(retired->second, offset);
+    retired_runs_.erase(retired);
+  }
+}
+
+auto DiskManagerCompressed::AllocateGranules(uint32_t granules) -> uint64_t {
+  auto it = free_runs_.lower_bound(granules);
+  if (it == free_runs_.end()) {
+    uint64_t offset = end_offset_;
+    end_offset_ += granules * COMPRESSED_PAGE_GRANULE;
+    return offset;
+  }
+  auto [run_granules, offset] = *it;
+  free_runs_.erase(it);
+  if (run_granules > granules) {
+    free_runs_.emplace(run_granules - granules, offset + granules * COMPRESSED_PAGE_GRANULE);
+  }
+  return offset;
+}
+
+void DiskManagerCompressed::WritePage(page_id_t page_id, const char *page_data) {
+  // Compress before taking the latch, so that several threads can compress at once. A page that does not get smaller
+  // is stored as it is, which a length of page_size_ tells apart.
+  std::vector<char> compressed(page_size_);
+  size_t length = CompressionUtil::Compress(page_data, page_size_, compressed.data(), page_size_ - 1);
+  const char *data = compressed.data();
+  if (length == 0) {
+    data = page_data;
+    length = page_size_;
+  }
+  auto granules = static_cast<uint32_t>((length + COMPRESSED_PAGE_GRANULE - 1) / COMPRESSED_PAGE_GRANULE);
+
+  // Write to a fresh run, even if the page would fit in its current one: the page map on disk may point at that run,
+  // and a crash in the middle of overwriting it would leave the page unreadable.
+  uint64_t offset;
+  {
+    std::scoped_lock scoped_db_io_latch(db_io_latch_);
+    offset = AllocateGranules(granules);
+  }
+  num_writes_ += 1;
+  if (PwriteFull(db_fd_, data, length, offset) != length) {
+    LOG_DEBUG("I/O error while writing");
+    // Nothing points at the run, so it can be reused right away; the page keeps its previous version.
+    std::scoped_lock scoped_db_io_latch(db_io_latch_);
+    free_runs_.emplace(granules, offset);
+    return;
+  }
+
+  // The page only moves to its new run once the run holds it, so that a snapshot of the map for a save never points at
+  // a run whose write has not completed. The run it leaves behind is only reused once a newer map has replaced the one
+  // on disk; otherwise a crash could leave this page reading another page's bytes.
+  std::scoped_lock scoped_db_io_latch(db_io_latch_);
+  if (static_cast<size_t>(page_id) >= page_map_.size()) {
+    page_map_.resize(page_id + 1);
+  }
+  auto &extent = page_map_[page_id];
+  if (extent.granules_ > 0) {
+    pending_free_runs_.emplace_back(extent.granules_, extent.offset_);
+  }
+  extent.offset_ = offset;
+  extent.granules_ = granules;
+  extent.length_ = length;
+  page_map_dirty_ = true;
+}
+
+void DiskManagerCompressed::ReadPage(page_id_t page_id, char *page_data) {
+  PageExtent extent;
+  {
+    std::scoped_lock scoped_db_io_latch(db_io_latch_);
+    if (page_id < 0 || static_cast<size_t>(page_id) >= page_map_.size() || page_map_[page_id].granules_ == 0) {
+      LOG_DEBUG("I/O error reading a page that was never written");
+      memset(page_data, 0, page_size_);
+      return;
+    }
+    // Keep the run from being reused while we read it without the latch.
+    extent = page_map_[page_id];
+    run_readers_[extent.offset_]++;
+  }
+  std::vector<char> compressed;
+  char *buffer = page_data;
+  if (extent.length_ != page_size_) {
+    compressed.resize(extent.length_);
+    buffer = compressed.data();
+  }
+  bool read = PreadFull(db_fd_, buffer, extent.length_, extent.offset_) == extent.length_;
+  {
+    std::scoped_lock scoped_db_io_latch(db_io_latch_);
+    ReleaseRun(extent.offset_);
+  }
+  if (!read) {
+    LOG_DEBUG("I/O error while reading");
+    memset(page_data, 0, page_size_);
+    return;
+  }
+  if (compressed.empty()) {
+    return;
+  }
+  if (!CompressionUtil::Decompress(compressed.data(), compressed.size(), page_data, page_size_)) {
+    throw Exception(fmt::format("page {} of {} is corrupted", page_id, file_name_));
+  }
+}
+
+auto DiskManagerCompressed::GetFileBytes() -> uint64_t {
+  std::scoped_lock scoped_db_io_latch(db_io_latch_);
+  return end_offset_;
+}
+
+auto DiskManagerCompressed::GetCompressedBytes() -> uint64_t {
+  std::scoped_lock scoped_db_io_latch(db_io_latch_);
+  uint64_t bytes = 0;
+  for (const auto &extent : page_map_) {
+    bytes += extent.length_;
+  }
+  return bytes;
+}
+
+}  // namespace bustub
@@ -12,10 +12,13 @@
 
 #include "storage/disk/disk_manager_memory.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstddef>
 #include <cstring>
 #include <iostream>
+#include <random>
 #include <string>
 #include <thread>  // NOLINT
 
@@ -27,24 +30,148 @@ namespace bustub {
 /**
  * Constructor: used for memory based manager
  */
-DiskManagerMemory::DiskManagerMemory(size_t pages) { memory_ = new char[pages * BUSTUB_PAGE_SIZE]; }
+DiskManagerMemory::DiskManagerMemory(size_t pages, size_t page_size) {
+  SetPageSize(page_size);
+  memory_ = new char[pages * page_size_];
+}
 
 /**
  * Write the contents of the specified page into disk file
  */
 void DiskManagerMemory::WritePage(page_id_t page_id, const char *page_data) {
-  size_t offset = static_cast<size_t>(page_id) * BUSTUB_PAGE_SIZE;
+  size_t offset = static_cast<size_t>(page_id) * page_size_;
   // set write cursor to offset
   num_writes_ += 1;
-  memcpy(memory_ + offset, page_data, BUSTUB_PAGE_SIZE);
+  memcpy(memory_ + offset, page_data, page_size_);
 }
 
 /**
  * Read the contents of the specified page into the given memory area
  */
 void DiskManagerMemory::ReadPage(page_id_t page_id, char *page_data) {
-  int64_t offset = static_cast<int64_t>(page_id) * BUSTUB_PAGE_SIZE;
-  memcpy(page_data, memory_ + offset, BUSTUB_PAGE_SIZE);
+  int64_t offset = static_cast<int64_t>(page_id) * page_size_;
+  memcpy(page_data, memory_ + offset, page_size_);
+}
+
+auto IoLatency::Fixed(std::chrono::nanoseconds latency) -> IoLatency {
+  IoLatency result;
+  result.distribution_ = latency.count() > 0 ? Distribution::Fixed : Distribution::None;
+  result.min_ = latency;
+  result.max_ = latency;
+  return result;
+}
+
+auto IoLatency::Uniform(std::chrono::nanoseconds min, std::chrono::nanoseconds max) -> IoLatency {
+  if (min > max) {
+    throw Exception(ExceptionType::INVALID, "the minimum latency must not exceed the maximum");
+  }
+  IoLatency result;
+  result.distribution_ = Distribution::Uniform;
+  result.min_ = min;
+  result.max_ = max;
+  return result;
+}
+
+auto IoLatency::HeavyTailed(std::chrono::nanoseconds min, double shape, std::chrono::nanoseconds max) -> IoLatency {
+  if (min > max || shape <= 0) {
+    throw Exception(ExceptionType::INVALID, "a heavy-tailed latency needs a positive shape and min <= max");
+  }
+  IoLatency result;
+  result.distribution_ = Distribution::HeavyTailed;
+  result.min_ = min;
+  result.max_ = max;
+  result.shape_ = shape;
+  return result;
+}
+
+auto IoLatency::Sample() const -> std::chrono::nanoseconds {
+  thread_local std::mt19937_64 gen(std::random_device{}());
+  switch (distribution_) {
+    case Distribution::None:
+      return std::chrono::nanoseconds(0);
+    case Distribution::Fixed:
+      return min_;
+    case Distribution::Uniform:
+      return std::chrono::nanoseconds(
+          std::uniform_int_distribution<std::chrono::nanoseconds::rep>(min_.count(), max_.count())(gen));
+    case Distribution::HeavyTailed: {
+      // Inverse transform sampling of the Pareto distribution: min / u^(1 / shape) for u uniform in (0, 1].
+      double u = 1.0 - std::uniform_real_distribution<double>(0.0, 1.0)(gen);
+      double latency = static_cast<double>(min_.count()) / std::pow(u, 1.0 / shape_);
+      return std::chrono::nanoseconds(static_cast<std::chrono::nanoseconds::rep>(
+          std::min(latency, static_cast<double>(max_.count()))));
+    }
+  }
+  return std::chrono::nanoseconds(0);
+}
+
+void IoLatency::Wait() const {
+  static constexpr std::chrono::microseconds SPIN_LIMIT{100};
+  if (distribution_ == Distribution::None) {
+    return;
+  }
+  auto latency = Sample();
+  if (latency >= SPIN_LIMIT) {
+    std::this_thread::sleep_for(latency);
+    return;
+  }
+  auto deadline = std::chrono::steady_clock::now() + latency;
+  while (std::chrono::steady_clock::now() < deadline) {
+  }
+}
+
+/**
+ * Write the contents of the specified page into memory
+ */
+void DiskManagerUnlimitedMemory::WritePage(page_id_t page_id, const char *page_data) {
+  write_latency_.Wait();
+  auto *page = GetPage(page_id, true);
+  if (page == nullptr) {
+    LOG_WARN("invalid page id");
+    return;
+  }
+  num_writes_ += 1;
+  std::unique_lock page_latch(page->latch_);
+  memcpy(page->data_.data(), page_data, page_size_);
+}
+
+/**
+ * Read the contents of the specified page into the given memory area
+ */
+void DiskManagerUnlimitedMemory::ReadPage(page_id_t page_id, char *page_data) {
+  read_latency_.Wait();
+  auto *page = GetPage(page_id, false);
+  if (page == nullptr) {
+    LOG_WARN("page not exist");
+    return;
+  }
+  std::shared_lock page_latch(page->latch_);
+  memcpy(page_data, page->data_.data(), page_size_);
+}
+
+auto DiskManagerUnlimitedMemory::GetPage(page_id_t page_id, bool create) -> ProtectedPage * {
+  if (page_id < 0) {
+    return nullptr;
+  }
+  auto &shard = shards_[page_id % NUM_SHARDS];
+  size_t slot = page_id / NUM_SHARDS;
+  {
+    std::shared_lock shard_latch(shard.latch_);
+    if (slot < shard.pages_.size() && shard.pages_[slot] != nullptr) {
+      return shard.pages_[slot].get();
+    }
+  }
+  if (!create) {
+    return nullptr;
+  }
+  std::unique_lock shard_latch(shard.latch_);
+  if (slot >= shard.pages_.size()) {
+    shard.pages_.resize(slot + 1);
+  }
+  if (shard.pages_[slot] == nullptr) {
+    shard.pages_[slot] = std::make_unique<ProtectedPage>(page_size_);
+  }
+  return shard.pages_[slot].get();
 }
 
 }  // namespace bustub
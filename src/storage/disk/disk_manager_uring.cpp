@@ -0,0 +1,322 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_uring.cpp
+//
+// Identification: src/storage/disk/disk_manager_uring.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_uring.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef BUSTUB_HAS_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/macros.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+/**
+ * Direct I/O requires buffers, offsets and lengths aligned to the logical block size; pages of any valid size satisfy
+ * all three, as they are multiples of the smallest one.
+ */
+static constexpr size_t DIRECT_IO_ALIGNMENT = BUSTUB_PAGE_SIZE;
+
+struct DiskManagerUring::Ring {
+  Ring(size_t queue_depth, size_t page_size) {
+    void *buffers = nullptr;
+    if (posix_memalign(&buffers, DIRECT_IO_ALIGNMENT, queue_depth * page_size) != 0) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "can't allocate bounce buffers");
+    }
+    bounce_ = static_cast<char *>(buffers);
+  }
+
+  ~Ring() {
+#ifdef BUSTUB_HAS_IO_URING
+    for (auto [ptr, size] : {std::make_pair(sq_ptr_, sq_size_), std::make_pair(cq_ptr_, cq_size_),
+                             std::make_pair(static_cast<void *>(sqes_), sqes_size_)}) {
+      if (ptr != MAP_FAILED) {
+        munmap(ptr, size);
+      }
+    }
+    if (ring_fd_ >= 0) {
+      close(ring_fd_);
+    }
+#endif
+    free(bounce_);
+  }
+
+  DISALLOW_COPY_AND_MOVE(Ring);
+
+  /** Serializes the users of this ring. */
+  std::mutex latch_;
+  /** queue_depth page-aligned buffers for caller buffers that are not aligned. */
+  char *bounce_;
+
+#ifdef BUSTUB_HAS_IO_URING
+  /**
+   * Create the kernel ring and map its submission and completion queues.
+   * @return 0 on success, or the negated errno
+   */
+  auto Setup(unsigned entries) -> int {
+    struct io_uring_params params {};
+    ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (ring_fd_ < 0) {
+      return -errno;
+    }
+    sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    auto map = [this](size_t size, off_t offset) {
+      return mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, offset);
+    };
+    sq_ptr_ = map(sq_size_, IORING_OFF_SQ_RING);
+    cq_ptr_ = map(cq_size_, IORING_OFF_CQ_RING);
+    void *sqes = map(sqes_size_, IORING_OFF_SQES);
+    sqes_ = static_cast<struct io_uring_sqe *>(sqes);
+    if (sq_ptr_ == MAP_FAILED || cq_ptr_ == MAP_FAILED || sqes == MAP_FAILED) {
+      return -errno;
+    }
+    auto *sq = static_cast<char *>(sq_ptr_);
+    sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    auto *cq = static_cast<char *>(cq_ptr_);
+    cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<struct io_uring_cqe *>(cq + params.cq_off.cqes);
+    return 0;
+  }
+
+  /** Queue one I/O at the tail of the submission queue. The kernel sees it at the next Enter(). */
+  void Push(uint8_t opcode, int fd, const struct iovec *iov, uint64_t offset, uint64_t user_data) {
+    // We are the only producer, so the tail only changes under our feet once we publish it.
+    unsigned tail = *sq_tail_;
+    unsigned index = tail & sq_mask_;
+    auto *sqe = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uintptr_t>(iov);
+    sqe->len = 1;
+    sqe->off = offset;
+    sqe->user_data = user_data;
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  }
+
+  /** Take the next completion off the completion queue. @return false if there is none */
+  auto Pop(struct io_uring_cqe *cqe) -> bool {
+    unsigned head = *cq_head_;
+    if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+      return false;
+    }
+    *cqe = cqes_[head & cq_mask_];
+    __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+    return true;
+  }
+
+  /** Submit queued I/Os and optionally wait for completions. @return the number submitted, or the negated errno */
+  auto Enter(unsigned to_submit, unsigned min_complete) -> int {
+    unsigned flags = min_complete > 0 ? IORING_ENTER_GETEVENTS : 0;
+    auto rc = syscall(__NR_io_uring_enter, ring_fd_, to_submit, min_complete, flags, nullptr, 0);
+    return rc < 0 ? -errno : static_cast<int>(rc);
+  }
+
+  /** The ring's file descriptor, -1 until Setup() succeeded. */
+  int ring_fd_{-1};
+  /** The mapped submission queue, completion queue and submission entries, with their sizes. */
+  void *sq_ptr_{MAP_FAILED};
+  void *cq_ptr_{MAP_FAILED};
+  struct io_uring_sqe *sqes_{static_cast<struct io_uring_sqe *>(MAP_FAILED)};
+  size_t sq_size_{0};
+  size_t cq_size_{0};
+  size_t sqes_size_{0};
+  /** Pointers into the shared queues, and the index masks. */
+  unsigned *sq_tail_{nullptr};
+  unsigned *sq_array_{nullptr};
+  unsigned sq_mask_{0};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned cq_mask_{0};
+  struct io_uring_cqe *cqes_{nullptr};
+#endif
+};
+
+DiskManagerUring::DiskManagerUring(const std::string &db_file, size_t num_rings, size_t queue_depth, size_t page_size)
+    : DiskManager(db_file, page_size), queue_depth_(queue_depth) {
+  BUSTUB_ENSURE(num_rings > 0 && queue_depth > 0, "DiskManagerUring needs at least one ring of one entry");
+
+  // Not every file system supports O_DIRECT (e.g. tmpfs), so retry with the page cache in that case.
+  fd_ = open(db_file.c_str(), O_RDWR | O_CREAT | O_DIRECT, 0644);
+  direct_io_ = fd_ >= 0;
+  if (fd_ < 0 && errno == EINVAL) {
+    fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
+  }
+  if (fd_ < 0) {
+    throw Exception(fmt::format("can't open db file: {}", strerror(errno)));
+  }
+
+  use_io_uring_ = true;
+  for (size_t i = 0; i < num_rings; i++) {
+    auto ring = std::make_unique<Ring>(queue_depth_, page_size_);
+#ifdef BUSTUB_HAS_IO_URING
+    if (use_io_uring_) {
+      int rc = ring->Setup(queue_depth_);
+      if (rc != 0) {
+        LOG_WARN("io_uring is unavailable (%s), falling back to pread/pwrite", strerror(-rc));
+      }
+      use_io_uring_ = rc == 0;
+    }
+#else
+    use_io_uring_ = false;
+#endif
+    rings_.emplace_back(std::move(ring));
+  }
+}
+
+DiskManagerUring::~DiskManagerUring() {
+  rings_.clear();
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+void DiskManagerUring::WritePage(page_id_t page_id, const char *page_data) {
+  // The page is only read from, but PageIo carries one pointer for both directions.
+  SubmitBatch({{/*is_write=*/true, page_id, const_cast<char *>(page_data)}});  // NOLINT
+}
+
+void DiskManagerUring::ReadPage(page_id_t page_id, char *page_data) {
+  SubmitBatch({{/*is_write=*/false, page_id, page_data}});
+}
+
+void DiskManagerUring::SubmitBatch(const std::vector<PageIo> &batch) {
+  auto [ring, lock] = AcquireRing();
+  for (size_t start = 0; start < batch.size(); start += queue_depth_) {
+    SubmitOnRing(ring, batch.data() + start, std::min(queue_depth_, batch.size() - start));
+  }
+}
+
+auto DiskManagerUring::AcquireRing() -> std::pair<Ring *, std::unique_lock<std::mutex>> {
+  size_t start = next_ring_.fetch_add(1);
+  for (size_t i = 0; i < rings_.size(); i++) {
+    auto *ring = rings_[(start + i) % rings_.size()].get();
+    std::unique_lock lock(ring->latch_, std::try_to_lock);
+    if (lock.owns_lock()) {
+      return {ring, std::move(lock)};
+    }
+  }
+  // Every ring is busy, wait for the one we were assigned.
+  auto *ring = rings_[start % rings_.size()].get();
+  return {ring, std::unique_lock(ring->latch_)};
+}
+
+void DiskManagerUring::SubmitOnRing(Ring *ring, const PageIo *ios, size_t count) {
+  std::vector<char *> buffers(count);
+  std::vector<ssize_t> results(count, 0);
+
+  for (size_t i = 0; i < count; i++) {
+    bool aligned = reinterpret_cast<uintptr_t>(ios[i].data_) % DIRECT_IO_ALIGNMENT == 0;
+    buffers[i] = aligned || !direct_io_ ? ios[i].data_ : ring->bounce_ + i * page_size_;
+    if (ios[i].is_write_) {
+      num_writes_ += 1;
+      if (buffers[i] != ios[i].data_) {
+        memcpy(buffers[i], ios[i].data_, page_size_);
+      }
+    }
+  }
+
+#ifdef BUSTUB_HAS_IO_URING
+  if (use_io_uring_) {
+    // The vectored opcodes are the ones every kernel with io_uring supports.
+    std::vector<struct iovec> iovecs(count);
+    for (size_t i = 0; i < count; i++) {
+      iovecs[i] = {buffers[i], page_size_};
+      auto offset = static_cast<uint64_t>(ios[i].page_id_) * page_size_;
+      ring->Push(ios[i].is_write_ ? IORING_OP_WRITEV : IORING_OP_READV, fd_, &iovecs[i], offset, i);
+    }
+    // Errors leave the ring with I/Os in flight on the caller's buffers, so they cannot be recovered from here. They
+    // reach the issuer through the DiskScheduler, which fails the request's promise with them.
+    size_t submitted = 0;
+    size_t completed = 0;
+    while (completed < count) {
+      struct io_uring_cqe cqe;
+      if (submitted == count && ring->Pop(&cqe)) {
+        results[cqe.user_data] = cqe.res;
+        completed++;
+        continue;
+      }
+      int rc = ring->Enter(count - submitted, submitted == count ? 1 : 0);
+      if (rc == -EINTR || rc == -EAGAIN || rc == -EBUSY) {
+        continue;
+      }
+      if (rc < 0) {
+        throw Exception(fmt::format("io_uring submission failed: {}", strerror(-rc)));
+      }
+      submitted += rc;
+    }
+  }
+#endif
+
+  if (!use_io_uring_) {
+    for (size_t i = 0; i < count; i++) {
+      auto offset = static_cast<off_t>(ios[i].page_id_) * page_size_;
+      results[i] = ios[i].is_write_ ? pwrite(fd_, buffers[i], page_size_, offset)
+                                    : pread(fd_, buffers[i], page_size_, offset);
+      if (results[i] < 0) {
+        results[i] = -errno;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    auto offset = static_cast<size_t>(ios[i].page_id_) * page_size_;
+    // A short write is retried as a whole page, which keeps the buffer, offset and length aligned for direct I/O.
+    if (ios[i].is_write_ && results[i] >= 0 && results[i] < static_cast<ssize_t>(page_size_)) {
+      bool written = PwriteFull(fd_, buffers[i], page_size_, offset) == page_size_;
+      results[i] = written ? static_cast<ssize_t>(page_size_) : -EIO;
+    }
+    if (results[i] < 0) {
+      LOG_DEBUG("I/O error on page %d: %s", ios[i].page_id_, strerror(static_cast<int>(-results[i])));
+      if (!ios[i].is_write_) {
+        memset(ios[i].data_, 0, page_size_);
+      }
+      continue;
+    }
+    if (ios[i].is_write_) {
+      continue;
+    }
+    // if file ends before reading a whole page
+    if (results[i] < static_cast<ssize_t>(page_size_)) {
+      memset(buffers[i] + results[i], 0, page_size_ - results[i]);
+    }
+    if (buffers[i] != ios[i].data_) {
+      memcpy(ios[i].data_, buffers[i], page_size_);
+    }
+  }
+}
+
+}  // namespace bustub
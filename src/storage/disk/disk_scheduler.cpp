@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler.cpp
+//
+// Identification: src/storage/disk/disk_scheduler.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_scheduler.h"
+
+#include <chrono>  // NOLINT
+#include <exception>
+#include <utility>
+
+#include "common/exception.h"
+#include "common/macros.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+DiskScheduler::DiskScheduler(DiskManager *disk_manager, size_t num_workers) : disk_manager_(disk_manager) {
+  BUSTUB_ENSURE(num_workers > 0, "the disk scheduler needs at least one worker");
+  // Spawn the background threads
+  background_threads_.reserve(num_workers);
+  for (size_t i = 0; i < num_workers; ++i) {
+    background_threads_.emplace_back([&] { StartWorkerThread(); });
+  }
+}
+
+DiskScheduler::~DiskScheduler() {
+  // Put one `std::nullopt` per worker in the queue to signal to exit the loop
+  for (size_t i = 0; i < background_threads_.size(); ++i) {
+    request_queue_.Put(std::nullopt);
+  }
+  for (auto &thread : background_threads_) {
+    thread.join();
+  }
+}
+
+void DiskScheduler::Schedule(DiskRequest r) { request_queue_.Put(std::move(r)); }
+
+void DiskScheduler::Schedule(std::vector<DiskRequest> requests) {
+  std::vector<std::optional<DiskRequest>> batch;
+  batch.reserve(requests.size());
+  for (auto &request : requests) {
+    batch.emplace_back(std::move(request));
+  }
+  request_queue_.PutAll(std::move(batch));
+}
+
+void DiskScheduler::StartWorkerThread() {
+  while (auto request = request_queue_.Get()) {
+    auto start = std::chrono::steady_clock::now();
+    // An exception would end the worker thread, and with it the process. The issuer gets it from the future instead.
+    std::exception_ptr error;
+    try {
+      if (request->is_write_) {
+        disk_manager_->WritePage(request->page_id_, request->data_);
+        write_latency_.Record(std::chrono::steady_clock::now() - start);
+      } else {
+        disk_manager_->ReadPage(request->page_id_, request->data_);
+        read_latency_.Record(std::chrono::steady_clock::now() - start);
+      }
+    } catch (...) {
+      error = std::current_exception();
+    }
+    if (request->on_complete_) {
+      request->on_complete_(error == nullptr);
+    }
+    if (error) {
+      request->callback_.set_exception(error);
+    } else {
+      request->callback_.set_value(true);
+    }
+  }
+}
+
+}  // namespace bustub
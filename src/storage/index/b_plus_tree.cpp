@@ -1,5 +1,9 @@
+#include <algorithm>
+#include <cstring>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "common/exception.h"
 #include "common/logger.h"
@@ -26,7 +30,10 @@ BPLUSTREE_TYPE::BPlusTree(std::string name, page_id_t header_page_id, BufferPool
  * Helper function to decide whether current b+tree is empty
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return true; }
+auto BPLUSTREE_TYPE::IsEmpty() const -> bool {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  return guard.As<BPlusTreeHeaderPage>()->root_page_id_ == INVALID_PAGE_ID;
+}
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
@@ -37,12 +44,180 @@ auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return true; }
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn) -> bool {
-  // Declaration of context instance.
-  Context ctx;
-  (void)ctx;
+  ReadPageGuard guard = FindLeafRead(&key);
+  if (!guard.IsValid()) {
+    return false;
+  }
+  ValueType value;
+  if (!guard.As<LeafPage>()->Lookup(key, &value, comparator_)) {
+    return false;
+  }
+  result->push_back(value);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::DescendOptimistic(const KeyType *key, char *buffer, page_id_t *leaf_page_id,
+                                       OptimisticReadGuard *parent_guard, bool *is_root) -> bool {
+  OptimisticReadGuard guard = bpm_->FetchPageOptimistic(header_page_id_);
+  if (!guard.IsValid()) {
+    return false;
+  }
+  page_id_t page_id = guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  *is_root = true;
+  while (guard.Validate()) {
+    if (page_id == INVALID_PAGE_ID) {
+      *leaf_page_id = INVALID_PAGE_ID;
+      return true;
+    }
+    OptimisticReadGuard child_guard = bpm_->FetchPageOptimistic(page_id);
+    if (!child_guard.IsValid()) {
+      return false;
+    }
+    // A concurrent writer can leave any size or offset in the frame, so the page is only interpreted once a copy of
+    // it has been validated.
+    memcpy(buffer, child_guard.GetData(), bpm_->GetPageSize());
+    // The parent is validated after the child's version was taken: only then is the child known to have been the one
+    // the parent routes the key to, and a later change to it shows up when it is validated in turn.
+    if (!child_guard.Validate() || !guard.Validate()) {
+      return false;
+    }
+    auto page = reinterpret_cast<const BPlusTreePage *>(buffer);
+    if (page->IsLeafPage()) {
+      *leaf_page_id = page_id;
+      *parent_guard = guard;
+      return true;
+    }
+    auto internal = reinterpret_cast<const InternalPage *>(buffer);
+    page_id = key == nullptr ? internal->ValueAt(0) : internal->Lookup(*key, comparator_);
+    *is_root = false;
+    guard = child_guard;
+  }
   return false;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafRead(const KeyType *key) -> ReadPageGuard {
+  auto buffer = std::make_unique<char[]>(bpm_->GetPageSize());
+  for (int attempt = 0; attempt < OPTIMISTIC_DESCENT_ATTEMPTS; attempt++) {
+    page_id_t leaf_page_id;
+    OptimisticReadGuard parent_guard;
+    bool is_root;
+    if (!DescendOptimistic(key, buffer.get(), &leaf_page_id, &parent_guard, &is_root)) {
+      continue;
+    }
+    if (leaf_page_id == INVALID_PAGE_ID) {
+      return {};
+    }
+    // Unless its parent is unchanged, the leaf may have been split, merged or deleted since the parent pointed at it.
+    ReadPageGuard guard = bpm_->FetchPageRead(leaf_page_id);
+    if (guard.IsValid() && parent_guard.Validate()) {
+      return guard;
+    }
+  }
+
+  // Too much contention, crab down with read latches instead.
+  ReadPageGuard guard;
+  {
+    ReadPageGuard header_guard = bpm_->FetchPageRead(header_page_id_);
+    page_id_t root_page_id = header_guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+    if (root_page_id == INVALID_PAGE_ID) {
+      return guard;
+    }
+    guard = bpm_->FetchPageRead(root_page_id);
+  }
+  while (!guard.As<BPlusTreePage>()->IsLeafPage()) {
+    auto internal = guard.As<InternalPage>();
+    page_id_t child_page_id = key == nullptr ? internal->ValueAt(0) : internal->Lookup(*key, comparator_);
+    // The child is latched before the move assignment lets go of the parent.
+    guard = bpm_->FetchPageRead(child_page_id);
+  }
+  return guard;
+}
+
+/*****************************************************************************
+ * LATCH CRABBING
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::IsSafe(const BPlusTreePage *page, Operation op, bool is_root) const -> bool {
+  // The root leaf goes away when it becomes empty, the root internal page when it is left with one child.
+  if (page->IsLeafPage()) {
+    auto leaf = reinterpret_cast<const LeafPage *>(page);
+    if (op == Operation::INSERT) {
+      return leaf->IsInsertSafe();
+    }
+    return is_root ? leaf->GetSize() > 1 : leaf->IsRemoveSafe();
+  }
+  auto internal = reinterpret_cast<const InternalPage *>(page);
+  if (op == Operation::INSERT) {
+    return internal->IsInsertSafe();
+  }
+  return is_root ? internal->GetSize() > 2 : internal->IsRemoveSafe();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafOptimistic(const KeyType &key, bool *is_root) -> WritePageGuard {
+  auto buffer = std::make_unique<char[]>(bpm_->GetPageSize());
+  for (int attempt = 0; attempt < OPTIMISTIC_DESCENT_ATTEMPTS; attempt++) {
+    page_id_t leaf_page_id;
+    OptimisticReadGuard parent_guard;
+    if (!DescendOptimistic(&key, buffer.get(), &leaf_page_id, &parent_guard, is_root)) {
+      continue;
+    }
+    if (leaf_page_id == INVALID_PAGE_ID) {
+      return {};
+    }
+    WritePageGuard guard = bpm_->FetchPageWrite(leaf_page_id);
+    if (guard.IsValid() && parent_guard.Validate()) {
+      return guard;
+    }
+  }
+
+  ReadPageGuard header_guard = bpm_->FetchPageRead(header_page_id_);
+  page_id_t page_id = header_guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (page_id == INVALID_PAGE_ID) {
+    return {};
+  }
+  *is_root = true;
+  ReadPageGuard parent_guard = std::move(header_guard);
+  while (true) {
+    ReadPageGuard guard = bpm_->FetchPageRead(page_id);
+    if (guard.As<BPlusTreePage>()->IsLeafPage()) {
+      // Trade the read latch on the leaf for a write latch. The latch on its parent (or on the header page, if the
+      // leaf is the root) keeps anyone from splitting, merging or deleting the leaf in between.
+      guard.Drop();
+      WritePageGuard leaf_guard = bpm_->FetchPageWrite(page_id);
+      parent_guard.Drop();
+      return leaf_guard;
+    }
+    *is_root = false;
+    page_id = guard.As<InternalPage>()->Lookup(key, comparator_);
+    parent_guard = std::move(guard);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::FindLeafPessimistic(const KeyType &key, Operation op, Context &ctx) {
+  ctx.header_page_ = bpm_->FetchPageWrite(header_page_id_);
+  ctx.root_page_id_ = ctx.header_page_->As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (ctx.root_page_id_ == INVALID_PAGE_ID) {
+    return;
+  }
+  ctx.write_set_.push_back(bpm_->FetchPageWrite(ctx.root_page_id_));
+  while (true) {
+    auto &guard = ctx.write_set_.back();
+    auto page = guard.As<BPlusTreePage>();
+    if (IsSafe(page, op, ctx.IsRootPage(guard.PageId()))) {
+      ctx.ReleaseAncestors();
+    }
+    if (page->IsLeafPage()) {
+      return;
+    }
+    page_id_t child_page_id = reinterpret_cast<const InternalPage *>(page)->Lookup(key, comparator_);
+    ctx.write_set_.push_back(bpm_->FetchPageWrite(child_page_id));
+  }
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -55,10 +230,228 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *txn) -> bool {
-  // Declaration of context instance.
+  CheckKeyFits(key);
+  {
+    bool is_root = false;
+    WritePageGuard guard = FindLeafOptimistic(key, &is_root);
+    if (guard.IsValid()) {
+      auto leaf = guard.As<LeafPage>();
+      ValueType old_value;
+      if (leaf->Lookup(key, &old_value, comparator_)) {
+        return false;
+      }
+      if (IsSafe(leaf, Operation::INSERT, is_root)) {
+        guard.AsMut<LeafPage>()->Insert(key, value, comparator_);
+        return true;
+      }
+    }
+  }
+
+  // The leaf is going to split (or the tree is empty): start over holding every latch the split may need.
   Context ctx;
-  (void)ctx;
-  return false;
+  FindLeafPessimistic(key, Operation::INSERT, ctx);
+  if (ctx.root_page_id_ == INVALID_PAGE_ID) {
+    page_id_t root_page_id;
+    auto root_guard = bpm_->NewPageInExtentGuarded(&extent_, &root_page_id);
+    BUSTUB_ENSURE(root_guard.IsValid(), "cannot allocate page");
+    auto root = root_guard.AsMut<LeafPage>();
+    root->Init(leaf_max_size_);
+    root->Insert(key, value, comparator_);
+    ctx.header_page_->AsMut<BPlusTreeHeaderPage>()->root_page_id_ = root_page_id;
+    return true;
+  }
+
+  auto &leaf_guard = ctx.write_set_.back();
+  auto leaf = leaf_guard.AsMut<LeafPage>();
+  if (!leaf->Insert(key, value, comparator_)) {
+    return false;
+  }
+  if (!leaf->IsOverfull()) {
+    return true;
+  }
+
+  page_id_t new_page_id;
+  auto new_guard = bpm_->NewPageInExtentGuarded(&extent_, &new_page_id);
+  BUSTUB_ENSURE(new_guard.IsValid(), "cannot allocate page");
+  auto new_leaf = new_guard.AsMut<LeafPage>();
+  new_leaf->Init(leaf_max_size_);
+  KeyType separator = leaf->MoveHalfTo(new_leaf);
+  leaf->SetNextPageId(new_page_id);
+  page_id_t leaf_page_id = leaf_guard.PageId();
+  new_guard.Drop();
+  ctx.write_set_.pop_back();
+  InsertIntoParent(ctx, separator, leaf_page_id, new_page_id);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::InsertIntoParent(Context &ctx, const KeyType &key, page_id_t left_id, page_id_t right_id) {
+  if (ctx.write_set_.empty()) {
+    // The root split. The header page is still latched, since the root was not safe.
+    page_id_t root_page_id;
+    auto root_guard = bpm_->NewPageInExtentGuarded(&extent_, &root_page_id);
+    BUSTUB_ENSURE(root_guard.IsValid(), "cannot allocate page");
+    auto root = root_guard.AsMut<InternalPage>();
+    root->Init(internal_max_size_);
+    root->PopulateNewRoot(left_id, key, right_id);
+    ctx.header_page_->AsMut<BPlusTreeHeaderPage>()->root_page_id_ = root_page_id;
+    return;
+  }
+
+  auto &parent_guard = ctx.write_set_.back();
+  auto parent = parent_guard.AsMut<InternalPage>();
+  if (parent->HasRoomFor(key)) {
+    parent->InsertNodeAfter(left_id, key, right_id);
+    return;
+  }
+
+  page_id_t new_page_id;
+  auto new_guard = bpm_->NewPageInExtentGuarded(&extent_, &new_page_id);
+  BUSTUB_ENSURE(new_guard.IsValid(), "cannot allocate page");
+  auto new_internal = new_guard.AsMut<InternalPage>();
+  new_internal->Init(internal_max_size_);
+  KeyType separator = parent->InsertAndSplit(left_id, key, right_id, new_internal);
+
+  page_id_t parent_page_id = parent_guard.PageId();
+  new_guard.Drop();
+  ctx.write_set_.pop_back();
+  InsertIntoParent(ctx, separator, parent_page_id, new_page_id);
+}
+
+/*****************************************************************************
+ * BULK LOADING
+ *****************************************************************************/
+/*
+ * Sort the entries, fill leaves from left to right up to fill_factor, then build each internal level from the
+ * separators of the level below until one page is left, the root. If the last page of a level ends up underfull, it is
+ * merged into the page before it or takes entries from it. The pages come from the extent of the tree in the order they
+ * are filled, so the leaves lie next to each other on disk. Each page learns its fences once the next one starts.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BulkLoad(std::vector<MappingType> entries, double fill_factor) {
+  for (const auto &entry : entries) {
+    CheckKeyFits(entry.first);
+  }
+  WritePageGuard header_guard = bpm_->FetchPageWrite(header_page_id_);
+  if (header_guard.As<BPlusTreeHeaderPage>()->root_page_id_ != INVALID_PAGE_ID) {
+    header_guard.Drop();
+    for (const auto &[key, value] : entries) {
+      Insert(key, value);
+    }
+    return;
+  }
+
+  std::stable_sort(entries.begin(), entries.end(),
+                   [this](const MappingType &a, const MappingType &b) { return comparator_(a.first, b.first) < 0; });
+  entries.erase(std::unique(entries.begin(), entries.end(),
+                            [this](const MappingType &a, const MappingType &b) {
+                              return comparator_(a.first, b.first) == 0;
+                            }),
+                entries.end());
+  if (entries.empty()) {
+    return;
+  }
+
+  // The separator before each page of the level just built, and its page id.
+  std::vector<std::pair<KeyType, page_id_t>> level;
+  BasicPageGuard prev_guard;
+  BasicPageGuard guard;
+  KeyType low_fence{};
+  for (size_t i = 0; i < entries.size(); i++) {
+    const auto &[key, value] = entries[i];
+    KeyType separator = key;
+    if (guard.IsValid()) {
+      auto leaf = guard.AsMut<LeafPage>();
+      if (leaf->FillFactor() >= fill_factor || !leaf->CanAppend(key)) {
+        separator = LeafPage::Separator(entries[i - 1].first, key);
+        leaf->SetFences(low_fence, &separator);
+        low_fence = separator;
+        prev_guard = std::move(guard);
+      }
+    }
+    if (!guard.IsValid()) {
+      page_id_t page_id;
+      guard = bpm_->NewPageInExtentGuarded(&extent_, &page_id);
+      BUSTUB_ENSURE(guard.IsValid(), "cannot allocate page");
+      guard.AsMut<LeafPage>()->Init(leaf_max_size_);
+      if (prev_guard.IsValid()) {
+        prev_guard.AsMut<LeafPage>()->SetNextPageId(page_id);
+      }
+      level.emplace_back(separator, page_id);
+    }
+    guard.AsMut<LeafPage>()->Append(key, value);
+  }
+  guard.AsMut<LeafPage>()->SetFences(low_fence, nullptr);
+  if (prev_guard.IsValid() && guard.As<LeafPage>()->IsUnderfull()) {
+    auto prev = prev_guard.AsMut<LeafPage>();
+    auto last = guard.AsMut<LeafPage>();
+    if (prev->CanMergeWith(last)) {
+      last->MoveAllTo(prev);
+      page_id_t last_page_id = guard.PageId();
+      guard.Drop();
+      bpm_->DeletePage(last_page_id);
+      level.pop_back();
+    } else {
+      while (last->IsUnderfull()) {
+        KeyType separator = LeafPage::Separator(prev->KeyAt(prev->GetSize() - 2), prev->KeyAt(prev->GetSize() - 1));
+        if (!prev->MoveLastToFrontOf(last, separator)) {
+          break;
+        }
+        level.back().first = separator;
+      }
+    }
+  }
+  prev_guard.Drop();
+  guard.Drop();
+
+  while (level.size() > 1) {
+    std::vector<std::pair<KeyType, page_id_t>> parent_level;
+    low_fence = KeyType{};
+    for (const auto &[key, child_page_id] : level) {
+      if (guard.IsValid()) {
+        auto internal = guard.AsMut<InternalPage>();
+        if (internal->GetSize() >= 2 && (internal->FillFactor() >= fill_factor || !internal->CanAppend(key))) {
+          internal->SetFences(low_fence, &key);
+          low_fence = key;
+          prev_guard = std::move(guard);
+        }
+      }
+      if (!guard.IsValid()) {
+        page_id_t page_id;
+        guard = bpm_->NewPageInExtentGuarded(&extent_, &page_id);
+        BUSTUB_ENSURE(guard.IsValid(), "cannot allocate page");
+        guard.AsMut<InternalPage>()->Init(internal_max_size_);
+        parent_level.emplace_back(key, page_id);
+      }
+      guard.AsMut<InternalPage>()->Append(key, child_page_id);
+    }
+    guard.AsMut<InternalPage>()->SetFences(low_fence, nullptr);
+    if (prev_guard.IsValid() && guard.As<InternalPage>()->IsUnderfull()) {
+      auto prev = prev_guard.AsMut<InternalPage>();
+      auto last = guard.AsMut<InternalPage>();
+      KeyType middle_key = parent_level.back().first;
+      if (prev->CanMergeWith(last, middle_key)) {
+        last->MoveAllTo(prev, middle_key);
+        page_id_t last_page_id = guard.PageId();
+        guard.Drop();
+        bpm_->DeletePage(last_page_id);
+        parent_level.pop_back();
+      } else {
+        while (last->IsUnderfull()) {
+          KeyType new_middle_key = prev->KeyAt(prev->GetSize() - 1);
+          if (!prev->MoveLastToFrontOf(last, middle_key)) {
+            break;
+          }
+          middle_key = new_middle_key;
+        }
+        parent_level.back().first = middle_key;
+      }
+    }
+    prev_guard.Drop();
+    guard.Drop();
+    level = std::move(parent_level);
+  }
+  header_guard.AsMut<BPlusTreeHeaderPage>()->root_page_id_ = level[0].second;
 }
 
 /*****************************************************************************
@@ -73,9 +466,151 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
-  // Declaration of context instance.
+  {
+    bool is_root = false;
+    WritePageGuard guard = FindLeafOptimistic(key, &is_root);
+    if (!guard.IsValid()) {
+      return;
+    }
+    auto leaf = guard.As<LeafPage>();
+    ValueType old_value;
+    if (!leaf->Lookup(key, &old_value, comparator_)) {
+      return;
+    }
+    if (IsSafe(leaf, Operation::REMOVE, is_root)) {
+      guard.AsMut<LeafPage>()->Remove(key, comparator_);
+      return;
+    }
+  }
+
+  // The leaf is going to underflow: start over holding every latch the merge may need.
   Context ctx;
-  (void)ctx;
+  FindLeafPessimistic(key, Operation::REMOVE, ctx);
+  if (ctx.root_page_id_ == INVALID_PAGE_ID) {
+    return;
+  }
+  if (!ctx.write_set_.back().AsMut<LeafPage>()->Remove(key, comparator_)) {
+    return;
+  }
+  HandleUnderflow(ctx);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::HandleUnderflow(Context &ctx) {
+  auto &guard = ctx.write_set_.back();
+  page_id_t page_id = guard.PageId();
+  auto page = guard.As<BPlusTreePage>();
+
+  if (ctx.IsRootPage(page_id)) {
+    page_id_t new_root_page_id;
+    if (page->IsLeafPage() && page->GetSize() == 0) {
+      new_root_page_id = INVALID_PAGE_ID;
+    } else if (!page->IsLeafPage() && page->GetSize() == 1) {
+      new_root_page_id = reinterpret_cast<const InternalPage *>(page)->ValueAt(0);
+    } else {
+      return;
+    }
+    ctx.header_page_->AsMut<BPlusTreeHeaderPage>()->root_page_id_ = new_root_page_id;
+    ctx.write_set_.pop_back();
+    bpm_->DeletePage(page_id);
+    return;
+  }
+  if (page->IsLeafPage() ? !reinterpret_cast<const LeafPage *>(page)->IsUnderfull()
+                         : !reinterpret_cast<const InternalPage *>(page)->IsUnderfull()) {
+    return;
+  }
+
+  // The page was not safe, so its parent is still latched.
+  WritePageGuard node_guard = std::move(guard);
+  ctx.write_set_.pop_back();
+  auto parent = ctx.write_set_.back().AsMut<InternalPage>();
+  if (parent->GetSize() == 1) {
+    // Only with keys of different lengths: the parent was left with one child when it could not take the separator of
+    // a borrow (see MergeOrBorrow()). The page has no sibling to merge with, so it stays underfull.
+    return;
+  }
+  int index = parent->ValueIndex(page_id);
+  bool merged;
+  if (index > 0) {
+    // Latch the left sibling before the page, to keep the left-to-right order of iterators. Nobody else can get to
+    // the page while its parent is write-latched.
+    node_guard.Drop();
+    WritePageGuard left_guard = bpm_->FetchPageWrite(parent->ValueAt(index - 1));
+    node_guard = bpm_->FetchPageWrite(page_id);
+    merged = MergeOrBorrow(left_guard, node_guard, parent, index, false);
+  } else {
+    WritePageGuard right_guard = bpm_->FetchPageWrite(parent->ValueAt(1));
+    merged = MergeOrBorrow(node_guard, right_guard, parent, 1, true);
+  }
+  if (merged) {
+    HandleUnderflow(ctx);
+  }
+}
+
+/*
+ * The new separator of a borrow lies between the last key of the left page and the first key of the right page
+ * afterwards. It may not fit into the parent if keys differ in length, nor may the entry fit into the page with the
+ * prefix it has afterwards, in which case the page is left underfull.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::MergeOrBorrow(WritePageGuard &left_guard, WritePageGuard &right_guard, InternalPage *parent,
+                                   int right_index, bool borrow_into_left) -> bool {
+  page_id_t right_page_id = right_guard.PageId();
+  if (left_guard.As<BPlusTreePage>()->IsLeafPage()) {
+    auto left = left_guard.AsMut<LeafPage>();
+    auto right = right_guard.AsMut<LeafPage>();
+    if (left->CanMergeWith(right)) {
+      right->MoveAllTo(left);
+      parent->Remove(right_index);
+      right_guard.Drop();
+      bpm_->DeletePage(right_page_id);
+      return true;
+    }
+    while (borrow_into_left ? left->IsUnderfull() : right->IsUnderfull()) {
+      int left_size = left->GetSize();
+      KeyType separator = borrow_into_left
+                              ? LeafPage::Separator(right->KeyAt(0), right->KeyAt(1))
+                              : LeafPage::Separator(left->KeyAt(left_size - 2), left->KeyAt(left_size - 1));
+      if (!parent->CanReplaceKey(right_index, separator)) {
+        break;
+      }
+      if (borrow_into_left ? !right->MoveFirstToEndOf(left, separator) : !left->MoveLastToFrontOf(right, separator)) {
+        break;
+      }
+      parent->SetKeyAt(right_index, separator);
+    }
+    return false;
+  }
+
+  auto left = left_guard.AsMut<InternalPage>();
+  auto right = right_guard.AsMut<InternalPage>();
+  KeyType middle_key = parent->KeyAt(right_index);
+  if (left->CanMergeWith(right, middle_key)) {
+    right->MoveAllTo(left, middle_key);
+    parent->Remove(right_index);
+    right_guard.Drop();
+    bpm_->DeletePage(right_page_id);
+    return true;
+  }
+  while (borrow_into_left ? left->IsUnderfull() : right->IsUnderfull()) {
+    KeyType new_middle_key = borrow_into_left ? right->KeyAt(1) : left->KeyAt(left->GetSize() - 1);
+    if (!parent->CanReplaceKey(right_index, new_middle_key)) {
+      break;
+    }
+    if (borrow_into_left ? !right->MoveFirstToEndOf(left, middle_key) : !left->MoveLastToFrontOf(right, middle_key)) {
+      break;
+    }
+    parent->SetKeyAt(right_index, new_middle_key);
+    middle_key = new_middle_key;
+  }
+  return false;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::CheckKeyFits(const KeyType &key) const {
+  if (!LeafPage::KeyFits(key, leaf_max_size_) || !InternalPage::KeyFits(key, internal_max_size_)) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "the key is too long for the pages of the b+ tree");
+  }
 }
 
 /*****************************************************************************
@@ -87,7 +622,13 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(); }
+auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
+  ReadPageGuard guard = FindLeafRead(nullptr);
+  if (!guard.IsValid()) {
+    return INDEXITERATOR_TYPE();
+  }
+  return INDEXITERATOR_TYPE(bpm_, std::move(guard), 0);
+}
 
 /*
  * Input parameter is low key, find the leaf page that contains the input key
@@ -95,7 +636,14 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE()
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(); }
+auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
+  ReadPageGuard guard = FindLeafRead(&key);
+  if (!guard.IsValid()) {
+    return INDEXITERATOR_TYPE();
+  }
+  int index = guard.As<LeafPage>()->KeyIndex(key, comparator_);
+  return INDEXITERATOR_TYPE(bpm_, std::move(guard), index);
+}
 
 /*
  * Input parameter is void, construct an index iterator representing the end
@@ -109,7 +657,13 @@ auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE();
  * @return Page id of the root of this tree
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t { return 0; }
+auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  return guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReleaseExtent() { bpm_->ReleaseExtent(&extent_); }
 
 /*****************************************************************************
  * UTILITIES AND DEBUG
@@ -344,4 +898,8 @@ template class BPlusTree<GenericKey<32>, RID, GenericComparator<32>>;
 
 template class BPlusTree<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class BPlusTree<NormalizedKey, RID, NormalizedComparator>;
+
+template class BPlusTree<IntegerKey, RID, IntegerComparator>;
+
 }  // namespace bustub
@@ -7,24 +7,51 @@
 
 namespace bustub {
 
-/*
- * NOTE: you can change the destructor/constructor method here
- * set your own input parameters
- */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::IndexIterator() = default;
 
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *bpm, ReadPageGuard guard, int index)
+    : bpm_(bpm), guard_(std::move(guard)), page_id_(guard_.PageId()), index_(index) {
+  SkipExhaustedLeaves();
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::~IndexIterator() = default;  // NOLINT
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::IsEnd() -> bool { throw std::runtime_error("unimplemented"); }
+auto INDEXITERATOR_TYPE::IsEnd() -> bool { return page_id_ == INVALID_PAGE_ID; }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator*() -> const MappingType & { throw std::runtime_error("unimplemented"); }
+auto INDEXITERATOR_TYPE::operator*() -> const MappingType & { return item_; }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & { throw std::runtime_error("unimplemented"); }
+auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
+  index_++;
+  SkipExhaustedLeaves();
+  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::SkipExhaustedLeaves() {
+  while (page_id_ != INVALID_PAGE_ID && index_ >= guard_.As<LeafPage>()->GetSize()) {
+    page_id_t next_page_id = guard_.As<LeafPage>()->GetNextPageId();
+    index_ = 0;
+    if (next_page_id == INVALID_PAGE_ID) {
+      guard_.Drop();
+      page_id_ = INVALID_PAGE_ID;
+      return;
+    }
+    // Latch the next leaf before releasing this one. Leaves are latched left to right only, so this cannot deadlock.
+    auto next_guard = bpm_->FetchPageRead(next_page_id, AccessType::Scan);
+    guard_ = std::move(next_guard);
+    page_id_ = next_page_id;
+  }
+  if (page_id_ != INVALID_PAGE_ID) {
+    auto leaf = guard_.As<LeafPage>();
+    item_ = MappingType{leaf->KeyAt(index_), leaf->ValueAt(index_)};
+  }
+}
 
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
 
@@ -36,4 +63,8 @@ template class IndexIterator<GenericKey<32>, RID, GenericComparator<32>>;
 
 template class IndexIterator<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class IndexIterator<NormalizedKey, RID, NormalizedComparator>;
+
+template class IndexIterator<IntegerKey, RID, IntegerComparator>;
+
 }  // namespace bustub
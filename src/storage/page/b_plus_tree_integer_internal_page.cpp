@@ -0,0 +1,136 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/page/b_plus_tree_integer_internal_page.cpp
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <vector>
+
+#include "storage/page/b_plus_tree_integer_internal_page.h"
+
+namespace bustub {
+/*****************************************************************************
+ * HELPER METHODS AND UTILITIES
+ *****************************************************************************/
+/*
+ * Init method after creating a new internal page
+ * Including set page type, set current size, and set max page size
+ */
+void BPlusTreeIntegerInternalPage::Init(int max_size) { InitInteger(IndexPageType::INTERNAL_PAGE, max_size); }
+
+void BPlusTreeIntegerInternalPage::SetKeyAt(int index, const IntegerKey &key) {
+  BPlusTreeIntegerPage::SetKeyAt(index, key.GetInteger());
+}
+
+/*
+ * Helper method to find the index of the given child, or -1 if it is not a child of this page
+ */
+auto BPlusTreeIntegerInternalPage::ValueIndex(const page_id_t &value) const -> int {
+  const page_id_t *values = Values();
+  const page_id_t *end = values + GetSize();
+  const page_id_t *it = std::find(values, end, value);
+  return it == end ? -1 : static_cast<int>(it - values);
+}
+
+/*
+ * Find the last key that is not greater than key. The first key is invalid and acts as minus infinity.
+ */
+auto BPlusTreeIntegerInternalPage::Lookup(const IntegerKey &key, const IntegerComparator &comparator) const
+    -> page_id_t {
+  return ValueAt(UpperBound(1, key.GetInteger()) - 1);
+}
+
+/*
+ * Size checks of the tree. An internal page splits when it is full and gains another child.
+ */
+auto BPlusTreeIntegerInternalPage::IsInsertSafe() const -> bool { return GetSize() < GetMaxSize(); }
+
+auto BPlusTreeIntegerInternalPage::HasRoomFor(const IntegerKey &key) const -> bool { return GetSize() < GetMaxSize(); }
+
+auto BPlusTreeIntegerInternalPage::IsRemoveSafe() const -> bool { return GetSize() > GetMinSize(); }
+
+auto BPlusTreeIntegerInternalPage::IsUnderfull() const -> bool { return GetSize() < GetMinSize(); }
+
+auto BPlusTreeIntegerInternalPage::CanMergeWith(const BPlusTreeIntegerInternalPage *right,
+                                                const IntegerKey &middle_key) const -> bool {
+  return GetSize() + right->GetSize() <= GetMaxSize();
+}
+
+auto BPlusTreeIntegerInternalPage::CanAppend(const IntegerKey &key) const -> bool { return GetSize() < GetMaxSize(); }
+
+auto BPlusTreeIntegerInternalPage::FillFactor() const -> double {
+  return static_cast<double>(GetSize()) / GetMaxSize();
+}
+
+/*****************************************************************************
+ * INSERTION AND REMOVAL
+ *****************************************************************************/
+void BPlusTreeIntegerInternalPage::PopulateNewRoot(const page_id_t &old_value, const IntegerKey &key,
+                                                   const page_id_t &new_value) {
+  InsertAt(0, 0, old_value);
+  InsertAt(1, key.GetInteger(), new_value);
+}
+
+void BPlusTreeIntegerInternalPage::InsertNodeAfter(const page_id_t &old_value, const IntegerKey &key,
+                                                   const page_id_t &new_value) {
+  InsertAt(ValueIndex(old_value) + 1, key.GetInteger(), new_value);
+}
+
+/*
+ * The page is full. Lay its children out with the new one in buffers and split them from there.
+ */
+auto BPlusTreeIntegerInternalPage::InsertAndSplit(const page_id_t &old_value, const IntegerKey &key,
+                                                  const page_id_t &new_value, BPlusTreeIntegerInternalPage *recipient)
+    -> IntegerKey {
+  std::vector<int64_t> keys(keys_, keys_ + GetSize());
+  std::vector<page_id_t> values(Values(), Values() + GetSize());
+  int index = ValueIndex(old_value) + 1;
+  keys.insert(keys.begin() + index, key.GetInteger());
+  values.insert(values.begin() + index, new_value);
+  int total = static_cast<int>(keys.size());
+  int keep = (total + 1) / 2;
+  std::copy(keys.begin(), keys.begin() + keep, keys_);
+  std::copy(values.begin(), values.begin() + keep, Values());
+  std::copy(keys.begin() + keep, keys.end(), recipient->keys_);
+  std::copy(values.begin() + keep, values.end(), recipient->Values());
+  SetSize(keep);
+  recipient->SetSize(total - keep);
+  return recipient->KeyAt(0);
+}
+
+void BPlusTreeIntegerInternalPage::Append(const IntegerKey &key, const page_id_t &value) {
+  InsertAt(GetSize(), key.GetInteger(), value);
+}
+
+void BPlusTreeIntegerInternalPage::Remove(int index) { RemoveAt(index); }
+
+/*****************************************************************************
+ * MERGE AND REDISTRIBUTE
+ *****************************************************************************/
+void BPlusTreeIntegerInternalPage::MoveAllTo(BPlusTreeIntegerInternalPage *recipient, const IntegerKey &middle_key) {
+  BPlusTreeIntegerPage::SetKeyAt(0, middle_key.GetInteger());
+  MoveTailTo(0, recipient);
+}
+
+auto BPlusTreeIntegerInternalPage::MoveFirstToEndOf(BPlusTreeIntegerInternalPage *recipient,
+                                                    const IntegerKey &middle_key) -> bool {
+  recipient->InsertAt(recipient->GetSize(), middle_key.GetInteger(), ValueAt(0));
+  RemoveAt(0);
+  return true;
+}
+
+auto BPlusTreeIntegerInternalPage::MoveLastToFrontOf(BPlusTreeIntegerInternalPage *recipient,
+                                                     const IntegerKey &middle_key) -> bool {
+  recipient->BPlusTreeIntegerPage::SetKeyAt(0, middle_key.GetInteger());
+  recipient->InsertAt(0, keys_[GetSize() - 1], ValueAt(GetSize() - 1));
+  RemoveAt(GetSize() - 1);
+  return true;
+}
+
+}  // namespace bustub
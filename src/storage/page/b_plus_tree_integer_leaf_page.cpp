@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/page/b_plus_tree_integer_leaf_page.cpp
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_plus_tree_integer_leaf_page.h"
+
+namespace bustub {
+
+/*****************************************************************************
+ * HELPER METHODS AND UTILITIES
+ *****************************************************************************/
+
+/**
+ * Init method after creating a new leaf page
+ * Including set page type, set current size to zero, set next page id and set max size
+ */
+void BPlusTreeIntegerLeafPage::Init(int max_size) { InitInteger(IndexPageType::LEAF_PAGE, max_size); }
+
+/**
+ * Helper methods to set/get next page id
+ */
+auto BPlusTreeIntegerLeafPage::GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+void BPlusTreeIntegerLeafPage::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+auto BPlusTreeIntegerLeafPage::KeyIndex(const IntegerKey &key, const IntegerComparator &comparator) const -> int {
+  return LowerBound(0, key.GetInteger());
+}
+
+auto BPlusTreeIntegerLeafPage::Lookup(const IntegerKey &key, RID *value, const IntegerComparator &comparator) const
+    -> bool {
+  int index = LowerBound(0, key.GetInteger());
+  if (index == GetSize() || keys_[index] != key.GetInteger()) {
+    return false;
+  }
+  *value = ValueAt(index);
+  return true;
+}
+
+/*
+ * Size checks of the tree. A leaf splits when it reaches its max size.
+ */
+auto BPlusTreeIntegerLeafPage::IsInsertSafe() const -> bool { return GetSize() + 1 < GetMaxSize(); }
+
+auto BPlusTreeIntegerLeafPage::IsOverfull() const -> bool { return GetSize() >= GetMaxSize(); }
+
+auto BPlusTreeIntegerLeafPage::IsRemoveSafe() const -> bool { return GetSize() > GetMinSize(); }
+
+auto BPlusTreeIntegerLeafPage::IsUnderfull() const -> bool { return GetSize() < GetMinSize(); }
+
+auto BPlusTreeIntegerLeafPage::CanMergeWith(const BPlusTreeIntegerLeafPage *right) const -> bool {
+  return GetSize() + right->GetSize() < GetMaxSize();
+}
+
+auto BPlusTreeIntegerLeafPage::CanAppend(const IntegerKey &key) const -> bool { return GetSize() + 1 < GetMaxSize(); }
+
+auto BPlusTreeIntegerLeafPage::FillFactor() const -> double {
+  return static_cast<double>(GetSize()) / (GetMaxSize() - 1);
+}
+
+/*****************************************************************************
+ * INSERTION AND REMOVAL
+ *****************************************************************************/
+auto BPlusTreeIntegerLeafPage::Insert(const IntegerKey &key, const RID &value, const IntegerComparator &comparator)
+    -> bool {
+  int index = LowerBound(0, key.GetInteger());
+  if (index < GetSize() && keys_[index] == key.GetInteger()) {
+    return false;
+  }
+  InsertAt(index, key.GetInteger(), value);
+  return true;
+}
+
+auto BPlusTreeIntegerLeafPage::Remove(const IntegerKey &key, const IntegerComparator &comparator) -> bool {
+  int index = LowerBound(0, key.GetInteger());
+  if (index == GetSize() || keys_[index] != key.GetInteger()) {
+    return false;
+  }
+  RemoveAt(index);
+  return true;
+}
+
+void BPlusTreeIntegerLeafPage::Append(const IntegerKey &key, const RID &value) {
+  InsertAt(GetSize(), key.GetInteger(), value);
+}
+
+/*****************************************************************************
+ * SPLIT, MERGE AND REDISTRIBUTE
+ *****************************************************************************/
+auto BPlusTreeIntegerLeafPage::MoveHalfTo(BPlusTreeIntegerLeafPage *recipient) -> IntegerKey {
+  MoveTailTo((GetSize() + 1) / 2, recipient);
+  recipient->SetNextPageId(GetNextPageId());
+  return recipient->KeyAt(0);
+}
+
+void BPlusTreeIntegerLeafPage::MoveAllTo(BPlusTreeIntegerLeafPage *recipient) {
+  MoveTailTo(0, recipient);
+  recipient->SetNextPageId(GetNextPageId());
+}
+
+auto BPlusTreeIntegerLeafPage::MoveFirstToEndOf(BPlusTreeIntegerLeafPage *recipient, const IntegerKey &separator)
+    -> bool {
+  recipient->InsertAt(recipient->GetSize(), keys_[0], ValueAt(0));
+  RemoveAt(0);
+  return true;
+}
+
+auto BPlusTreeIntegerLeafPage::MoveLastToFrontOf(BPlusTreeIntegerLeafPage *recipient, const IntegerKey &separator)
+    -> bool {
+  recipient->InsertAt(0, keys_[GetSize() - 1], ValueAt(GetSize() - 1));
+  RemoveAt(GetSize() - 1);
+  return true;
+}
+
+}  // namespace bustub
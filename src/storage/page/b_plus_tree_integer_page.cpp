@@ -0,0 +1,145 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/page/b_plus_tree_integer_page.cpp
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#if defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/rid.h"
+#include "storage/page/b_plus_tree_integer_page.h"
+
+namespace bustub {
+
+namespace {
+// The number of keys left to binary search for before they are scanned: four cache lines.
+constexpr int SCAN_WINDOW = 32;
+
+// The number of keys in [keys, keys + size) that are less than key.
+auto CountLess(const int64_t *keys, int size, int64_t key) -> int {
+  int count = 0;
+  int i = 0;
+#if defined(__AVX2__)
+  __m256i needle = _mm256_set1_epi64x(key);
+  for (; i + 4 <= size; i += 4) {
+    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i));
+    __m256i less = _mm256_cmpgt_epi64(needle, block);
+    count += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(less)));
+  }
+#elif defined(__SSE4_2__)
+  __m128i needle = _mm_set1_epi64x(key);
+  for (; i + 2 <= size; i += 2) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + i));
+    __m128i less = _mm_cmpgt_epi64(needle, block);
+    count += __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(less)));
+  }
+#endif
+  for (; i < size; i++) {
+    count += keys[i] < key ? 1 : 0;
+  }
+  return count;
+}
+}  // namespace
+
+/*****************************************************************************
+ * HELPER METHODS AND UTILITIES
+ *****************************************************************************/
+template <typename ValueType>
+void BPlusTreeIntegerPage<ValueType>::InitInteger(IndexPageType page_type, int max_size) {
+  SetPageType(page_type);
+  SetSize(0);
+  SetMaxSize(max_size);
+  next_page_id_ = INVALID_PAGE_ID;
+}
+
+template <typename ValueType>
+auto BPlusTreeIntegerPage<ValueType>::KeyAt(int index) const -> IntegerKey {
+  IntegerKey key;
+  key.SetFromInteger(keys_[index]);
+  return key;
+}
+
+template <typename ValueType>
+auto BPlusTreeIntegerPage<ValueType>::ValueAt(int index) const -> ValueType {
+  return Values()[index];
+}
+
+template <typename ValueType>
+void BPlusTreeIntegerPage<ValueType>::SetValueAt(int index, const ValueType &value) {
+  Values()[index] = value;
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+/*
+ * The keys are sorted, so the number of keys less than key in the window is the offset of its lower bound there.
+ */
+template <typename ValueType>
+auto BPlusTreeIntegerPage<ValueType>::LowerBound(int begin, int64_t key) const -> int {
+  int left = begin;
+  int right = GetSize();
+  while (right - left > SCAN_WINDOW) {
+    int mid = left + (right - left) / 2;
+    if (keys_[mid] < key) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  return left + CountLess(keys_ + left, right - left, key);
+}
+
+template <typename ValueType>
+auto BPlusTreeIntegerPage<ValueType>::UpperBound(int begin, int64_t key) const -> int {
+  if (key == INT64_MAX) {
+    return GetSize();
+  }
+  return LowerBound(begin, key + 1);
+}
+
+/*****************************************************************************
+ * KEY AND VALUE ARRAYS
+ *****************************************************************************/
+template <typename ValueType>
+void BPlusTreeIntegerPage<ValueType>::InsertAt(int index, int64_t key, const ValueType &value) {
+  BUSTUB_ASSERT(GetSize() < GetMaxSize(), "no room for the entry");
+  std::move_backward(keys_ + index, keys_ + GetSize(), keys_ + GetSize() + 1);
+  std::move_backward(Values() + index, Values() + GetSize(), Values() + GetSize() + 1);
+  keys_[index] = key;
+  Values()[index] = value;
+  IncreaseSize(1);
+}
+
+template <typename ValueType>
+void BPlusTreeIntegerPage<ValueType>::RemoveAt(int index) {
+  std::move(keys_ + index + 1, keys_ + GetSize(), keys_ + index);
+  std::move(Values() + index + 1, Values() + GetSize(), Values() + index);
+  IncreaseSize(-1);
+}
+
+template <typename ValueType>
+void BPlusTreeIntegerPage<ValueType>::MoveTailTo(int begin, BPlusTreeIntegerPage *recipient) {
+  BUSTUB_ASSERT(recipient->GetSize() + GetSize() - begin <= recipient->GetMaxSize(), "no room for the entries");
+  std::copy(keys_ + begin, keys_ + GetSize(), recipient->keys_ + recipient->GetSize());
+  std::copy(Values() + begin, Values() + GetSize(), recipient->Values() + recipient->GetSize());
+  recipient->IncreaseSize(GetSize() - begin);
+  SetSize(begin);
+}
+
+static_assert(sizeof(BPlusTreeIntegerPage<RID>) == INTEGER_PAGE_HEADER_SIZE);
+static_assert(sizeof(BPlusTreeIntegerPage<page_id_t>) == INTEGER_PAGE_HEADER_SIZE);
+
+template class BPlusTreeIntegerPage<RID>;
+template class BPlusTreeIntegerPage<page_id_t>;
+}  // namespace bustub
@@ -0,0 +1,199 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/page/b_plus_tree_slotted_internal_page.cpp
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <utility>
+#include <vector>
+
+#include "storage/page/b_plus_tree_slotted_internal_page.h"
+
+namespace bustub {
+/*****************************************************************************
+ * HELPER METHODS AND UTILITIES
+ *****************************************************************************/
+/*
+ * Init method after creating a new internal page
+ * Including set page type, set current size, and set max page size
+ */
+void BPlusTreeSlottedInternalPage::Init(int max_size) { InitSlotted(IndexPageType::INTERNAL_PAGE, max_size); }
+
+void BPlusTreeSlottedInternalPage::SetKeyAt(int index, const NormalizedKey &key) {
+  SetKeyBytesAt(index, key);
+}
+
+/*
+ * Helper method to find the index of the given child, or -1 if it is not a child of this page
+ */
+auto BPlusTreeSlottedInternalPage::ValueIndex(const page_id_t &value) const -> int {
+  for (int i = 0; i < GetSize(); i++) {
+    if (ValueAt(i) == value) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/*
+ * Find the last key that is not greater than key. The first key is invalid and acts as minus infinity.
+ */
+auto BPlusTreeSlottedInternalPage::Lookup(const NormalizedKey &key, const NormalizedComparator &comparator) const
+    -> page_id_t {
+  return ValueAt(UpperBound(1, key) - 1);
+}
+
+/*
+ * Size checks of the tree, in bytes. A separator takes up at most an eighth of the page.
+ */
+auto BPlusTreeSlottedInternalPage::IsInsertSafe() const -> bool { return GetFreeBytes() >= GetMaxEntryBytes(); }
+
+auto BPlusTreeSlottedInternalPage::HasRoomFor(const NormalizedKey &key) const -> bool {
+  return GetFreeBytes() >= EntryBytes(SuffixSize(key));
+}
+
+auto BPlusTreeSlottedInternalPage::IsRemoveSafe() const -> bool {
+  return GetUsedBytes() - GetMaxEntryBytes() >= GetMinSize();
+}
+
+/*
+ * The merged page spans the fences of both, so its prefix may be shorter than theirs and its keys longer.
+ */
+auto BPlusTreeSlottedInternalPage::CanMergeWith(const BPlusTreeSlottedInternalPage *right,
+                                                const NormalizedKey &middle_key) const -> bool {
+  EntryList entries = GetEntries();
+  EntryList right_entries = right->GetEntries();
+  right_entries.front().first = middle_key;
+  entries.insert(entries.end(), right_entries.begin(), right_entries.end());
+  NormalizedKey high_fence;
+  bool has_high_fence = right->GetHighFence(&high_fence);
+  int bytes = EncodedBytes(entries, 0, static_cast<int>(entries.size()), GetLowFence(),
+                           has_high_fence ? &high_fence : nullptr);
+  return bytes <= GetUsableBytes();
+}
+
+auto BPlusTreeSlottedInternalPage::CanReplaceKey(int index, const NormalizedKey &key) const -> bool {
+  return GetFreeBytes() + KeySize(index) >= SuffixSize(key);
+}
+
+/*****************************************************************************
+ * INSERTION AND REMOVAL
+ *****************************************************************************/
+void BPlusTreeSlottedInternalPage::PopulateNewRoot(const page_id_t &old_value, const NormalizedKey &key,
+                                                   const page_id_t &new_value) {
+  InsertAt(0, NormalizedKey{}, old_value);
+  InsertAt(1, key, new_value);
+}
+
+void BPlusTreeSlottedInternalPage::InsertNodeAfter(const page_id_t &old_value, const NormalizedKey &key,
+                                                   const page_id_t &new_value) {
+  InsertAt(ValueIndex(old_value) + 1, key, new_value);
+}
+
+/*
+ * The page has no room for key, so lay its entries out with the new one in a buffer and split them from there. The
+ * separator pushed up becomes the fence between the two halves.
+ */
+auto BPlusTreeSlottedInternalPage::InsertAndSplit(const page_id_t &old_value, const NormalizedKey &key,
+                                                  const page_id_t &new_value, BPlusTreeSlottedInternalPage *recipient)
+    -> NormalizedKey {
+  EntryList entries = GetEntries();
+  entries.insert(entries.begin() + ValueIndex(old_value) + 1, {key, new_value});
+
+  std::vector<int> entry_bytes;
+  entry_bytes.reserve(entries.size());
+  for (const auto &[entry_key, entry_value] : entries) {
+    entry_bytes.push_back(EntryBytes(SuffixSize(entry_key)));
+  }
+  int keep = SplitIndex(entry_bytes, 2);
+  NormalizedKey separator = entries[keep].first;
+  entries[keep].first = NormalizedKey{};
+  NormalizedKey high_fence;
+  bool has_high_fence = GetHighFence(&high_fence);
+  recipient->Rebuild(entries, keep, static_cast<int>(entries.size()), separator,
+                     has_high_fence ? &high_fence : nullptr);
+  Rebuild(entries, 0, keep, GetLowFence(), &separator);
+  return separator;
+}
+
+auto BPlusTreeSlottedInternalPage::CanAppend(const NormalizedKey &key) const -> bool {
+  return GetFreeBytes() >= EntryBytes(GetSize() == 0 ? 0 : SuffixSize(key));
+}
+
+void BPlusTreeSlottedInternalPage::Append(const NormalizedKey &key, const page_id_t &value) {
+  InsertAt(GetSize(), GetSize() == 0 ? NormalizedKey{} : key, value);
+}
+
+void BPlusTreeSlottedInternalPage::Remove(int index) {
+  RemoveAt(index);
+  if (index == 0 && GetSize() > 0) {
+    SetKeyBytesAt(0, NormalizedKey{});
+  }
+}
+
+/*****************************************************************************
+ * MERGE AND REDISTRIBUTE
+ *****************************************************************************/
+void BPlusTreeSlottedInternalPage::MoveAllTo(BPlusTreeSlottedInternalPage *recipient,
+                                             const NormalizedKey &middle_key) {
+  EntryList entries = recipient->GetEntries();
+  EntryList own_entries = GetEntries();
+  own_entries.front().first = middle_key;
+  entries.insert(entries.end(), own_entries.begin(), own_entries.end());
+  NormalizedKey high_fence;
+  bool has_high_fence = GetHighFence(&high_fence);
+  recipient->Rebuild(entries, 0, static_cast<int>(entries.size()), recipient->GetLowFence(),
+                     has_high_fence ? &high_fence : nullptr);
+  Rebuild({}, 0, 0, GetLowFence(), has_high_fence ? &high_fence : nullptr);
+}
+
+/*
+ * Moving a child moves the fence between the pages, which changes the prefix of both. So both pages are laid out
+ * again, after checking that they fit.
+ */
+auto BPlusTreeSlottedInternalPage::MoveFirstToEndOf(BPlusTreeSlottedInternalPage *recipient,
+                                                    const NormalizedKey &middle_key) -> bool {
+  EntryList left_entries = recipient->GetEntries();
+  EntryList right_entries = GetEntries();
+  left_entries.emplace_back(middle_key, right_entries[0].second);
+  NormalizedKey separator = right_entries[1].first;
+  right_entries[1].first = NormalizedKey{};
+  return Redistribute(left_entries, right_entries, 1, recipient, this, separator);
+}
+
+auto BPlusTreeSlottedInternalPage::MoveLastToFrontOf(BPlusTreeSlottedInternalPage *recipient,
+                                                     const NormalizedKey &middle_key) -> bool {
+  EntryList left_entries = GetEntries();
+  EntryList right_entries = recipient->GetEntries();
+  NormalizedKey separator = left_entries.back().first;
+  right_entries.front().first = middle_key;
+  right_entries.insert(right_entries.begin(), {NormalizedKey{}, left_entries.back().second});
+  left_entries.pop_back();
+  return Redistribute(left_entries, right_entries, 0, this, recipient, separator);
+}
+
+auto BPlusTreeSlottedInternalPage::Redistribute(const EntryList &left_entries, const EntryList &right_entries,
+                                                int right_begin, BPlusTreeSlottedInternalPage *left,
+                                                BPlusTreeSlottedInternalPage *right, const NormalizedKey &separator)
+    -> bool {
+  int left_end = static_cast<int>(left_entries.size());
+  int right_end = static_cast<int>(right_entries.size());
+  NormalizedKey high_fence;
+  bool has_high_fence = right->GetHighFence(&high_fence);
+  const NormalizedKey *right_high_fence = has_high_fence ? &high_fence : nullptr;
+  NormalizedKey low_fence = left->GetLowFence();
+  if (EncodedBytes(left_entries, 0, left_end, low_fence, &separator) > GetUsableBytes() ||
+      EncodedBytes(right_entries, right_begin, right_end, separator, right_high_fence) > GetUsableBytes()) {
+    return false;
+  }
+  left->Rebuild(left_entries, 0, left_end, low_fence, &separator);
+  right->Rebuild(right_entries, right_begin, right_end, separator, right_high_fence);
+  return true;
+}
+
+}  // namespace bustub
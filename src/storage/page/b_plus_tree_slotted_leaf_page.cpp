@@ -0,0 +1,181 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/page/b_plus_tree_slotted_leaf_page.cpp
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <vector>
+
+#include "storage/page/b_plus_tree_slotted_leaf_page.h"
+
+namespace bustub {
+
+/*****************************************************************************
+ * HELPER METHODS AND UTILITIES
+ *****************************************************************************/
+
+/**
+ * Init method after creating a new leaf page
+ * Including set page type, set current size to zero, set next page id and set max size
+ */
+void BPlusTreeSlottedLeafPage::Init(int max_size) { InitSlotted(IndexPageType::LEAF_PAGE, max_size); }
+
+/**
+ * Helper methods to set/get next page id
+ */
+auto BPlusTreeSlottedLeafPage::GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+void BPlusTreeSlottedLeafPage::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+auto BPlusTreeSlottedLeafPage::KeyIndex(const NormalizedKey &key, const NormalizedComparator &comparator) const
+    -> int {
+  return LowerBound(0, key);
+}
+
+auto BPlusTreeSlottedLeafPage::Lookup(const NormalizedKey &key, RID *value,
+                                      const NormalizedComparator &comparator) const -> bool {
+  int index = LowerBound(0, key);
+  if (index == GetSize() || CompareAt(index, key) != 0) {
+    return false;
+  }
+  *value = ValueAt(index);
+  return true;
+}
+
+/*
+ * Size checks of the tree, in bytes. An entry takes up at most an eighth of the page.
+ */
+auto BPlusTreeSlottedLeafPage::IsInsertSafe() const -> bool { return GetFreeBytes() >= 2 * GetMaxEntryBytes(); }
+
+auto BPlusTreeSlottedLeafPage::IsOverfull() const -> bool { return GetFreeBytes() < GetMaxEntryBytes(); }
+
+auto BPlusTreeSlottedLeafPage::IsRemoveSafe() const -> bool {
+  return GetUsedBytes() - GetMaxEntryBytes() >= GetMinSize();
+}
+
+/*
+ * The merged page spans the fences of both, so its prefix may be shorter than theirs and its keys longer.
+ */
+auto BPlusTreeSlottedLeafPage::CanMergeWith(const BPlusTreeSlottedLeafPage *right) const -> bool {
+  EntryList entries = GetEntries();
+  EntryList right_entries = right->GetEntries();
+  entries.insert(entries.end(), right_entries.begin(), right_entries.end());
+  NormalizedKey high_fence;
+  bool has_high_fence = right->GetHighFence(&high_fence);
+  int bytes = EncodedBytes(entries, 0, static_cast<int>(entries.size()), GetLowFence(),
+                           has_high_fence ? &high_fence : nullptr);
+  return bytes <= GetUsableBytes() - GetMaxEntryBytes();
+}
+
+/*****************************************************************************
+ * INSERTION AND REMOVAL
+ *****************************************************************************/
+auto BPlusTreeSlottedLeafPage::Insert(const NormalizedKey &key, const RID &value,
+                                      const NormalizedComparator &comparator) -> bool {
+  int index = LowerBound(0, key);
+  if (index < GetSize() && CompareAt(index, key) == 0) {
+    return false;
+  }
+  BUSTUB_ASSERT(ComparePrefix(key) == 0, "the key does not belong in the page");
+  InsertAt(index, key, value);
+  return true;
+}
+
+auto BPlusTreeSlottedLeafPage::Remove(const NormalizedKey &key, const NormalizedComparator &comparator) -> bool {
+  int index = LowerBound(0, key);
+  if (index == GetSize() || CompareAt(index, key) != 0) {
+    return false;
+  }
+  RemoveAt(index);
+  return true;
+}
+
+auto BPlusTreeSlottedLeafPage::CanAppend(const NormalizedKey &key) const -> bool {
+  return GetFreeBytes() - EntryBytes(SuffixSize(key)) >= GetMaxEntryBytes();
+}
+
+void BPlusTreeSlottedLeafPage::Append(const NormalizedKey &key, const RID &value) { InsertAt(GetSize(), key, value); }
+
+/*****************************************************************************
+ * SPLIT, MERGE AND REDISTRIBUTE
+ *****************************************************************************/
+/*
+ * Both halves take their part of the fences of this page, split at the shortest separator. Their prefixes can only get
+ * longer, so their keys shrink.
+ */
+auto BPlusTreeSlottedLeafPage::MoveHalfTo(BPlusTreeSlottedLeafPage *recipient) -> NormalizedKey {
+  EntryList entries = GetEntries();
+  std::vector<int> entry_bytes;
+  entry_bytes.reserve(entries.size());
+  for (int i = 0; i < GetSize(); i++) {
+    entry_bytes.push_back(EntryBytes(KeySize(i)));
+  }
+  int keep = SplitIndex(entry_bytes, 1);
+  NormalizedKey separator = Separator(entries[keep - 1].first, entries[keep].first);
+  NormalizedKey high_fence;
+  bool has_high_fence = GetHighFence(&high_fence);
+  recipient->Rebuild(entries, keep, static_cast<int>(entries.size()), separator,
+                     has_high_fence ? &high_fence : nullptr);
+  Rebuild(entries, 0, keep, GetLowFence(), &separator);
+  recipient->SetNextPageId(GetNextPageId());
+  return separator;
+}
+
+void BPlusTreeSlottedLeafPage::MoveAllTo(BPlusTreeSlottedLeafPage *recipient) {
+  EntryList entries = recipient->GetEntries();
+  EntryList own_entries = GetEntries();
+  entries.insert(entries.end(), own_entries.begin(), own_entries.end());
+  NormalizedKey high_fence;
+  bool has_high_fence = GetHighFence(&high_fence);
+  recipient->Rebuild(entries, 0, static_cast<int>(entries.size()), recipient->GetLowFence(),
+                     has_high_fence ? &high_fence : nullptr);
+  recipient->SetNextPageId(GetNextPageId());
+  Rebuild({}, 0, 0, GetLowFence(), has_high_fence ? &high_fence : nullptr);
+}
+
+/*
+ * Moving an entry moves the fence between the pages, which changes the prefix of both. So both pages are laid out
+ * again, after checking that neither ends up overfull.
+ */
+auto BPlusTreeSlottedLeafPage::MoveFirstToEndOf(BPlusTreeSlottedLeafPage *recipient, const NormalizedKey &separator)
+    -> bool {
+  EntryList left_entries = recipient->GetEntries();
+  EntryList right_entries = GetEntries();
+  left_entries.push_back(right_entries.front());
+  return Redistribute(left_entries, right_entries, 1, recipient, this, separator);
+}
+
+auto BPlusTreeSlottedLeafPage::MoveLastToFrontOf(BPlusTreeSlottedLeafPage *recipient, const NormalizedKey &separator)
+    -> bool {
+  EntryList left_entries = GetEntries();
+  EntryList right_entries = recipient->GetEntries();
+  right_entries.insert(right_entries.begin(), left_entries.back());
+  left_entries.pop_back();
+  return Redistribute(left_entries, right_entries, 0, this, recipient, separator);
+}
+
+auto BPlusTreeSlottedLeafPage::Redistribute(const EntryList &left_entries, const EntryList &right_entries,
+                                            int right_begin, BPlusTreeSlottedLeafPage *left,
+                                            BPlusTreeSlottedLeafPage *right, const NormalizedKey &separator) -> bool {
+  int left_end = static_cast<int>(left_entries.size());
+  int right_end = static_cast<int>(right_entries.size());
+  NormalizedKey high_fence;
+  bool has_high_fence = right->GetHighFence(&high_fence);
+  const NormalizedKey *right_high_fence = has_high_fence ? &high_fence : nullptr;
+  int max_bytes = GetUsableBytes() - GetMaxEntryBytes();
+  NormalizedKey low_fence = left->GetLowFence();
+  if (EncodedBytes(left_entries, 0, left_end, low_fence, &separator) > max_bytes ||
+      EncodedBytes(right_entries, right_begin, right_end, separator, right_high_fence) > max_bytes) {
+    return false;
+  }
+  left->Rebuild(left_entries, 0, left_end, low_fence, &separator);
+  right->Rebuild(right_entries, right_begin, right_end, separator, right_high_fence);
+  return true;
+}
+
+}  // namespace bustub
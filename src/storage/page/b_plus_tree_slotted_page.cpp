@@ -0,0 +1,380 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/page/b_plus_tree_slotted_page.cpp
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "common/rid.h"
+#include "storage/page/b_plus_tree_slotted_page.h"
+
+namespace bustub {
+
+/*****************************************************************************
+ * HELPER METHODS AND UTILITIES
+ *****************************************************************************/
+namespace {
+auto CommonPrefixSize(const NormalizedKey &a, const NormalizedKey &b) -> int {
+  size_t size = std::min(a.GetSize(), b.GetSize());
+  size_t i = 0;
+  while (i < size && a.GetData()[i] == b.GetData()[i]) {
+    i++;
+  }
+  return static_cast<int>(i);
+}
+
+// The prefix shared by all keys in [low_fence, high_fence). Without a high fence, keys have no common prefix.
+auto FencePrefixSize(const NormalizedKey &low_fence, const NormalizedKey *high_fence) -> int {
+  return high_fence == nullptr ? 0 : CommonPrefixSize(low_fence, *high_fence);
+}
+}  // namespace
+
+template <typename ValueType>
+void BPlusTreeSlottedPage<ValueType>::InitSlotted(IndexPageType page_type, int max_size) {
+  BUSTUB_ASSERT(max_size <= UINT16_MAX, "key offsets are 16 bits");
+  SetPageType(page_type);
+  SetSize(0);
+  SetMaxSize(max_size);
+  next_page_id_ = INVALID_PAGE_ID;
+  heap_begin_ = max_size;
+  key_bytes_ = 0;
+  prefix_size_ = 0;
+  low_fence_size_ = 0;
+  high_fence_size_ = 0;
+  has_high_fence_ = 0;
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::KeyAt(int index) const -> NormalizedKey {
+  std::string data;
+  data.reserve(prefix_size_ + KeySize(index));
+  data.append(reinterpret_cast<const char *>(this) + FencesBegin(), prefix_size_);
+  data.append(KeyData(index), KeySize(index));
+  NormalizedKey key;
+  key.SetFromBytes(data.data(), data.size());
+  return key;
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::ValueAt(int index) const -> ValueType {
+  return slots_[index].value_;
+}
+
+template <typename ValueType>
+void BPlusTreeSlottedPage<ValueType>::SetValueAt(int index, const ValueType &value) {
+  slots_[index].value_ = value;
+}
+
+/*
+ * Helper methods to get the space used by the entries
+ */
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::GetUsedBytes() const -> int {
+  return GetSize() * sizeof(Slot) + key_bytes_ + low_fence_size_ + high_fence_size_;
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::GetFreeBytes() const -> int {
+  return GetUsableBytes() - GetUsedBytes();
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::GetMinSize() const -> int {
+  return GetUsableBytes() / 4;
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::IsUnderfull() const -> bool {
+  return GetUsedBytes() < GetMinSize();
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::FillFactor() const -> double {
+  return static_cast<double>(GetUsedBytes()) / GetUsableBytes();
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::KeyFits(const NormalizedKey &key, int max_size) -> bool {
+  return EntryBytes(key.GetSize()) <= MaxEntryBytes(max_size);
+}
+
+/*****************************************************************************
+ * FENCES AND PREFIX
+ *****************************************************************************/
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::GetLowFence() const -> NormalizedKey {
+  NormalizedKey low_fence;
+  low_fence.SetFromBytes(reinterpret_cast<const char *>(this) + FencesBegin(), low_fence_size_);
+  return low_fence;
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::GetHighFence(NormalizedKey *high_fence) const -> bool {
+  if (has_high_fence_ == 0) {
+    return false;
+  }
+  high_fence->SetFromBytes(reinterpret_cast<const char *>(this) + GetMaxSize() - high_fence_size_, high_fence_size_);
+  return true;
+}
+
+/*
+ * Bulk loading learns the fences of a page only once it is filled. They are an optimization there, so the page keeps
+ * its wider fences if the new ones would not leave room for another entry.
+ */
+template <typename ValueType>
+void BPlusTreeSlottedPage<ValueType>::SetFences(const NormalizedKey &low_fence, const NormalizedKey *high_fence) {
+  EntryList entries = GetEntries();
+  int size = static_cast<int>(entries.size());
+  if (EncodedBytes(entries, 0, size, low_fence, high_fence) > GetUsableBytes() - GetMaxEntryBytes()) {
+    return;
+  }
+  Rebuild(entries, 0, size, low_fence, high_fence);
+}
+
+/*
+ * Any key greater than left and not greater than right separates them. The shortest such key is the common prefix of
+ * the two plus the next byte of right. Separators are only compared bytewise, so they need not be valid keys.
+ */
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::ShortestSeparator(const NormalizedKey &left, const NormalizedKey &right)
+    -> NormalizedKey {
+  size_t size = std::min(static_cast<size_t>(CommonPrefixSize(left, right)) + 1, right.GetSize());
+  NormalizedKey separator;
+  separator.SetFromBytes(right.GetData(), size);
+  return separator;
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::EncodedBytes(const EntryList &entries, int begin, int end,
+                                                   const NormalizedKey &low_fence, const NormalizedKey *high_fence)
+    -> int {
+  int prefix_size = FencePrefixSize(low_fence, high_fence);
+  int bytes = low_fence.GetSize() + (high_fence == nullptr ? 0 : high_fence->GetSize());
+  for (int i = begin; i < end; i++) {
+    int key_size = entries[i].first.GetSize();
+    bytes += EntryBytes(key_size < prefix_size ? 0 : key_size - prefix_size);
+  }
+  return bytes;
+}
+
+/*
+ * The first key of an internal page is invalid, so it comes out empty rather than as the prefix.
+ */
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::GetEntries() const -> EntryList {
+  EntryList entries;
+  entries.reserve(GetSize());
+  for (int i = 0; i < GetSize(); i++) {
+    entries.emplace_back(i == 0 && !IsLeafPage() ? NormalizedKey{} : KeyAt(i), ValueAt(i));
+  }
+  return entries;
+}
+
+template <typename ValueType>
+void BPlusTreeSlottedPage<ValueType>::Rebuild(const EntryList &entries, int begin, int end,
+                                              const NormalizedKey &low_fence, const NormalizedKey *high_fence) {
+  BUSTUB_ASSERT(EncodedBytes(entries, begin, end, low_fence, high_fence) <= GetUsableBytes(), "entries do not fit");
+  SetSize(0);
+  key_bytes_ = 0;
+  prefix_size_ = FencePrefixSize(low_fence, high_fence);
+  low_fence_size_ = low_fence.GetSize();
+  high_fence_size_ = high_fence == nullptr ? 0 : high_fence->GetSize();
+  has_high_fence_ = high_fence == nullptr ? 0 : 1;
+  char *page = reinterpret_cast<char *>(this);
+  memcpy(page + FencesBegin(), low_fence.GetData(), low_fence_size_);
+  if (high_fence != nullptr) {
+    memcpy(page + FencesBegin() + low_fence_size_, high_fence->GetData(), high_fence_size_);
+  }
+  heap_begin_ = FencesBegin();
+  for (int i = begin; i < end; i++) {
+    InsertAt(GetSize(), entries[i].first, entries[i].second);
+  }
+}
+
+/*
+ * Pick the split point whose left half is closest to half of the bytes. Since an entry takes up at most an eighth of
+ * the page, both halves of an overfull page are well above a quarter of it.
+ */
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::SplitIndex(const std::vector<int> &entry_bytes, int min_entries) -> int {
+  int total = 0;
+  for (int bytes : entry_bytes) {
+    total += bytes;
+  }
+  int size = static_cast<int>(entry_bytes.size());
+  int best = min_entries;
+  int best_distance = INT_MAX;
+  int prefix = 0;
+  for (int i = 0; i < size - min_entries; i++) {
+    prefix += entry_bytes[i];
+    int distance = std::abs(2 * prefix - total);
+    if (i + 1 >= min_entries && distance < best_distance) {
+      best = i + 1;
+      best_distance = distance;
+    }
+  }
+  return best;
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::SuffixSize(const NormalizedKey &key) const -> int {
+  int key_size = key.GetSize();
+  return key_size < prefix_size_ ? 0 : key_size - prefix_size_;
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::SuffixData(const NormalizedKey &key) const -> const char * {
+  return key.GetData() + std::min<size_t>(prefix_size_, key.GetSize());
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::ComparePrefix(const NormalizedKey &key) const -> int {
+  size_t size = std::min<size_t>(prefix_size_, key.GetSize());
+  int ret = memcmp(key.GetData(), reinterpret_cast<const char *>(this) + FencesBegin(), size);
+  if (ret != 0 || size == prefix_size_) {
+    return ret;
+  }
+  return -1;
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::CompareSuffixAt(int index, const char *suffix, int suffix_size) const -> int {
+  return NormalizedComparator::Compare(KeyData(index), KeySize(index), suffix, suffix_size);
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::CompareAt(int index, const NormalizedKey &key) const -> int {
+  int ret = ComparePrefix(key);
+  if (ret != 0) {
+    return -ret;
+  }
+  return CompareSuffixAt(index, SuffixData(key), SuffixSize(key));
+}
+
+/*
+ * Keys outside of the prefix sort before or after all keys of the page. Any other key is searched for by its suffix,
+ * so the binary search compares only the bytes after the prefix.
+ */
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::LowerBound(int begin, const NormalizedKey &key) const -> int {
+  int ret = ComparePrefix(key);
+  if (ret != 0) {
+    return ret < 0 ? begin : GetSize();
+  }
+  const char *suffix = SuffixData(key);
+  int suffix_size = SuffixSize(key);
+  int left = begin;
+  int right = GetSize();
+  while (left < right) {
+    int mid = left + (right - left) / 2;
+    if (CompareSuffixAt(mid, suffix, suffix_size) < 0) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  return left;
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::UpperBound(int begin, const NormalizedKey &key) const -> int {
+  int ret = ComparePrefix(key);
+  if (ret != 0) {
+    return ret < 0 ? begin : GetSize();
+  }
+  const char *suffix = SuffixData(key);
+  int suffix_size = SuffixSize(key);
+  int left = begin;
+  int right = GetSize();
+  while (left < right) {
+    int mid = left + (right - left) / 2;
+    if (CompareSuffixAt(mid, suffix, suffix_size) <= 0) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  return left;
+}
+
+/*****************************************************************************
+ * SLOTS AND KEY HEAP
+ *****************************************************************************/
+template <typename ValueType>
+void BPlusTreeSlottedPage<ValueType>::InsertAt(int index, const NormalizedKey &key, const ValueType &value) {
+  int key_size = SuffixSize(key);
+  BUSTUB_ASSERT(GetFreeBytes() >= EntryBytes(key_size), "no room for the entry");
+  int slots_end = SLOTTED_PAGE_HEADER_SIZE + (GetSize() + 1) * sizeof(Slot);
+  if (static_cast<int>(heap_begin_) - key_size < slots_end) {
+    Compact();
+  }
+  heap_begin_ -= key_size;
+  memcpy(reinterpret_cast<char *>(this) + heap_begin_, SuffixData(key), key_size);
+  memmove(slots_ + index + 1, slots_ + index, (GetSize() - index) * sizeof(Slot));
+  slots_[index] = Slot{static_cast<uint16_t>(heap_begin_), static_cast<uint16_t>(key_size), value};
+  key_bytes_ += key_size;
+  IncreaseSize(1);
+}
+
+template <typename ValueType>
+void BPlusTreeSlottedPage<ValueType>::RemoveAt(int index) {
+  key_bytes_ -= slots_[index].size_;
+  memmove(slots_ + index, slots_ + index + 1, (GetSize() - index - 1) * sizeof(Slot));
+  IncreaseSize(-1);
+}
+
+template <typename ValueType>
+void BPlusTreeSlottedPage<ValueType>::SetKeyBytesAt(int index, const NormalizedKey &key) {
+  const char *suffix = SuffixData(key);
+  int key_size = SuffixSize(key);
+  Slot &slot = slots_[index];
+  key_bytes_ -= slot.size_;
+  if (key_size <= slot.size_) {
+    memmove(reinterpret_cast<char *>(this) + slot.offset_, suffix, key_size);
+  } else {
+    // Let the old key go before compacting, so that the new one has all the free space.
+    slot.size_ = 0;
+    BUSTUB_ASSERT(GetFreeBytes() >= key_size, "no room for the key");
+    int slots_end = SLOTTED_PAGE_HEADER_SIZE + GetSize() * sizeof(Slot);
+    if (static_cast<int>(heap_begin_) - key_size < slots_end) {
+      Compact();
+    }
+    heap_begin_ -= key_size;
+    memcpy(reinterpret_cast<char *>(this) + heap_begin_, suffix, key_size);
+    slot.offset_ = heap_begin_;
+  }
+  slot.size_ = key_size;
+  key_bytes_ += key_size;
+}
+
+template <typename ValueType>
+void BPlusTreeSlottedPage<ValueType>::Compact() {
+  std::vector<char> heap(GetMaxSize());
+  uint32_t offset = FencesBegin();
+  for (int i = 0; i < GetSize(); i++) {
+    offset -= slots_[i].size_;
+    memcpy(heap.data() + offset, KeyData(i), slots_[i].size_);
+    slots_[i].offset_ = offset;
+  }
+  memcpy(reinterpret_cast<char *>(this) + offset, heap.data() + offset, FencesBegin() - offset);
+  heap_begin_ = offset;
+}
+
+static_assert(sizeof(BPlusTreeSlottedPage<RID>) == SLOTTED_PAGE_HEADER_SIZE);
+static_assert(sizeof(BPlusTreeSlottedPage<page_id_t>) == SLOTTED_PAGE_HEADER_SIZE);
+
+template class BPlusTreeSlottedPage<RID>;
+template class BPlusTreeSlottedPage<page_id_t>;
+}  // namespace bustub
@@ -1,4 +1,5 @@
 #include "storage/page/page_guard.h"
+#include <atomic>
 #include <utility>
 #include "buffer/buffer_pool_manager.h"
 
@@ -46,16 +47,25 @@ ReadPageGuard::ReadPageGuard(ReadPageGuard &&that) noexcept = default;
 auto ReadPageGuard::operator=(ReadPageGuard &&that) noexcept -> ReadPageGuard & {
   if (this != &that) {
     if (guard_.page_ != nullptr) {
-      guard_.page_->RUnlatch();
+      Unlatch();
     }
     guard_ = std::move(that.guard_);
+    shared_latch_ = std::move(that.shared_latch_);
   }
   return *this;
 }
 
+void ReadPageGuard::Unlatch() {
+  if (shared_latch_ != nullptr) {
+    shared_latch_.reset();
+  } else {
+    guard_.page_->RUnlatch();
+  }
+}
+
 void ReadPageGuard::Drop() {
   if (guard_.page_ != nullptr) {
-    guard_.page_->RUnlatch();
+    Unlatch();
   }
   guard_.Drop();
 }
@@ -91,4 +101,13 @@ WritePageGuard::~WritePageGuard() {
   }
 }  // NOLINT
 
+auto OptimisticReadGuard::Validate() const -> bool {
+  if (page_ == nullptr || (version_ & 1) != 0) {
+    return false;
+  }
+  // Keep the reads done through the guard from being reordered after the version check.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return page_->GetVersion() == version_;
+}
+
 }  // namespace bustub
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
 #include <mutex>  // NOLINT
 #include <utility>
@@ -28,7 +29,7 @@ namespace bustub {
 
 TableHeap::TableHeap(BufferPoolManager *bpm) : bpm_(bpm) {
   // Initialize the first table page.
-  auto guard = bpm->NewPageGuarded(&first_page_id_);
+  auto guard = bpm->NewPageInExtentGuarded(&extent_, &first_page_id_);
   last_page_id_ = first_page_id_;
   auto first_page = guard.AsMut<TablePage>();
   BUSTUB_ASSERT(first_page != nullptr,
@@ -36,13 +37,15 @@ TableHeap::TableHeap(BufferPoolManager *bpm) : bpm_(bpm) {
   first_page->Init();
 }
 
+TableHeap::~TableHeap() { bpm_->ReleaseExtent(&extent_); }
+
 auto TableHeap::InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManager *lock_mgr, Transaction *txn,
                             table_oid_t oid) -> std::optional<RID> {
   std::unique_lock<std::mutex> guard(latch_);
   auto page_guard = bpm_->FetchPageWrite(last_page_id_);
   while (true) {
     auto page = page_guard.AsMut<TablePage>();
-    if (page->GetNextTupleOffset(meta, tuple) != std::nullopt) {
+    if (page->GetNextTupleOffset(meta, tuple, bpm_->GetPageSize()) != std::nullopt) {
       break;
     }
 
@@ -50,7 +53,7 @@ auto TableHeap::InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManag
     BUSTUB_ENSURE(page->GetNumTuples() != 0, "tuple is too large, cannot insert");
 
     page_id_t next_page_id = INVALID_PAGE_ID;
-    auto npg = bpm_->NewPage(&next_page_id);
+    auto npg = bpm_->NewPageInExtent(&extent_, &next_page_id);
     BUSTUB_ENSURE(next_page_id != INVALID_PAGE_ID, "cannot allocate page");
 
     page->SetNextPageId(next_page_id);
@@ -70,7 +73,7 @@ auto TableHeap::InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManag
   auto last_page_id = last_page_id_;
 
   auto page = page_guard.AsMut<TablePage>();
-  auto slot_id = *page->InsertTuple(meta, tuple);
+  auto slot_id = *page->InsertTuple(meta, tuple, bpm_->GetPageSize());
 
   // only allow one insertion at a time, otherwise it will deadlock.
   guard.unlock();
@@ -99,6 +102,44 @@ auto TableHeap::GetTuple(RID rid) -> std::pair<TupleMeta, Tuple> {
   return std::make_pair(meta, std::move(tuple));
 }
 
+auto TableHeap::GetTuples(const std::vector<RID> &rids) -> std::vector<std::pair<TupleMeta, Tuple>> {
+  std::vector<page_id_t> page_ids;
+  page_ids.reserve(rids.size());
+  for (const auto &rid : rids) {
+    page_ids.push_back(rid.GetPageId());
+  }
+  std::sort(page_ids.begin(), page_ids.end());
+  page_ids.erase(std::unique(page_ids.begin(), page_ids.end()), page_ids.end());
+  auto page_guards = bpm_->FetchPagesRead(page_ids);
+
+  std::vector<std::pair<TupleMeta, Tuple>> tuples(rids.size());
+  std::vector<size_t> missed;
+  for (size_t i = 0; i < rids.size(); i++) {
+    auto index = std::lower_bound(page_ids.begin(), page_ids.end(), rids[i].GetPageId()) - page_ids.begin();
+    if (!page_guards[index].IsValid()) {
+      missed.push_back(i);
+      continue;
+    }
+    auto page = page_guards[index].As<TablePage>();
+    auto [meta, tuple] = page->GetTuple(rids[i]);
+    tuple.rid_ = rids[i];
+    tuples[i] = std::make_pair(meta, std::move(tuple));
+  }
+
+  // The buffer pool could not hold all of the pages at once. Let go of them and fetch the rest one at a time.
+  page_guards.clear();
+  for (auto i : missed) {
+    auto page_guard = bpm_->FetchPageRead(rids[i].GetPageId());
+    if (!page_guard.IsValid()) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, fmt::format("can't fetch page {}", rids[i].GetPageId()));
+    }
+    auto [meta, tuple] = page_guard.As<TablePage>()->GetTuple(rids[i]);
+    tuple.rid_ = rids[i];
+    tuples[i] = std::make_pair(meta, std::move(tuple));
+  }
+  return tuples;
+}
+
 auto TableHeap::GetTupleMeta(RID rid) -> TupleMeta {
   auto page_guard = bpm_->FetchPageRead(rid.GetPageId());
   auto page = page_guard.As<TablePage>();
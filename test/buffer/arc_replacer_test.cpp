@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer_test.cpp
+//
+// Identification: test/buffer/arc_replacer_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/arc_replacer.h"
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(ARCReplacerTest, SampleTest) {
+  ARCReplacer arc_replacer(4);
+  int value;
+
+  // Scenario: frames 0, 1 and 2 hold pages 10, 11 and 12. Page 10 is used twice and moves to T2.
+  // T1 = [1, 2], T2 = [0], p = 0.
+  for (int i = 0; i < 3; i++) {
+    arc_replacer.RecordAccess(i, AccessType::Get, 10 + i);
+    arc_replacer.SetEvictable(i, true);
+  }
+  arc_replacer.RecordAccess(0, AccessType::Get, 10);
+  ASSERT_EQ(3, arc_replacer.Size());
+
+  // Scenario: T1 is above its target, so its LRU frame goes first. Page 11 is remembered in B1.
+  ASSERT_EQ(true, arc_replacer.Evict(&value));
+  ASSERT_EQ(1, value);
+
+  // Scenario: a scan touching frame 2 does not move it to T2.
+  arc_replacer.RecordAccess(2, AccessType::Scan, 12);
+
+  // Scenario: page 11 comes back into frame 1. The B1 hit grows the target of T1 to 1 and puts the page into T2.
+  // T1 = [2], T2 = [0, 1], p = 1.
+  arc_replacer.RecordAccess(1, AccessType::Get, 11);
+  arc_replacer.SetEvictable(1, true);
+
+  // Scenario: T1 is at its target, so T2 gives up frames first, and T1 only when T2 has none left.
+  ASSERT_EQ(true, arc_replacer.Evict(&value));
+  ASSERT_EQ(0, value);
+  ASSERT_EQ(true, arc_replacer.Evict(&value));
+  ASSERT_EQ(1, value);
+  ASSERT_EQ(true, arc_replacer.Evict(&value));
+  ASSERT_EQ(2, value);
+  ASSERT_EQ(false, arc_replacer.Evict(&value));
+  ASSERT_EQ(0, arc_replacer.Size());
+}
+
+TEST(ARCReplacerTest, PinTest) {
+  ARCReplacer arc_replacer(4);
+  int value;
+
+  // Scenario: pinned frames are skipped, removed frames are gone.
+  for (int i = 0; i < 4; i++) {
+    arc_replacer.RecordAccess(i, AccessType::Unknown, i);
+  }
+  arc_replacer.SetEvictable(1, true);
+  arc_replacer.SetEvictable(2, true);
+  arc_replacer.SetEvictable(3, true);
+  ASSERT_EQ(3, arc_replacer.Size());
+  arc_replacer.Remove(2);
+  ASSERT_EQ(2, arc_replacer.Size());
+  ASSERT_EQ(true, arc_replacer.Evict(&value));
+  ASSERT_EQ(1, value);
+  ASSERT_EQ(true, arc_replacer.Evict(&value));
+  ASSERT_EQ(3, value);
+  ASSERT_EQ(false, arc_replacer.Evict(&value));
+  arc_replacer.SetEvictable(0, true);
+  ASSERT_EQ(true, arc_replacer.Evict(&value));
+  ASSERT_EQ(0, value);
+}
+
+}  // namespace bustub
@@ -12,11 +12,27 @@
 
 #include "buffer/buffer_pool_manager.h"
 
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
 #include <random>
+#include <set>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
+#include "common/exception.h"
+#include "fmt/format.h"
 #include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/page/space_map_page.h"
+
+#ifdef BUSTUB_ASAN
+#include <sanitizer/asan_interface.h>
+#endif
 
 namespace bustub {
 
@@ -144,4 +160,953 @@ TEST(BufferPoolManagerTest, SampleTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ShardedTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+  const size_t num_shards = 3;
+  const size_t k = 5;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, k, nullptr, num_shards);
+  EXPECT_EQ(num_shards, bpm->GetNumShards());
+
+  // Scenario: We should be able to create new pages until every frame of every shard is pinned, and each page
+  // id should be handed out once.
+  std::set<page_id_t> page_ids;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    page_id_t page_id_temp;
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(page_id_temp, page->GetPageId());
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    page_ids.insert(page_id_temp);
+  }
+  EXPECT_EQ(buffer_pool_size, page_ids.size());
+
+  page_id_t page_id_temp;
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+
+  // Scenario: Unpinning a page makes its frame reusable, even if it belongs to a different shard than the one
+  // NewPage starts from.
+  auto victim = *page_ids.begin();
+  EXPECT_EQ(true, bpm->UnpinPage(victim, true));
+  auto *page = bpm->NewPage(&page_id_temp);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(victim % num_shards, page_id_temp % num_shards);
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+
+  // Scenario: All pages can be fetched back with their content, whichever shard holds them.
+  for (auto page_id : page_ids) {
+    if (page_id != victim) {
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+    }
+  }
+  for (auto page_id : page_ids) {
+    page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->GetData(), fmt::format("page {}", page_id).c_str()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ConcurrentFetchReadsOnceTest) {
+  // Counts the reads that reach the disk.
+  class CountingDiskManager : public DiskManagerUnlimitedMemory {
+   public:
+    void ReadPage(page_id_t page_id, char *page_data) override {
+      num_reads_++;
+      DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+    }
+    std::atomic<int> num_reads_{0};
+  };
+
+  const size_t buffer_pool_size = 4;
+  const size_t num_threads = 8;
+  auto disk_manager = std::make_unique<CountingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < buffer_pool_size * 2; i++) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    page_ids.push_back(page_id);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: The first page has been evicted. Many threads fetching it at once should cause a single disk read,
+  // and all of them should see its content.
+  disk_manager->SetLatency(50);
+  disk_manager->num_reads_ = 0;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_threads; i++) {
+    threads.emplace_back([&bpm, &page_ids] {
+      auto *page = bpm->FetchPage(page_ids[0]);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(0, strcmp(page->GetData(), fmt::format("page {}", page_ids[0]).c_str()));
+      EXPECT_EQ(true, bpm->UnpinPage(page_ids[0], false));
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(1, disk_manager->num_reads_);
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, StatsTest) {
+  const size_t buffer_pool_size = 4;
+  const size_t num_threads = 8;
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < buffer_pool_size * 2; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    page_ids.push_back(page_id);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+  }
+  auto stats = bpm->GetStats();
+  EXPECT_EQ(0, stats.fetches_);
+  EXPECT_EQ(buffer_pool_size, stats.evictions_);
+  EXPECT_EQ(buffer_pool_size, stats.write_backs_);
+  EXPECT_EQ(buffer_pool_size, bpm->GetWriteLatency().Count());
+
+  // Scenario: a hit, then a miss that evicts a dirty page.
+  bpm->ResetStats();
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids.back()));
+  EXPECT_EQ(true, bpm->UnpinPage(page_ids.back(), false));
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[0]));
+  EXPECT_EQ(true, bpm->UnpinPage(page_ids[0], false));
+  stats = bpm->GetStats();
+  EXPECT_EQ(2, stats.fetches_);
+  EXPECT_EQ(1, stats.hits_);
+  EXPECT_EQ(1, stats.misses_);
+  EXPECT_DOUBLE_EQ(0.5, stats.HitRatio());
+  EXPECT_EQ(1, stats.evictions_);
+  EXPECT_EQ(1, stats.write_backs_);
+  EXPECT_EQ(0, stats.pin_waits_);
+  EXPECT_EQ(1, bpm->GetReadLatency().Count());
+  EXPECT_EQ(1, bpm->GetWriteLatency().Count());
+
+  // Scenario: threads fetching a page while another thread reads it wait for that read, and count as hits.
+  bpm->ResetStats();
+  disk_manager->SetLatency(50);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_threads; i++) {
+    threads.emplace_back([&bpm, &page_ids] {
+      ASSERT_NE(nullptr, bpm->FetchPage(page_ids[1]));
+      EXPECT_EQ(true, bpm->UnpinPage(page_ids[1], false));
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  stats = bpm->GetStats();
+  EXPECT_EQ(num_threads, stats.fetches_);
+  EXPECT_EQ(1, stats.misses_);
+  EXPECT_EQ(num_threads - 1, stats.hits_);
+  EXPECT_EQ(num_threads - 1, stats.pin_waits_);
+  EXPECT_LE(32 * 1024, bpm->GetReadLatency().PercentileMicros(50));
+}
+
+TEST(BufferPoolManagerTest, ScanReadAheadTest) {
+  class CountingDiskManager : public DiskManagerUnlimitedMemory {
+   public:
+    void ReadPage(page_id_t page_id, char *page_data) override {
+      num_reads_++;
+      DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+    }
+    std::atomic<int> num_reads_{0};
+  };
+
+  const size_t buffer_pool_size = 8;
+  const size_t read_ahead = 4;
+  auto disk_manager = std::make_unique<CountingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+  bpm->SetReadAhead(read_ahead);
+  // Read-ahead completes in the background, so give it some time before looking at the read count.
+  auto wait_for_reads = [&disk_manager](int num_reads) {
+    for (int i = 0; i < 1000 && disk_manager->num_reads_ < num_reads; i++) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  };
+
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < buffer_pool_size * 2; i++) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    page_ids.push_back(page_id);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: The first pages have been evicted. A point lookup reads just the page it asks for.
+  disk_manager->num_reads_ = 0;
+  auto *page = bpm->FetchPage(page_ids[0]);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(true, bpm->UnpinPage(page_ids[0], false));
+  EXPECT_EQ(1, disk_manager->num_reads_);
+
+  // Scenario: A scan miss additionally starts reading the next pages in the background.
+  page = bpm->FetchPage(page_ids[1], AccessType::Scan);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(true, bpm->UnpinPage(page_ids[1], false));
+  wait_for_reads(2 + read_ahead);
+  EXPECT_EQ(static_cast<int>(2 + read_ahead), disk_manager->num_reads_);
+
+  // Scenario: The prefetched pages are served from the buffer pool with the right content, and the scan keeps
+  // extending the window as it advances.
+  for (size_t i = 2; i < 2 + read_ahead; i++) {
+    page = bpm->FetchPage(page_ids[i], AccessType::Scan);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->GetData(), fmt::format("page {}", page_ids[i]).c_str()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], false));
+  }
+  wait_for_reads(3 + read_ahead);
+  EXPECT_LT(static_cast<int>(2 + read_ahead), disk_manager->num_reads_);
+
+  // Scenario: Pages that were prefetched but never fetched can still be deleted.
+  for (auto page_id : page_ids) {
+    EXPECT_EQ(true, bpm->DeletePage(page_id));
+  }
+}
+
+TEST(BufferPoolManagerTest, ReplacerPolicyTest) {
+  const size_t buffer_pool_size = 10;
+
+  for (auto policy : {ReplacerPolicy::LRUK, ReplacerPolicy::LRU, ReplacerPolicy::Clock, ReplacerPolicy::ARC,
+                      ReplacerPolicy::ClockPro}) {
+    auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 2, nullptr, 1, policy);
+    ASSERT_EQ(policy, bpm->GetReplacerPolicy());
+
+    // Scenario: fill the buffer pool, then no more pages can be created while they are all pinned.
+    std::vector<page_id_t> page_ids;
+    for (size_t i = 0; i < buffer_pool_size; i++) {
+      page_id_t page_id;
+      auto *page = bpm->NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+      page_ids.push_back(page_id);
+    }
+    page_id_t page_id_temp;
+    EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+
+    // Scenario: unpin half of the pages and switch to another policy; only the unpinned pages may be evicted.
+    for (size_t i = 0; i < buffer_pool_size / 2; i++) {
+      EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], true));
+    }
+    bpm->SetReplacerPolicy(policy == ReplacerPolicy::LRUK ? ReplacerPolicy::ARC : ReplacerPolicy::LRUK);
+    for (size_t i = 0; i < buffer_pool_size / 2; i++) {
+      auto *page = bpm->NewPage(&page_id_temp);
+      ASSERT_NE(nullptr, page);
+      page_ids.push_back(page_id_temp);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    }
+    EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+    bpm->SetReplacerPolicy(policy);
+
+    // Scenario: every page keeps its content across evictions.
+    for (size_t i = buffer_pool_size / 2; i < page_ids.size(); i++) {
+      EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], true));
+    }
+    for (auto page_id : page_ids) {
+      auto *page = bpm->FetchPage(page_id, AccessType::Get);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(0, strcmp(page->GetData(), fmt::format("page {}", page_id).c_str()));
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+    }
+  }
+}
+
+TEST(BufferPoolManagerTest, BackgroundWriterTest) {
+  class CountingDiskManager : public DiskManagerUnlimitedMemory {
+   public:
+    void WritePage(page_id_t page_id, const char *page_data) override {
+      num_writes_++;
+      DiskManagerUnlimitedMemory::WritePage(page_id, page_data);
+    }
+    std::atomic<int> num_writes_{0};
+  };
+
+  const size_t buffer_pool_size = 10;
+  auto disk_manager = std::make_unique<CountingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+  // Write back every dirty page, checking often.
+  bpm->StartBackgroundWriter(0.0, std::chrono::milliseconds(1));
+
+  // Scenario: dirty every frame. Pinned pages are left alone, unpinned ones get written back in the background.
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    page_ids.push_back(page_id);
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(0, disk_manager->num_writes_);
+  for (auto page_id : page_ids) {
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+  }
+  for (int i = 0; i < 1000 && disk_manager->num_writes_ < static_cast<int>(buffer_pool_size); i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(static_cast<int>(buffer_pool_size), disk_manager->num_writes_);
+
+  // Scenario: the writer is stopped, and evicting the clean pages costs no writes.
+  bpm->StopBackgroundWriter();
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(static_cast<int>(buffer_pool_size), disk_manager->num_writes_);
+
+  // Scenario: the written pages read back correctly, and pages pinned only by the writer can still be deleted.
+  bpm->StartBackgroundWriter(0.0, std::chrono::milliseconds(1));
+  for (auto page_id : page_ids) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->GetData(), fmt::format("page {}", page_id).c_str()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+    EXPECT_EQ(true, bpm->DeletePage(page_id));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, DeletedPageReuseTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get(), 5);
+
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < 5; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+    page_ids.push_back(page_id);
+  }
+
+  // Scenario: deleted pages are handed out again, lowest first, before the file grows. Deleting a page twice, or a
+  // page that was never allocated, does not hand it out twice.
+  EXPECT_EQ(true, bpm->DeletePage(page_ids[3]));
+  EXPECT_EQ(true, bpm->DeletePage(page_ids[1]));
+  EXPECT_EQ(true, bpm->DeletePage(page_ids[1]));
+  EXPECT_EQ(true, bpm->DeletePage(100));
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(page_ids[1], page_id);
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(page_ids[3], page_id);
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(5, page_id);
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, DeletedPageFetchTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get());
+
+  page_id_t deleted_page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&deleted_page_id));
+  EXPECT_EQ(true, bpm->UnpinPage(deleted_page_id, true));
+  EXPECT_EQ(true, bpm->DeletePage(deleted_page_id));
+
+  // Scenario: a deleted page cannot be fetched, so reallocating its id maps it to exactly one frame.
+  EXPECT_EQ(nullptr, bpm->FetchPage(deleted_page_id));
+  EXPECT_FALSE(bpm->FetchPageOptimistic(deleted_page_id).IsValid());
+  EXPECT_FALSE(bpm->FetchPagesRead({deleted_page_id})[0].IsValid());
+  page_id_t page_id;
+  auto *page = bpm->NewPage(&page_id);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(deleted_page_id, page_id);
+  EXPECT_EQ(page, bpm->FetchPage(page_id));
+  size_t frames = 0;
+  for (size_t i = 0; i < 10; i++) {
+    frames += bpm->GetPages()[i].GetPageId() == page_id ? 1 : 0;
+  }
+  EXPECT_EQ(1, frames);
+  EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, DiskErrorTest) {
+  class FailingDiskManager : public DiskManagerUnlimitedMemory {
+   public:
+    void ReadPage(page_id_t page_id, char *page_data) override {
+      if (fail_reads_) {
+        num_failed_reads_++;
+        throw Exception("injected read error");
+      }
+      DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+    }
+    void WritePage(page_id_t page_id, const char *page_data) override {
+      if (fail_writes_) {
+        throw Exception("injected write error");
+      }
+      DiskManagerUnlimitedMemory::WritePage(page_id, page_data);
+    }
+    std::atomic<bool> fail_reads_{false};
+    std::atomic<bool> fail_writes_{false};
+    std::atomic<int> num_failed_reads_{0};
+  };
+
+  const size_t buffer_pool_size = 2;
+  auto disk_manager = std::make_unique<FailingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < 4; i++) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    page_ids.push_back(page_id);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: a dirty victim that cannot be written back stays in the pool with its data, and so does a page that
+  // cannot be flushed.
+  disk_manager->fail_writes_ = true;
+  EXPECT_EQ(nullptr, bpm->FetchPage(page_ids[0]));
+  EXPECT_EQ(false, bpm->FlushPage(page_ids[3]));
+  for (size_t i = 2; i < 4; i++) {
+    auto *page = bpm->FetchPage(page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->GetData(), fmt::format("page {}", page_ids[i]).c_str()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], false));
+  }
+  disk_manager->fail_writes_ = false;
+  bpm->FlushAllPages();
+
+  // Scenario: failed reads, including those of a read-ahead, are not served as pages, and later fetches of the same
+  // pages neither hang nor see stale frames.
+  disk_manager->fail_reads_ = true;
+  bpm->SetReadAhead(1);
+  EXPECT_EQ(nullptr, bpm->FetchPage(page_ids[0], AccessType::Scan));
+  for (int i = 0; i < 1000 && disk_manager->num_failed_reads_ < 2; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(2, disk_manager->num_failed_reads_);
+  EXPECT_EQ(nullptr, bpm->FetchPage(page_ids[1]));
+  auto guards = bpm->FetchPagesRead({page_ids[0], page_ids[1]});
+  EXPECT_FALSE(guards[0].IsValid());
+  EXPECT_FALSE(guards[1].IsValid());
+  disk_manager->fail_reads_ = false;
+
+  // Scenario: every frame has been given back.
+  for (size_t i = 0; i < 4; i += 2) {
+    auto *first = bpm->FetchPage(page_ids[i]);
+    auto *second = bpm->FetchPage(page_ids[i + 1]);
+    ASSERT_NE(nullptr, first);
+    ASSERT_NE(nullptr, second);
+    EXPECT_EQ(0, strcmp(first->GetData(), fmt::format("page {}", page_ids[i]).c_str()));
+    EXPECT_EQ(0, strcmp(second->GetData(), fmt::format("page {}", page_ids[i + 1]).c_str()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], false));
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[i + 1], false));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, SpaceMapRestartTest) {
+  const std::string db_name = "space_map_test.db";
+  remove(db_name.c_str());
+
+  std::set<page_id_t> page_ids;
+  std::vector<page_id_t> deleted_page_ids;
+  {
+    auto disk_manager = std::make_unique<DiskManager>(db_name);
+    auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get(), 5, nullptr, 2);
+    bpm->LoadSpaceMap();
+    for (int i = 0; i < 20; i++) {
+      page_id_t page_id;
+      ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+      EXPECT_NE(SPACE_MAP_PAGE_ID, page_id);
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+      page_ids.insert(page_id);
+    }
+    for (auto page_id : page_ids) {
+      if (page_id % 3 == 0) {
+        EXPECT_EQ(true, bpm->DeletePage(page_id));
+        deleted_page_ids.push_back(page_id);
+      }
+    }
+    bpm.reset();
+    disk_manager->ShutDown();
+  }
+
+  // Scenario: after a restart, even with a different number of shards, the deleted pages are reused before any new
+  // page is allocated, and no page that is still in use is handed out. The deleted pages that hold the space map on
+  // disk are not reused, so that a crash cannot leave the map pointing into user data.
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  std::vector<char> header_data(BUSTUB_PAGE_SIZE);
+  disk_manager->ReadPage(SPACE_MAP_PAGE_ID, header_data.data());
+  auto *header = reinterpret_cast<SpaceMapHeaderPage *>(header_data.data());
+  ASSERT_EQ(2, header->num_shards_);
+  std::set<page_id_t> trunk_page_ids;
+  for (size_t i = 0; i < header->num_shards_; i++) {
+    if (header->shards_[i].first_trunk_page_id_ != INVALID_PAGE_ID) {
+      trunk_page_ids.insert(header->shards_[i].first_trunk_page_id_);
+    }
+  }
+  EXPECT_FALSE(trunk_page_ids.empty());
+
+  auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get(), 5);
+  bpm->LoadSpaceMap();
+  for (auto deleted_page_id : deleted_page_ids) {
+    if (trunk_page_ids.count(deleted_page_id) > 0) {
+      continue;
+    }
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_EQ(deleted_page_id, page_id);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  for (int i = 0; i < 5; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_EQ(0, page_ids.count(page_id));
+    EXPECT_EQ(0, trunk_page_ids.count(page_id));
+    EXPECT_NE(SPACE_MAP_PAGE_ID, page_id);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  // Once a newer map no longer points at them, the old trunks are free again.
+  bpm->FlushAllPages();
+  for (size_t i = 0; i < trunk_page_ids.size(); i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_EQ(1, trunk_page_ids.count(page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove("space_map_test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, SpaceMapCorruptionTest) {
+  const std::string db_name = "space_map_corruption_test.db";
+  remove(db_name.c_str());
+  {
+    auto disk_manager = std::make_unique<DiskManager>(db_name);
+    auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get(), 5, nullptr, 1);
+    bpm->LoadSpaceMap();
+    std::vector<page_id_t> page_ids;
+    for (int i = 0; i < 10; i++) {
+      page_id_t page_id;
+      ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+      page_ids.push_back(page_id);
+    }
+    for (size_t i = 0; i < page_ids.size(); i += 2) {
+      EXPECT_EQ(true, bpm->DeletePage(page_ids[i]));
+    }
+    bpm.reset();
+    disk_manager->ShutDown();
+  }
+
+  std::vector<char> header_data(BUSTUB_PAGE_SIZE);
+  std::vector<char> trunk_data(BUSTUB_PAGE_SIZE);
+  auto *header = reinterpret_cast<SpaceMapHeaderPage *>(header_data.data());
+  auto *trunk = reinterpret_cast<SpaceMapTrunkPage *>(trunk_data.data());
+  // Damage the map on disk with the given function, and expect loading it to fail.
+  auto expect_corrupted = [&](const std::function<void()> &damage) {
+    auto disk_manager = std::make_unique<DiskManager>(db_name);
+    disk_manager->ReadPage(SPACE_MAP_PAGE_ID, header_data.data());
+    page_id_t trunk_page_id = header->shards_[0].first_trunk_page_id_;
+    ASSERT_NE(INVALID_PAGE_ID, trunk_page_id);
+    disk_manager->ReadPage(trunk_page_id, trunk_data.data());
+    auto saved_header = header_data;
+    auto saved_trunk = trunk_data;
+    damage();
+    disk_manager->WritePage(SPACE_MAP_PAGE_ID, header_data.data());
+    disk_manager->WritePage(trunk_page_id, trunk_data.data());
+    {
+      auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get(), 5, nullptr, 1);
+      EXPECT_THROW(bpm->LoadSpaceMap(), Exception);
+    }
+    disk_manager->WritePage(SPACE_MAP_PAGE_ID, saved_header.data());
+    disk_manager->WritePage(trunk_page_id, saved_trunk.data());
+    disk_manager->ShutDown();
+  };
+
+  // Scenario: a shard count, a trunk size or a trunk chain that cannot be right is reported rather than trusted.
+  expect_corrupted([&] { header->num_shards_ = SpaceMapHeaderPage::MAX_SHARDS + 1; });
+  expect_corrupted([&] { trunk->size_ = SpaceMapTrunkPage::Capacity(BUSTUB_PAGE_SIZE) + 1; });
+  expect_corrupted([&] { trunk->next_trunk_page_id_ = header->shards_[0].first_trunk_page_id_; });
+  expect_corrupted([&] { trunk->next_trunk_page_id_ = 1 << 20; });
+
+  // The undamaged map still loads.
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get(), 5, nullptr, 1);
+  EXPECT_NO_THROW(bpm->LoadSpaceMap());
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove("space_map_corruption_test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, BatchFetchTest) {
+  class CountingDiskManager : public DiskManagerUnlimitedMemory {
+   public:
+    void ReadPage(page_id_t page_id, char *page_data) override {
+      num_reads_++;
+      DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+    }
+    std::atomic<int> num_reads_{0};
+  };
+
+  const size_t buffer_pool_size = 10;
+  auto disk_manager = std::make_unique<CountingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 5, nullptr, 2);
+
+  // Pages 0-9 end up on disk only, pages 10-19 are resident.
+  for (int i = 0; i < 20; i++) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: a batch mixing misses, hits and duplicates reads every missing page exactly once.
+  std::vector<page_id_t> page_ids{7, 15, 2, 7, 19, 4};
+  {
+    auto guards = bpm->FetchPagesRead(page_ids);
+    ASSERT_EQ(page_ids.size(), guards.size());
+    EXPECT_EQ(3, disk_manager->num_reads_);
+    for (size_t i = 0; i < page_ids.size(); i++) {
+      EXPECT_EQ(page_ids[i], guards[i].PageId());
+      EXPECT_EQ(0, strcmp(guards[i].GetData(), fmt::format("page {}", page_ids[i]).c_str()));
+    }
+  }
+  // Scenario: the guards on a duplicate share one read latch, which holds off writers until both are gone.
+  {
+    auto guards = bpm->FetchPagesRead(page_ids);
+    std::atomic<bool> written{false};
+    std::thread writer([&] {
+      auto guard = bpm->FetchPageWrite(7);
+      written = true;
+    });
+    guards[0].Drop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(written);
+    guards[3].Drop();
+    writer.join();
+    EXPECT_TRUE(written);
+  }
+  // Dropping the guards unpinned every page, including both pins of the duplicate.
+  for (int i = 0; i < 20; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: a batch larger than the pool fetches what fits and leaves the other guards empty.
+  std::vector<page_id_t> large_batch;
+  for (page_id_t page_id = 0; page_id < 12; page_id++) {
+    large_batch.push_back(page_id);
+  }
+  auto guards = bpm->FetchPagesRead(large_batch);
+  size_t fetched = 0;
+  for (size_t i = 0; i < large_batch.size(); i++) {
+    if (guards[i].IsValid()) {
+      fetched++;
+      EXPECT_EQ(0, strcmp(guards[i].GetData(), fmt::format("page {}", large_batch[i]).c_str()));
+    }
+  }
+  EXPECT_EQ(buffer_pool_size, fetched);
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, FrameArenaTest) {
+  for (bool huge_pages : {false, true}) {
+    enable_huge_pages = huge_pages;
+    const size_t buffer_pool_size = 600;
+    auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+
+    // The frames are contiguous (but for the red zones) and aligned for direct I/O, and the page metadata sits on
+    // cache lines of its own.
+    auto *pages = bpm->GetPages();
+    for (size_t i = 0; i < buffer_pool_size; i++) {
+      EXPECT_EQ(pages[0].GetData() + i * (BUSTUB_PAGE_SIZE + FRAME_RED_ZONE_SIZE), pages[i].GetData());
+      EXPECT_EQ(0, reinterpret_cast<uintptr_t>(pages[i].GetData()) % 4096);
+      EXPECT_EQ(0, reinterpret_cast<uintptr_t>(&pages[i]) % 64);
+#ifdef BUSTUB_ASAN
+      // An overflow of the page is caught.
+      EXPECT_FALSE(__asan_address_is_poisoned(pages[i].GetData() + BUSTUB_PAGE_SIZE - 1));
+      EXPECT_TRUE(__asan_address_is_poisoned(pages[i].GetData() + BUSTUB_PAGE_SIZE));
+#endif
+    }
+
+    for (size_t i = 0; i < buffer_pool_size * 2; i++) {
+      page_id_t page_id;
+      auto *page = bpm->NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+    }
+    for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(buffer_pool_size * 2); page_id++) {
+      auto guard = bpm->FetchPageRead(page_id);
+      EXPECT_EQ(0, strcmp(guard.GetData(), fmt::format("page {}", page_id).c_str()));
+    }
+  }
+  enable_huge_pages = false;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, WarmUpTest) {
+  class CountingDiskManager : public DiskManager {
+   public:
+    explicit CountingDiskManager(const std::string &db_file) : DiskManager(db_file) {}
+    void ReadPage(page_id_t page_id, char *page_data) override {
+      num_reads_++;
+      DiskManager::ReadPage(page_id, page_data);
+    }
+    std::atomic<int> num_reads_{0};
+  };
+
+  const std::string db_name = "warm_up_test.db";
+  const std::string dump_name = "warm_up_test.bp_dump";
+  remove(db_name.c_str());
+  {
+    auto disk_manager = std::make_unique<DiskManager>(db_name);
+    auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get(), 2);
+    bpm->LoadSpaceMap();
+    for (int i = 0; i < 30; i++) {
+      page_id_t page_id;
+      auto *page = bpm->NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+    }
+    // Pages 21-30 are resident (page 0 holds the space map), and 25, 27 and 29 are the hot ones.
+    for (page_id_t page_id : {25, 27, 29, 25, 27, 29}) {
+      ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+    }
+    bpm->FlushAllPages();
+    ASSERT_TRUE(bpm->DumpResidentPages(dump_name));
+    disk_manager->ShutDown();
+  }
+
+  std::ifstream dump(dump_name);
+  std::vector<page_id_t> dumped_page_ids;
+  for (page_id_t page_id; dump >> page_id;) {
+    dumped_page_ids.push_back(page_id);
+  }
+  ASSERT_EQ(10, dumped_page_ids.size());
+  EXPECT_EQ((std::set<page_id_t>{25, 27, 29}), std::set<page_id_t>(dumped_page_ids.end() - 3, dumped_page_ids.end()));
+
+  // Scenario: a smaller pool warms up with the hottest pages, and keeps the hot ones when new pages come in.
+  auto disk_manager = std::make_unique<CountingDiskManager>(db_name);
+  auto bpm = std::make_unique<BufferPoolManager>(5, disk_manager.get(), 2);
+  bpm->LoadSpaceMap();
+  disk_manager->num_reads_ = 0;
+  EXPECT_EQ(5, bpm->WarmUp(dump_name));
+  EXPECT_EQ(5, disk_manager->num_reads_);
+  for (int i = 0; i < 2; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  for (page_id_t page_id : {25, 27, 29}) {
+    auto guard = bpm->FetchPageRead(page_id);
+    EXPECT_EQ(0, strcmp(guard.GetData(), fmt::format("page {}", page_id).c_str()));
+  }
+  EXPECT_EQ(5, disk_manager->num_reads_);
+  EXPECT_EQ(0, bpm->WarmUp("no_such_file.bp_dump"));
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(dump_name.c_str());
+  remove("warm_up_test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, PageSizeTest) {
+  const std::string db_name = "page_size_test.db";
+  const size_t page_size = 4 * BUSTUB_PAGE_SIZE;
+  remove(db_name.c_str());
+
+  EXPECT_THROW(DiskManager(db_name, BUSTUB_PAGE_SIZE / 2), Exception);
+  EXPECT_THROW(DiskManager(db_name, 3 * BUSTUB_PAGE_SIZE), Exception);
+  EXPECT_THROW(DiskManager(db_name, 2 * BUSTUB_MAX_PAGE_SIZE), Exception);
+
+  std::vector<page_id_t> page_ids;
+  {
+    auto disk_manager = std::make_unique<DiskManager>(db_name, page_size);
+    auto bpm = std::make_unique<BufferPoolManager>(4, disk_manager.get(), 2);
+    bpm->LoadSpaceMap();
+    EXPECT_EQ(page_size, bpm->GetPageSize());
+    for (int i = 0; i < 8; i++) {
+      page_id_t page_id;
+      auto *page = bpm->NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      ASSERT_EQ(page_size, page->GetSize());
+      // Fill the whole page, well past the default page size.
+      std::memset(page->GetData(), 'a' + i, page_size);
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+      page_ids.push_back(page_id);
+    }
+    EXPECT_EQ(true, bpm->DeletePage(page_ids.back()));
+    bpm->FlushAllPages();
+    bpm.reset();
+    disk_manager->ShutDown();
+  }
+
+  // Scenario: the page size asked for when reopening the file is ignored in favour of the one it was created with.
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  EXPECT_EQ(page_size, disk_manager->GetPageSize());
+  auto bpm = std::make_unique<BufferPoolManager>(4, disk_manager.get(), 2);
+  bpm->LoadSpaceMap();
+  for (size_t i = 0; i + 1 < page_ids.size(); i++) {
+    auto guard = bpm->FetchPageRead(page_ids[i]);
+    std::vector<char> expected(page_size, static_cast<char>('a' + i));
+    EXPECT_EQ(0, std::memcmp(expected.data(), guard.GetData(), page_size));
+  }
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(page_ids.back(), page_id);
+  EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove("page_size_test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ExtentTest) {
+  const size_t buffer_pool_size = 20;
+  const size_t num_shards = 4;
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 5, nullptr, num_shards);
+
+  // Scenario: pages of two tables allocated in turns, with other pages in between, each stay contiguous.
+  Extent table_a;
+  Extent table_b;
+  std::vector<page_id_t> pages_a;
+  std::vector<page_id_t> pages_b;
+  std::vector<page_id_t> other_pages;
+  for (int i = 0; i < BUSTUB_EXTENT_SIZE + 6; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPageInExtent(&table_a, &page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+    pages_a.push_back(page_id);
+    if (i < 10) {
+      ASSERT_NE(nullptr, bpm->NewPageInExtent(&table_b, &page_id));
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+      pages_b.push_back(page_id);
+    }
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+    other_pages.push_back(page_id);
+  }
+  for (int i = 1; i < BUSTUB_EXTENT_SIZE; i++) {
+    EXPECT_EQ(pages_a[0] + i, pages_a[i]);
+  }
+  // The table outgrew its first extent and continues in a second one.
+  for (size_t i = BUSTUB_EXTENT_SIZE + 1; i < pages_a.size(); i++) {
+    EXPECT_EQ(pages_a[i - 1] + 1, pages_a[i]);
+  }
+  for (size_t i = 1; i < pages_b.size(); i++) {
+    EXPECT_EQ(pages_b[0] + static_cast<page_id_t>(i), pages_b[i]);
+  }
+  for (auto page_id : other_pages) {
+    EXPECT_FALSE(page_id >= pages_b[0] && page_id < pages_b[0] + BUSTUB_EXTENT_SIZE);
+    EXPECT_FALSE(page_id >= pages_a[0] && page_id < pages_a[0] + BUSTUB_EXTENT_SIZE);
+  }
+
+  // Scenario: pages that an extent reserved but has not handed out can neither be deleted nor fetched.
+  page_id_t next_b = pages_b.back() + 1;
+  EXPECT_EQ(true, bpm->DeletePage(next_b));
+  bpm->SetReadAhead(4);
+  {
+    auto guard = bpm->FetchPageRead(pages_b.back(), AccessType::Scan);
+    EXPECT_EQ(pages_b.back(), guard.PageId());
+  }
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPageInExtent(&table_b, &page_id));
+  EXPECT_EQ(next_b, page_id);
+  EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+
+  // Scenario: released pages go to the shards and are handed out by NewPage again.
+  bpm->ReleaseExtent(&table_b);
+  std::set<page_id_t> reused;
+  for (int i = 0; i < BUSTUB_EXTENT_SIZE; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+    reused.insert(page_id);
+  }
+  for (page_id_t released = next_b + 1; released < pages_b[0] + BUSTUB_EXTENT_SIZE; released++) {
+    EXPECT_EQ(1, reused.count(released));
+  }
+  EXPECT_EQ(0, reused.count(next_b));
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, SpaceMapExtentTest) {
+  const std::string db_name = "space_map_extent_test.db";
+  remove(db_name.c_str());
+
+  const int used = 3;
+  page_id_t extent_start;
+  {
+    auto disk_manager = std::make_unique<DiskManager>(db_name);
+    auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get());
+    bpm->LoadSpaceMap();
+    Extent table;
+    for (int i = 0; i < used; i++) {
+      page_id_t page_id;
+      ASSERT_NE(nullptr, bpm->NewPageInExtent(&table, &page_id));
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+      if (i == 0) {
+        extent_start = page_id;
+      }
+    }
+    // The extent is never released, as when the table is still in use at shutdown.
+    bpm.reset();
+    disk_manager->ShutDown();
+  }
+
+  // Scenario: after a restart, the pages that the extent reserved but did not hand out are free again.
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get());
+  bpm->LoadSpaceMap();
+  std::set<page_id_t> reused;
+  for (int i = used; i < BUSTUB_EXTENT_SIZE; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+    reused.insert(page_id);
+  }
+  for (page_id_t page_id = extent_start + used; page_id < extent_start + BUSTUB_EXTENT_SIZE; page_id++) {
+    EXPECT_EQ(1, reused.count(page_id));
+  }
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove("space_map_extent_test.log");
+}
+
 }  // namespace bustub
@@ -0,0 +1,75 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// clock_pro_replacer_test.cpp
+//
+// Identification: test/buffer/clock_pro_replacer_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/clock_pro_replacer.h"
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(ClockProReplacerTest, SampleTest) {
+  ClockProReplacer clock_pro_replacer(4);
+  int value;
+
+  // Scenario: frames 0, 1 and 2 hold pages 10, 11 and 12. They enter cold and in their test periods.
+  for (int i = 0; i < 3; i++) {
+    clock_pro_replacer.RecordAccess(i, AccessType::Get, 10 + i);
+    clock_pro_replacer.SetEvictable(i, true);
+  }
+  ASSERT_EQ(3, clock_pro_replacer.Size());
+
+  // Scenario: page 10 is reused within its test period, so the cold hand turns it hot instead of evicting it, and
+  // evicts frame 1. Page 11 is still in its test period and is remembered.
+  clock_pro_replacer.RecordAccess(0, AccessType::Get, 10);
+  ASSERT_EQ(true, clock_pro_replacer.Evict(&value));
+  ASSERT_EQ(1, value);
+
+  // Scenario: page 11 comes back into frame 1 and is admitted hot. The cold target grows, so there is room for one
+  // hot frame only and the hot hand turns frame 0 cold again.
+  clock_pro_replacer.RecordAccess(1, AccessType::Get, 11);
+  clock_pro_replacer.SetEvictable(1, true);
+
+  // Scenario: the cold frames go first, the hot frame last.
+  ASSERT_EQ(true, clock_pro_replacer.Evict(&value));
+  ASSERT_EQ(2, value);
+  ASSERT_EQ(true, clock_pro_replacer.Evict(&value));
+  ASSERT_EQ(0, value);
+  ASSERT_EQ(true, clock_pro_replacer.Evict(&value));
+  ASSERT_EQ(1, value);
+  ASSERT_EQ(false, clock_pro_replacer.Evict(&value));
+}
+
+TEST(ClockProReplacerTest, ScanTest) {
+  ClockProReplacer clock_pro_replacer(4);
+  int value;
+
+  // Scenario: frame 0 is part of the working set, frames 1 and 2 are read by a scan, twice.
+  clock_pro_replacer.RecordAccess(0, AccessType::Get, 0);
+  clock_pro_replacer.RecordAccess(1, AccessType::Scan, 1);
+  clock_pro_replacer.RecordAccess(2, AccessType::Scan, 2);
+  clock_pro_replacer.RecordAccess(0, AccessType::Get, 0);
+  clock_pro_replacer.RecordAccess(1, AccessType::Scan, 1);
+  clock_pro_replacer.RecordAccess(2, AccessType::Scan, 2);
+  for (int i = 0; i < 3; i++) {
+    clock_pro_replacer.SetEvictable(i, true);
+  }
+
+  // Scenario: the scanned frames never got a reference bit, so they leave before the working set.
+  ASSERT_EQ(true, clock_pro_replacer.Evict(&value));
+  ASSERT_EQ(1, value);
+  ASSERT_EQ(true, clock_pro_replacer.Evict(&value));
+  ASSERT_EQ(2, value);
+  ASSERT_EQ(true, clock_pro_replacer.Evict(&value));
+  ASSERT_EQ(0, value);
+}
+
+}  // namespace bustub
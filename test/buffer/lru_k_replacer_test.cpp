@@ -95,4 +95,113 @@ TEST(LRUKReplacerTest, SampleTest) {
   ASSERT_EQ(false, lru_replacer.Evict(&value));
   ASSERT_EQ(0, lru_replacer.Size());
 }
+TEST(LRUKReplacerTest, ScanResistanceTest) {
+  LRUKReplacer lru_replacer(8, 2);
+  int value;
+
+  // Scenario: frames 1 and 2 form the working set, frames 3, 4 and 5 are brought in by a scan.
+  lru_replacer.RecordAccess(1, AccessType::Get);
+  lru_replacer.RecordAccess(2, AccessType::Get);
+  lru_replacer.RecordAccess(3, AccessType::Scan);
+  lru_replacer.RecordAccess(4, AccessType::Scan);
+  lru_replacer.RecordAccess(5, AccessType::Scan);
+  for (int i = 1; i <= 5; i++) {
+    lru_replacer.SetEvictable(i, true);
+  }
+  ASSERT_EQ(5, lru_replacer.Size());
+
+  // Scenario: the scan touches frame 3 again and also reads frame 1. Neither access counts as a use: frame 3 stays
+  // at the head of the probationary queue, and frame 1 keeps its history.
+  lru_replacer.RecordAccess(3, AccessType::Scan);
+  lru_replacer.RecordAccess(1, AccessType::Scan);
+
+  // Scenario: a lookup hits frame 4, which promotes it out of the probationary queue with a fresh history.
+  lru_replacer.RecordAccess(4, AccessType::Get);
+
+  // Scanned frames go first, then the LRU-k order of the rest: [1, 2, 4] all have +inf k-distance.
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(3, value);
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(5, value);
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(1, value);
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(2, value);
+
+  // Scenario: a pinned probationary frame is skipped, and can be removed once it is unpinned.
+  lru_replacer.RecordAccess(6, AccessType::Scan);
+  lru_replacer.SetEvictable(6, false);
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(4, value);
+  ASSERT_EQ(false, lru_replacer.Evict(&value));
+  lru_replacer.SetEvictable(6, true);
+  lru_replacer.Remove(6);
+  ASSERT_EQ(0, lru_replacer.Size());
+}
+
+TEST(LRUKReplacerTest, KDistanceOrderTest) {
+  LRUKReplacer lru_replacer(4, 2);
+  int value;
+
+  // Scenario: access frames at timestamps 0:[1, 4, 8], 1:[2, 5], 2:[3, 6, 7], 3:[9]. Frames 0 and 2 have more than
+  // k accesses, so only their last two count: the k-th most recent accesses are 0:4, 1:2, 2:6.
+  for (int frame_id : {0, 1, 2, 0, 1, 2, 2, 0, 3}) {
+    lru_replacer.RecordAccess(frame_id);
+  }
+  for (int i = 0; i < 4; i++) {
+    lru_replacer.SetEvictable(i, true);
+  }
+  ASSERT_EQ(4, lru_replacer.Size());
+
+  // Scenario: frame 3 has +inf k-distance and goes first, then by decreasing k-distance [1, 0, 2].
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(3, value);
+
+  // Scenario: pinning and unpinning frame 1 does not change its position.
+  lru_replacer.SetEvictable(1, false);
+  ASSERT_EQ(2, lru_replacer.Size());
+  lru_replacer.SetEvictable(1, true);
+
+  // Scenario: one more access of frame 1 at timestamp 10 moves its k-th most recent access to 5.
+  lru_replacer.RecordAccess(1);
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(0, value);
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(1, value);
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(2, value);
+  ASSERT_EQ(false, lru_replacer.Evict(&value));
+
+  // Scenario: an evicted frame starts over with an empty history.
+  lru_replacer.RecordAccess(0);
+  lru_replacer.RecordAccess(1);
+  lru_replacer.RecordAccess(1);
+  lru_replacer.SetEvictable(0, true);
+  lru_replacer.SetEvictable(1, true);
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(0, value);
+}
+
+TEST(LRUKReplacerTest, EvictionOrderTest) {
+  LRUKReplacer lru_replacer(5, 2);
+
+  // Frame 4 came in through a scan, frames 0 and 2 have +inf k-distance, frames 1 and 3 have been seen twice.
+  lru_replacer.RecordAccess(1);
+  lru_replacer.RecordAccess(3);
+  lru_replacer.RecordAccess(2);
+  lru_replacer.RecordAccess(3);
+  lru_replacer.RecordAccess(1);
+  lru_replacer.RecordAccess(0);
+  lru_replacer.RecordAccess(4, AccessType::Scan);
+
+  // The order covers pinned frames too, and leaves the replacer untouched.
+  lru_replacer.SetEvictable(2, true);
+  ASSERT_EQ((std::vector<frame_id_t>{4, 2, 0, 1, 3}), lru_replacer.GetEvictionOrder());
+  ASSERT_EQ(1, lru_replacer.Size());
+  frame_id_t value;
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(2, value);
+  ASSERT_EQ((std::vector<frame_id_t>{4, 0, 1, 3}), lru_replacer.GetEvictionOrder());
+}
+
 }  // namespace bustub
@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// metrics_test.cpp
+//
+// Identification: test/common/metrics_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/metrics.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(MetricsTest, StripedCounterTest) {
+  StripedCounter counter;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 20; i++) {
+    threads.emplace_back([&counter] {
+      for (int j = 0; j < 1000; j++) {
+        counter.Add();
+      }
+      counter.Add(10);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(20 * 1010, counter.Get());
+
+  counter.Reset();
+  EXPECT_EQ(0, counter.Get());
+}
+
+// NOLINTNEXTLINE
+TEST(MetricsTest, LatencyHistogramTest) {
+  using std::chrono::microseconds;
+  using std::chrono::nanoseconds;
+
+  LatencyHistogram histogram;
+  EXPECT_EQ(0, histogram.Count());
+  EXPECT_EQ(0, histogram.PercentileMicros(50));
+
+  histogram.Record(nanoseconds(500));
+  EXPECT_EQ(1, histogram.BucketCount(0));
+  histogram.Record(microseconds(1));
+  histogram.Record(microseconds(3));
+  EXPECT_EQ(1, histogram.BucketCount(1));
+  EXPECT_EQ(1, histogram.BucketCount(2));
+  for (int i = 0; i < 97; i++) {
+    histogram.Record(microseconds(100));
+  }
+  EXPECT_EQ(97, histogram.BucketCount(7));
+  // Anything beyond the last bucket ends up in it.
+  histogram.Record(std::chrono::hours(1));
+  EXPECT_EQ(1, histogram.BucketCount(LatencyHistogram::NUM_BUCKETS - 1));
+
+  EXPECT_EQ(101, histogram.Count());
+  EXPECT_EQ(1, histogram.PercentileMicros(0));
+  EXPECT_EQ(4, histogram.PercentileMicros(2));
+  EXPECT_EQ(128, histogram.PercentileMicros(50));
+  EXPECT_EQ(128, histogram.PercentileMicros(99));
+  EXPECT_EQ(uint64_t{1} << (LatencyHistogram::NUM_BUCKETS - 1), histogram.PercentileMicros(100));
+
+  histogram.Reset();
+  EXPECT_EQ(0, histogram.Count());
+  EXPECT_EQ(0.0, histogram.MeanMicros());
+}
+
+}  // namespace bustub
@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <random>
 
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
@@ -23,7 +24,7 @@ namespace bustub {
 
 using bustub::DiskManagerUnlimitedMemory;
 
-TEST(BPlusTreeTests, DISABLED_InsertTest1) {
+TEST(BPlusTreeTests, InsertTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -62,7 +63,7 @@ TEST(BPlusTreeTests, DISABLED_InsertTest1) {
   delete bpm;
 }
 
-TEST(BPlusTreeTests, DISABLED_InsertTest2) {
+TEST(BPlusTreeTests, InsertTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -120,7 +121,7 @@ TEST(BPlusTreeTests, DISABLED_InsertTest2) {
   delete bpm;
 }
 
-TEST(BPlusTreeTests, DISABLED_InsertTest3) {
+TEST(BPlusTreeTests, InsertTest3) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -184,4 +185,92 @@ TEST(BPlusTreeTests, DISABLED_InsertTest3) {
   delete transaction;
   delete bpm;
 }
+
+TEST(BPlusTreeTests, BulkLoadTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", header_page->GetPageId(), bpm, comparator, 5, 4);
+  GenericKey<8> index_key;
+  RID rid;
+
+  // Load 1..1000 out of order, with every tenth key twice. The first of equal keys is kept.
+  std::vector<std::pair<GenericKey<8>, RID>> entries;
+  for (int64_t key = 1; key <= 1000; key++) {
+    index_key.SetFromInteger(key);
+    entries.emplace_back(index_key, RID(0, key));
+    if (key % 10 == 0) {
+      entries.emplace_back(index_key, RID(1, key));
+    }
+  }
+  std::shuffle(entries.begin(), entries.end(), std::default_random_engine{});
+  std::stable_partition(entries.begin(), entries.end(),
+                        [](const auto &entry) { return entry.second.GetPageId() == 0; });
+  tree.BulkLoad(entries, 0.75);
+
+  // Full leaves hold (5 - 1) * 0.75 = 3 keys, and the leaves were allocated one after the other.
+  int64_t current_key = 1;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    auto location = (*iterator).second;
+    EXPECT_EQ(location.GetPageId(), 0);
+    EXPECT_EQ(location.GetSlotNum(), current_key);
+    current_key = current_key + 1;
+  }
+  EXPECT_EQ(current_key, 1001);
+  auto root_page_id = tree.GetRootPageId();
+  auto leftmost_page_id = root_page_id;
+  while (true) {
+    auto guard = bpm->FetchPageRead(leftmost_page_id);
+    if (guard.As<BPlusTreePage>()->IsLeafPage()) {
+      auto leaf = guard.As<BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>>();
+      EXPECT_EQ(leaf->GetSize(), 3);
+      EXPECT_EQ(leaf->GetNextPageId(), leftmost_page_id + 1);
+      break;
+    }
+    leftmost_page_id = guard.As<BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>>()->ValueAt(0);
+  }
+
+  // The loaded tree takes inserts and removes like any other.
+  for (int64_t key = 1001; key <= 1100; key++) {
+    index_key.SetFromInteger(key);
+    rid.Set(0, key);
+    EXPECT_TRUE(tree.Insert(index_key, rid));
+  }
+  index_key.SetFromInteger(500);
+  EXPECT_FALSE(tree.Insert(index_key, rid));
+  for (int64_t key = 1; key <= 1100; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, nullptr);
+  }
+  std::vector<RID> rids;
+  for (int64_t key = 1; key <= 1100; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_EQ(tree.GetValue(index_key, &rids), key % 2 == 0);
+  }
+
+  // Loading into a tree that is not empty inserts the entries.
+  entries.clear();
+  for (int64_t key = 1; key <= 5; key++) {
+    index_key.SetFromInteger(key);
+    entries.emplace_back(index_key, RID(0, key));
+  }
+  tree.BulkLoad(entries);
+  for (int64_t key = 1; key <= 5; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.GetValue(index_key, &rids));
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
 }  // namespace bustub
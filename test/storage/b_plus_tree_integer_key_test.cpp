@@ -0,0 +1,144 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_integer_key_test.cpp
+//
+// Identification: test/storage/b_plus_tree_integer_key_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <set>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/page/b_plus_tree_integer_leaf_page.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using bustub::DiskManagerUnlimitedMemory;
+
+auto MakeIntegerKey(int64_t number) -> IntegerKey {
+  IntegerKey key;
+  key.SetFromInteger(number);
+  return key;
+}
+
+TEST(BPlusTreeTests, IntegerKeyTreeTest) {
+  IntegerComparator comparator(nullptr);
+
+  for (auto max_size : {3, 5, BPlusTreeIntegerLeafPage::MaxSizeForPage(BUSTUB_PAGE_SIZE)}) {
+    auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+    auto *bpm = new BufferPoolManager(50, disk_manager.get());
+    // create and fetch header_page
+    page_id_t page_id;
+    auto header_page = bpm->NewPage(&page_id);
+    // create b+ tree
+    BPlusTree<IntegerKey, RID, IntegerComparator> tree("foo_pk", header_page->GetPageId(), bpm, comparator, max_size,
+                                                       max_size);
+
+    // Negative and positive keys spread over the whole range, in random order.
+    std::vector<int64_t> numbers = {INT64_MIN, INT64_MIN + 1, INT64_MAX - 1, INT64_MAX};
+    for (int64_t i = -2000; i < 2000; i++) {
+      numbers.push_back(i * 7919 * 1000003);
+    }
+    std::shuffle(numbers.begin(), numbers.end(), std::default_random_engine{});
+
+    std::set<int64_t> expected;
+    for (size_t i = 0; i < numbers.size(); i++) {
+      EXPECT_TRUE(tree.Insert(MakeIntegerKey(numbers[i]), RID(0, i)));
+      expected.insert(numbers[i]);
+    }
+    EXPECT_FALSE(tree.Insert(MakeIntegerKey(INT64_MAX), RID(1, 0)));
+
+    std::vector<RID> rids;
+    for (size_t i = 0; i < numbers.size(); i++) {
+      rids.clear();
+      EXPECT_TRUE(tree.GetValue(MakeIntegerKey(numbers[i]), &rids));
+      ASSERT_EQ(rids.size(), 1);
+      EXPECT_EQ(rids[0].GetSlotNum(), i);
+      if (numbers[i] > INT64_MIN + 1 && numbers[i] < INT64_MAX - 1) {
+        rids.clear();
+        EXPECT_FALSE(tree.GetValue(MakeIntegerKey(numbers[i] + 1), &rids)) << numbers[i];
+      }
+    }
+
+    // Remove every other key, then scan in numeric order.
+    for (size_t i = 0; i < numbers.size(); i += 2) {
+      tree.Remove(MakeIntegerKey(numbers[i]), nullptr);
+      expected.erase(numbers[i]);
+    }
+    auto it = expected.begin();
+    for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+      ASSERT_NE(it, expected.end());
+      EXPECT_EQ((*iterator).first.GetInteger(), *it);
+      EXPECT_EQ((*iterator).second.GetSlotNum() % 2, 1);
+      ++it;
+    }
+    EXPECT_EQ(it, expected.end());
+
+    // Range scan from a key that is not in the tree.
+    {
+      auto iterator = tree.Begin(MakeIntegerKey(-1));
+      EXPECT_EQ((*iterator).first.GetInteger(), *expected.lower_bound(-1));
+    }
+
+    // Remove the rest, so that the tree shrinks down to nothing.
+    for (auto number : numbers) {
+      tree.Remove(MakeIntegerKey(number), nullptr);
+    }
+    EXPECT_TRUE(tree.IsEmpty());
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete bpm;
+  }
+}
+
+TEST(BPlusTreeTests, IntegerKeyBulkLoadTest) {
+  IntegerComparator comparator(nullptr);
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  // create b+ tree
+  BPlusTree<IntegerKey, RID, IntegerComparator> tree("foo_pk", header_page->GetPageId(), bpm, comparator);
+
+  std::vector<std::pair<IntegerKey, RID>> entries;
+  for (int64_t i = 0; i < 100000; i++) {
+    entries.emplace_back(MakeIntegerKey(i - 50000), RID(0, i));
+  }
+  std::shuffle(entries.begin(), entries.end(), std::default_random_engine{});
+  tree.BulkLoad(entries);
+
+  int64_t next = -50000;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ((*iterator).first.GetInteger(), next);
+    next++;
+  }
+  EXPECT_EQ(next, 50000);
+
+  // The loaded tree takes inserts and removes like any other.
+  for (int64_t i = -50000; i < 50000; i += 2) {
+    tree.Remove(MakeIntegerKey(i), nullptr);
+  }
+  std::vector<RID> rids;
+  for (int64_t i = -50000; i < 50000; i++) {
+    rids.clear();
+    EXPECT_EQ(tree.GetValue(MakeIntegerKey(i), &rids), i % 2 != 0);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
+}  // namespace bustub
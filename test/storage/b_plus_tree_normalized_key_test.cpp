@@ -0,0 +1,284 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_normalized_key_test.cpp
+//
+// Identification: test/storage/b_plus_tree_normalized_key_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <string>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/page/b_plus_tree_slotted_internal_page.h"
+#include "storage/page/b_plus_tree_slotted_leaf_page.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+using bustub::DiskManagerUnlimitedMemory;
+
+auto MakeNormalizedKey(std::vector<Value> values, const Schema *schema) -> NormalizedKey {
+  Tuple tuple(std::move(values), schema);
+  NormalizedKey key;
+  key.SetFromKey(tuple, *schema);
+  return key;
+}
+
+auto MakeStringKey(const std::string &str, const Schema *schema) -> NormalizedKey {
+  return MakeNormalizedKey({ValueFactory::GetVarcharValue(str)}, schema);
+}
+
+TEST(BPlusTreeTests, NormalizedKeyOrderTest) {
+  NormalizedComparator comparator(nullptr);
+
+  // Keys made in the order of their columns compare in the same order, bytewise.
+  auto key_schema = ParseCreateStatement("a bigint,b varchar(16)");
+  std::vector<int64_t> numbers = {-(int64_t{1} << 40), -256, -1, 0, 1, 255, 256, int64_t{1} << 40};
+  std::vector<std::string> strings = {"", "a", "ab", "abc", "b", "ba"};
+  std::vector<NormalizedKey> keys;
+  for (auto number : numbers) {
+    for (const auto &str : strings) {
+      keys.push_back(MakeNormalizedKey(
+          {ValueFactory::GetBigIntValue(number), ValueFactory::GetVarcharValue(str)}, key_schema.get()));
+    }
+  }
+  for (size_t i = 0; i < keys.size(); i++) {
+    for (size_t j = 0; j < keys.size(); j++) {
+      int expected = i < j ? -1 : (i == j ? 0 : 1);
+      int result = comparator(keys[i], keys[j]);
+      EXPECT_EQ((result > 0) - (result < 0), expected) << i << " " << j;
+    }
+  }
+
+  auto decimal_schema = ParseCreateStatement("a double");
+  std::vector<double> decimals = {-1e10, -2.5, -0.5, 0, 0.25, 1, 3.75, 1e10};
+  for (size_t i = 0; i + 1 < decimals.size(); i++) {
+    auto key = MakeNormalizedKey({ValueFactory::GetDecimalValue(decimals[i])}, decimal_schema.get());
+    auto next_key = MakeNormalizedKey({ValueFactory::GetDecimalValue(decimals[i + 1])}, decimal_schema.get());
+    EXPECT_LT(comparator(key, next_key), 0) << decimals[i];
+  }
+
+  // Integers made for tests decode back.
+  NormalizedKey key;
+  key.SetFromInteger(-42);
+  EXPECT_EQ(key.ToString(), -42);
+}
+
+TEST(BPlusTreeTests, NormalizedKeyTreeTest) {
+  // Pages of 256 bytes take keys of up to 17 bytes, so the tree grows a few levels.
+  auto key_schema = ParseCreateStatement("a varchar(32)");
+  NormalizedComparator comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  // create b+ tree
+  BPlusTree<NormalizedKey, RID, NormalizedComparator> tree("foo_pk", header_page->GetPageId(), bpm, comparator, 256,
+                                                           256);
+
+  // Strings of 1 to 10 characters, in random order.
+  std::vector<int64_t> numbers;
+  for (int64_t i = 0; i < 2000; i++) {
+    numbers.push_back(i);
+  }
+  std::shuffle(numbers.begin(), numbers.end(), std::default_random_engine{});
+  auto string_of = [](int64_t number) { return std::to_string(number) + std::string(number % 7, 'x'); };
+
+  std::set<std::string> expected;
+  for (auto number : numbers) {
+    auto str = string_of(number);
+    EXPECT_TRUE(tree.Insert(MakeStringKey(str, key_schema.get()), RID(0, number)));
+    expected.insert(str);
+  }
+  EXPECT_FALSE(tree.Insert(MakeStringKey(string_of(7), key_schema.get()), RID(1, 7)));
+
+  std::vector<RID> rids;
+  for (auto number : numbers) {
+    rids.clear();
+    EXPECT_TRUE(tree.GetValue(MakeStringKey(string_of(number), key_schema.get()), &rids));
+    ASSERT_EQ(rids.size(), 1);
+    EXPECT_EQ(rids[0].GetSlotNum(), number);
+  }
+
+  // Remove every other key, then scan in string order.
+  for (auto number : numbers) {
+    if (number % 2 == 0) {
+      tree.Remove(MakeStringKey(string_of(number), key_schema.get()), nullptr);
+      expected.erase(string_of(number));
+    }
+  }
+  auto it = expected.begin();
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    ASSERT_NE(it, expected.end());
+    EXPECT_EQ(comparator((*iterator).first, MakeStringKey(*it, key_schema.get())), 0);
+    EXPECT_EQ((*iterator).second.GetSlotNum() % 2, 1);
+    ++it;
+  }
+  EXPECT_EQ(it, expected.end());
+
+  // Range scan from a key that is not in the tree. The iterator latches its leaf until it goes out of scope.
+  {
+    auto iterator = tree.Begin(MakeStringKey("100", key_schema.get()));
+    EXPECT_EQ(comparator((*iterator).first, MakeStringKey("1001", key_schema.get())), 0);
+  }
+
+  // Keys too long for the pages are rejected.
+  EXPECT_THROW(tree.Insert(MakeStringKey(std::string(20, 'y'), key_schema.get()), RID(0, 0)), Exception);
+
+  // Remove the rest, so that the tree shrinks down to nothing.
+  for (auto number : numbers) {
+    tree.Remove(MakeStringKey(string_of(number), key_schema.get()), nullptr);
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
+TEST(BPlusTreeTests, NormalizedKeyTruncationTest) {
+  // Keys of 43 bytes that share their first 20, and differ within the next 4.
+  auto key_schema = ParseCreateStatement("a varchar(48)");
+  NormalizedComparator comparator(key_schema.get());
+  auto string_of = [](int64_t number) {
+    auto digits = std::to_string(number);
+    return "some_common_prefix_" + std::string(4 - digits.size(), '0') + digits + "_" + std::string(16, 'x');
+  };
+  const size_t key_size = MakeStringKey(string_of(0), key_schema.get()).GetSize();
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  // create b+ tree
+  BPlusTree<NormalizedKey, RID, NormalizedComparator> tree("foo_pk", header_page->GetPageId(), bpm, comparator, 512,
+                                                           512);
+
+  std::vector<int64_t> numbers;
+  for (int64_t i = 0; i < 1000; i++) {
+    numbers.push_back(i);
+  }
+  std::shuffle(numbers.begin(), numbers.end(), std::default_random_engine{});
+  for (auto number : numbers) {
+    EXPECT_TRUE(tree.Insert(MakeStringKey(string_of(number), key_schema.get()), RID(0, number)));
+  }
+
+  // Separators are cut off after the digits where neighboring keys differ.
+  page_id_t leaf_page_id = tree.GetRootPageId();
+  {
+    auto guard = bpm->FetchPageRead(tree.GetRootPageId());
+    auto root = guard.As<BPlusTreeSlottedInternalPage>();
+    ASSERT_FALSE(root->IsLeafPage());
+    ASSERT_GE(root->GetSize(), 2);
+    for (int i = 1; i < root->GetSize(); i++) {
+      EXPECT_LT(root->KeyAt(i).GetSize(), key_size - 16);
+    }
+  }
+
+  // Leaves between the first and the last one store the keys without their common prefix.
+  while (true) {
+    auto guard = bpm->FetchPageRead(leaf_page_id);
+    if (guard.As<BPlusTreePage>()->IsLeafPage()) {
+      break;
+    }
+    leaf_page_id = guard.As<BPlusTreeSlottedInternalPage>()->ValueAt(0);
+  }
+  int leaves = 0;
+  int compressed_leaves = 0;
+  while (leaf_page_id != INVALID_PAGE_ID) {
+    auto guard = bpm->FetchPageRead(leaf_page_id);
+    auto leaf = guard.As<BPlusTreeSlottedLeafPage>();
+    leaves++;
+    compressed_leaves += leaf->GetPrefixSize() > 20 ? 1 : 0;
+    leaf_page_id = leaf->GetNextPageId();
+  }
+  EXPECT_EQ(compressed_leaves, leaves - 2);
+
+  // Lookups, scans and merges see the keys with their prefix.
+  for (auto number : numbers) {
+    if (number % 3 != 0) {
+      tree.Remove(MakeStringKey(string_of(number), key_schema.get()), nullptr);
+    }
+  }
+  std::vector<RID> rids;
+  for (int64_t i = 0; i < 1000; i++) {
+    rids.clear();
+    EXPECT_EQ(tree.GetValue(MakeStringKey(string_of(i), key_schema.get()), &rids), i % 3 == 0);
+  }
+  int64_t next = 0;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ(comparator((*iterator).first, MakeStringKey(string_of(next), key_schema.get())), 0);
+    next += 3;
+  }
+  EXPECT_EQ(next, 1002);
+
+  for (auto number : numbers) {
+    tree.Remove(MakeStringKey(string_of(number), key_schema.get()), nullptr);
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
+TEST(BPlusTreeTests, NormalizedKeyBulkLoadTest) {
+  auto key_schema = ParseCreateStatement("a varchar(32)");
+  NormalizedComparator comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  // create b+ tree
+  BPlusTree<NormalizedKey, RID, NormalizedComparator> tree("foo_pk", header_page->GetPageId(), bpm, comparator, 256,
+                                                           256);
+
+  std::vector<std::pair<NormalizedKey, RID>> entries;
+  std::set<std::string> expected;
+  for (int64_t i = 0; i < 1000; i++) {
+    auto str = std::string(i % 11, 'a') + std::to_string(i);
+    entries.emplace_back(MakeStringKey(str, key_schema.get()), RID(0, i));
+    expected.insert(str);
+  }
+  std::shuffle(entries.begin(), entries.end(), std::default_random_engine{});
+  tree.BulkLoad(entries);
+
+  auto it = expected.begin();
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    ASSERT_NE(it, expected.end());
+    EXPECT_EQ(comparator((*iterator).first, MakeStringKey(*it, key_schema.get())), 0);
+    ++it;
+  }
+  EXPECT_EQ(it, expected.end());
+
+  // The loaded tree takes inserts and removes like any other.
+  for (int64_t i = 0; i < 1000; i += 2) {
+    tree.Remove(MakeStringKey(std::string(i % 11, 'a') + std::to_string(i), key_schema.get()), nullptr);
+  }
+  std::vector<RID> rids;
+  for (int64_t i = 0; i < 1000; i++) {
+    rids.clear();
+    auto key = MakeStringKey(std::string(i % 11, 'a') + std::to_string(i), key_schema.get());
+    EXPECT_EQ(tree.GetValue(key, &rids), i % 2 == 1);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
+}  // namespace bustub
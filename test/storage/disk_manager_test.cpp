@@ -10,11 +10,24 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdlib>
 #include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "common/exception.h"
+#include "common/util/compression_util.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_compressed.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_manager_uring.h"
 
 namespace bustub {
 
@@ -24,12 +37,14 @@ class DiskManagerTest : public ::testing::Test {
   void SetUp() override {
     remove("test.db");
     remove("test.log");
+    remove("test.pmap");
   }
 
   // This function is called after every test.
   void TearDown() override {
     remove("test.db");
     remove("test.log");
+    remove("test.pmap");
   };
 };
 
@@ -72,7 +87,368 @@ TEST_F(DiskManagerTest, ReadWriteLogTest) {
   dm.ShutDown();
 }
 
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, SyncPagesTest) {
+  const size_t num_threads = 8;
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file);
+  dm.SyncPages();
+  EXPECT_EQ(1, dm.GetNumSyncs());
+
+  // Scenario: threads that write and sync at the same time share syncs.
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_threads; i++) {
+    threads.emplace_back([&dm, i] {
+      char data[BUSTUB_PAGE_SIZE] = {0};
+      for (int j = 0; j < 10; j++) {
+        std::snprintf(data, sizeof(data), "page %zu, version %d", i, j);
+        dm.WritePage(i, data);
+        dm.SyncPages();
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_GE(1 + num_threads * 10, dm.GetNumSyncs());
+  dm.ShutDown();
+
+  auto reopened = DiskManager(db_file);
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  for (size_t i = 0; i < num_threads; i++) {
+    std::snprintf(data, sizeof(data), "page %zu, version %d", i, 9);
+    reopened.ReadPage(i, buf);
+    EXPECT_EQ(0, std::memcmp(buf, data, sizeof(buf)));
+  }
+  reopened.ShutDown();
+}
+
 // NOLINTNEXTLINE
 TEST_F(DiskManagerTest, ThrowBadFileTest) { EXPECT_THROW(DiskManager("dev/null\\/foo/bar/baz/test.db"), Exception); }
 
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, UringReadWritePageTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  auto dm = DiskManagerUring(db_file);
+  std::strncpy(data, "A test string.", sizeof(data));
+
+  dm.ReadPage(0, buf);  // tolerate empty read
+
+  dm.WritePage(0, data);
+  dm.ReadPage(0, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+
+  // Scenario: Page-aligned buffers take the zero-copy path and must behave the same.
+  void *aligned = nullptr;
+  ASSERT_EQ(0, posix_memalign(&aligned, BUSTUB_PAGE_SIZE, BUSTUB_PAGE_SIZE));
+  dm.ReadPage(0, static_cast<char *>(aligned));
+  EXPECT_EQ(std::memcmp(aligned, data, sizeof(data)), 0);
+  free(aligned);
+
+  // Scenario: Reading past the end of the file yields a zeroed page.
+  std::memset(buf, 1, sizeof(buf));
+  dm.ReadPage(10, buf);
+  EXPECT_EQ(buf[0], 0);
+  EXPECT_EQ(buf[BUSTUB_PAGE_SIZE - 1], 0);
+
+  EXPECT_EQ(dm.GetNumWrites(), 1);
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, UringBatchTest) {
+  const size_t num_pages = 50;
+  std::string db_file("test.db");
+  // A queue depth smaller than the batch makes the batch span several submissions.
+  auto dm = DiskManagerUring(db_file, 2, 8);
+
+  std::vector<std::vector<char>> data(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<std::vector<char>> buf(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<DiskManagerUring::PageIo> writes;
+  std::vector<DiskManagerUring::PageIo> reads;
+  for (size_t i = 0; i < num_pages; i++) {
+    std::snprintf(data[i].data(), BUSTUB_PAGE_SIZE, "page %zu", i);
+    writes.push_back({/*is_write=*/true, static_cast<page_id_t>(i), data[i].data()});
+    reads.push_back({/*is_write=*/false, static_cast<page_id_t>(i), buf[i].data()});
+  }
+
+  dm.SubmitBatch(writes);
+  dm.SubmitBatch(reads);
+  for (size_t i = 0; i < num_pages; i++) {
+    EXPECT_EQ(data[i], buf[i]);
+  }
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, UringConcurrentTest) {
+  const size_t num_threads = 4;
+  const size_t num_pages = 64;
+  std::string db_file("test.db");
+  // Fewer rings than threads, so that some callers have to wait for a ring.
+  auto dm = DiskManagerUring(db_file, 2, 16);
+
+  std::vector<std::thread> threads;
+  std::vector<int> ok(num_threads, 0);
+  for (size_t t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      std::vector<std::vector<char>> data(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE));
+      std::vector<std::vector<char>> buf(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE));
+      std::vector<DiskManagerUring::PageIo> writes;
+      std::vector<DiskManagerUring::PageIo> reads;
+      for (size_t i = 0; i < num_pages; i++) {
+        auto page_id = static_cast<page_id_t>(i * num_threads + t);
+        std::snprintf(data[i].data(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+        writes.push_back({/*is_write=*/true, page_id, data[i].data()});
+        reads.push_back({/*is_write=*/false, page_id, buf[i].data()});
+      }
+      dm.SubmitBatch(writes);
+      dm.SubmitBatch(reads);
+      ok[t] = data == buf ? 1 : 0;
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(std::vector<int>(num_threads, 1), ok);
+  EXPECT_EQ(dm.GetNumWrites(), static_cast<int>(num_threads * num_pages));
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, CompressionUtilTest) {
+  std::mt19937 gen(15445);
+  std::vector<std::string> inputs{"", "a", "abcabcabcabcabcabcabc", std::string(BUSTUB_PAGE_SIZE, '\0')};
+  std::string text;
+  while (text.size() < BUSTUB_PAGE_SIZE) {
+    text += "tuple " + std::to_string(text.size()) + " of a table page; ";
+  }
+  inputs.push_back(text);
+  std::string noise(BUSTUB_PAGE_SIZE, ' ');
+  for (auto &ch : noise) {
+    ch = static_cast<char>(gen());
+  }
+  inputs.push_back(noise);
+
+  for (const auto &input : inputs) {
+    std::vector<char> compressed(input.size() + input.size() / 255 + 16);
+    size_t length = CompressionUtil::Compress(input.data(), input.size(), compressed.data(), compressed.size());
+    ASSERT_NE(0, length);
+    std::string output(input.size(), ' ');
+    ASSERT_TRUE(CompressionUtil::Decompress(compressed.data(), length, output.data(), output.size()));
+    EXPECT_EQ(input, output);
+    // A truncated input never decompresses to the full page.
+    if (length > 1) {
+      EXPECT_FALSE(CompressionUtil::Decompress(compressed.data(), length - 1, output.data(), output.size()));
+    }
+  }
+
+  // Scenario: repetitive pages shrink a lot, random ones do not fit into a smaller buffer.
+  std::vector<char> compressed(BUSTUB_PAGE_SIZE);
+  EXPECT_GT(BUSTUB_PAGE_SIZE / 4, CompressionUtil::Compress(text.data(), text.size(), compressed.data(),
+                                                            compressed.size()));
+  EXPECT_EQ(0, CompressionUtil::Compress(noise.data(), noise.size(), compressed.data(), BUSTUB_PAGE_SIZE - 1));
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, CompressedReadWritePageTest) {
+  const size_t num_pages = 20;
+  std::string db_file("test.db");
+  std::mt19937 gen(15445);
+  std::vector<std::vector<char>> data(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE));
+  for (size_t i = 0; i < num_pages; i++) {
+    for (size_t offset = 0; offset + 64 < BUSTUB_PAGE_SIZE; offset += 64) {
+      std::snprintf(&data[i][offset], 64, "page %zu, tuple at offset %zu", i, offset);
+    }
+  }
+
+  {
+    auto dm = DiskManagerCompressed(db_file);
+    char buf[BUSTUB_PAGE_SIZE] = {0};
+    dm.ReadPage(0, buf);  // tolerate empty read
+    for (size_t i = 0; i < num_pages; i++) {
+      dm.WritePage(i, data[i].data());
+    }
+    EXPECT_GT(num_pages * BUSTUB_PAGE_SIZE / 2, dm.GetFileBytes());
+    auto file_bytes = dm.GetFileBytes();
+
+    // Scenario: a page that no longer compresses moves out of its run. The saved page map still points at the run, so
+    // it is only taken by the next page that fits once the map has been saved again.
+    for (auto &ch : data[3]) {
+      ch = static_cast<char>(gen());
+    }
+    dm.WritePage(3, data[3].data());
+    EXPECT_EQ(file_bytes + BUSTUB_PAGE_SIZE, dm.GetFileBytes());
+    dm.WritePage(num_pages, data[0].data());
+    auto grown_file_bytes = dm.GetFileBytes();
+    EXPECT_GT(grown_file_bytes, file_bytes + BUSTUB_PAGE_SIZE);
+    dm.SyncPages();
+    dm.WritePage(num_pages + 1, data[0].data());
+    EXPECT_EQ(grown_file_bytes, dm.GetFileBytes());
+    data.push_back(data[0]);
+    data.push_back(data[0]);
+
+    for (size_t i = 0; i < data.size(); i++) {
+      dm.ReadPage(i, buf);
+      EXPECT_EQ(0, std::memcmp(buf, data[i].data(), BUSTUB_PAGE_SIZE));
+    }
+    dm.ShutDown();
+  }
+
+  // Scenario: the pages are still there after a restart.
+  auto dm = DiskManagerCompressed(db_file);
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  for (size_t i = 0; i < data.size(); i++) {
+    dm.ReadPage(i, buf);
+    EXPECT_EQ(0, std::memcmp(buf, data[i].data(), BUSTUB_PAGE_SIZE));
+  }
+
+  // Scenario: a rewrite that would fit in the page's run still goes to a fresh one, so a crash before the page map is
+  // saved again leaves the page as the saved map knows it.
+  std::filesystem::copy_file("test.pmap", "crash.pmap", std::filesystem::copy_options::overwrite_existing);
+  auto rewritten = data[5];
+  rewritten[0] = 'P';
+  dm.WritePage(5, rewritten.data());
+  std::filesystem::copy_file("test.db", "crash.db", std::filesystem::copy_options::overwrite_existing);
+  {
+    auto crashed = DiskManagerCompressed("crash.db");
+    crashed.ReadPage(5, buf);
+    EXPECT_EQ(0, std::memcmp(buf, data[5].data(), BUSTUB_PAGE_SIZE));
+    crashed.ShutDown();
+  }
+  remove("crash.db");
+  remove("crash.log");
+  remove("crash.pmap");
+  dm.ReadPage(5, buf);
+  EXPECT_EQ(0, std::memcmp(buf, rewritten.data(), BUSTUB_PAGE_SIZE));
+  dm.ShutDown();
+
+  // Scenario: a database file that was not written compressed is refused.
+  remove("test.pmap");
+  EXPECT_THROW(DiskManagerCompressed{db_file}, Exception);
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, CompressedConcurrentTest) {
+  const size_t num_threads = 4;
+  const size_t pages_per_thread = 16;
+  const size_t rounds = 20;
+  std::string db_file("test.db");
+  auto dm = DiskManagerCompressed(db_file);
+
+  // Every thread keeps rewriting and reading back its own pages, with growing and shrinking lengths, while the page
+  // map is saved over and over, which recycles the runs the pages leave behind.
+  std::atomic<bool> done{false};
+  std::thread saver([&] {
+    while (!done) {
+      dm.SyncPages();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+  std::vector<std::thread> threads;
+  std::vector<int> mismatches(num_threads, 0);
+  for (size_t t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      std::mt19937 gen(t);
+      std::vector<char> data(BUSTUB_PAGE_SIZE);
+      std::vector<char> buf(BUSTUB_PAGE_SIZE);
+      for (size_t round = 0; round < rounds; round++) {
+        for (size_t i = 0; i < pages_per_thread; i++) {
+          auto page_id = static_cast<page_id_t>(i * num_threads + t);
+          std::fill(data.begin(), data.end(), 0);
+          size_t random_bytes = gen() % BUSTUB_PAGE_SIZE;
+          for (size_t j = 0; j < random_bytes; j++) {
+            data[j] = static_cast<char>(gen());
+          }
+          dm.WritePage(page_id, data.data());
+          dm.ReadPage(page_id, buf.data());
+          mismatches[t] += data == buf ? 0 : 1;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  done = true;
+  saver.join();
+  EXPECT_EQ(std::vector<int>(num_threads, 0), mismatches);
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, UnlimitedMemoryTest) {
+  const size_t num_threads = 8;
+  const size_t pages_per_thread = 100;
+  DiskManagerUnlimitedMemory dm;
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  dm.ReadPage(0, buf);  // tolerate empty read
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_threads; i++) {
+    threads.emplace_back([&dm, i] {
+      char data[BUSTUB_PAGE_SIZE] = {0};
+      for (size_t j = 0; j < pages_per_thread; j++) {
+        page_id_t page_id = j * num_threads + i;
+        std::snprintf(data, sizeof(data), "page %d", page_id);
+        dm.WritePage(page_id, data);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(num_threads * pages_per_thread); page_id++) {
+    std::snprintf(data, sizeof(data), "page %d", page_id);
+    dm.ReadPage(page_id, buf);
+    EXPECT_EQ(0, std::memcmp(buf, data, sizeof(buf)));
+  }
+  EXPECT_EQ(num_threads * pages_per_thread, dm.GetNumWrites());
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, IoLatencyTest) {
+  using std::chrono::microseconds;
+  using std::chrono::nanoseconds;
+
+  EXPECT_EQ(nanoseconds(0), IoLatency().Sample());
+  EXPECT_EQ(microseconds(20), IoLatency::Fixed(microseconds(20)).Sample());
+  EXPECT_EQ(IoLatency::Distribution::None, IoLatency::Fixed(microseconds(0)).GetDistribution());
+
+  auto uniform = IoLatency::Uniform(microseconds(10), microseconds(30));
+  auto heavy_tailed = IoLatency::HeavyTailed(microseconds(10), 2.0, microseconds(1000));
+  std::vector<nanoseconds> samples;
+  for (int i = 0; i < 10000; i++) {
+    auto sample = uniform.Sample();
+    EXPECT_LE(microseconds(10), sample);
+    EXPECT_GE(microseconds(30), sample);
+    samples.push_back(heavy_tailed.Sample());
+    EXPECT_LE(microseconds(10), samples.back());
+    EXPECT_GE(microseconds(1000), samples.back());
+  }
+  // The median of a Pareto distribution is min * 2^(1 / shape), about 14us here, but its tail goes far beyond that.
+  std::sort(samples.begin(), samples.end());
+  EXPECT_LT(microseconds(12), samples[samples.size() / 2]);
+  EXPECT_GT(microseconds(17), samples[samples.size() / 2]);
+  EXPECT_LT(microseconds(50), samples[samples.size() * 999 / 1000]);
+
+  EXPECT_THROW(IoLatency::Uniform(microseconds(2), microseconds(1)), Exception);
+  EXPECT_THROW(IoLatency::HeavyTailed(microseconds(1), 0, microseconds(2)), Exception);
+
+  // Scenario: waiting takes at least the latency, whether it spins or sleeps.
+  for (auto latency : {microseconds(20), microseconds(500)}) {
+    auto start = std::chrono::steady_clock::now();
+    IoLatency::Fixed(latency).Wait();
+    EXPECT_LE(latency, std::chrono::steady_clock::now() - start);
+  }
+}
+
 }  // namespace bustub
@@ -0,0 +1,126 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler_test.cpp
+//
+// Identification: test/storage/disk_scheduler_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstring>
+#include <future>  // NOLINT
+#include <memory>
+#include <vector>
+
+#include "common/exception.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_scheduler.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(DiskSchedulerTest, ScheduleWriteReadPageTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+
+  auto dm = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto disk_scheduler = std::make_unique<DiskScheduler>(dm.get());
+
+  std::strncpy(data, "A test string.", sizeof(data));
+
+  auto promise1 = disk_scheduler->CreatePromise();
+  auto future1 = promise1.get_future();
+  auto promise2 = disk_scheduler->CreatePromise();
+  auto future2 = promise2.get_future();
+
+  // Requests may be served by different workers in any order, so the read is only issued once the write is done.
+  disk_scheduler->Schedule({/*is_write=*/true, data, /*page_id=*/0, std::move(promise1)});
+  ASSERT_TRUE(future1.get());
+  disk_scheduler->Schedule({/*is_write=*/false, buf, /*page_id=*/0, std::move(promise2)});
+  ASSERT_TRUE(future2.get());
+
+  ASSERT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+
+  disk_scheduler = nullptr;  // Call the DiskScheduler destructor to finish all scheduled jobs.
+  dm->ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST(DiskSchedulerTest, ScheduleBatchTest) {
+  const size_t num_pages = 32;
+  std::vector<std::vector<char>> data(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<std::vector<char>> buf(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE));
+
+  auto dm = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto disk_scheduler = std::make_unique<DiskScheduler>(dm.get(), 4);
+
+  // Scenario: A batch of writes to distinct pages completes, with every future fulfilled.
+  std::vector<DiskRequest> writes;
+  std::vector<std::future<bool>> futures;
+  for (size_t i = 0; i < num_pages; i++) {
+    std::snprintf(data[i].data(), BUSTUB_PAGE_SIZE, "page %zu", i);
+    auto promise = disk_scheduler->CreatePromise();
+    futures.push_back(promise.get_future());
+    writes.push_back({/*is_write=*/true, data[i].data(), static_cast<page_id_t>(i), std::move(promise)});
+  }
+  disk_scheduler->Schedule(std::move(writes));
+  for (auto &future : futures) {
+    ASSERT_TRUE(future.get());
+  }
+
+  // Scenario: A batch of reads brings every page back.
+  std::vector<DiskRequest> reads;
+  futures.clear();
+  for (size_t i = 0; i < num_pages; i++) {
+    auto promise = disk_scheduler->CreatePromise();
+    futures.push_back(promise.get_future());
+    reads.push_back({/*is_write=*/false, buf[i].data(), static_cast<page_id_t>(i), std::move(promise)});
+  }
+  disk_scheduler->Schedule(std::move(reads));
+  for (auto &future : futures) {
+    ASSERT_TRUE(future.get());
+  }
+  for (size_t i = 0; i < num_pages; i++) {
+    ASSERT_EQ(data[i], buf[i]);
+  }
+
+  disk_scheduler = nullptr;
+  dm->ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST(DiskSchedulerTest, ScheduleErrorTest) {
+  class FailingDiskManager : public DiskManagerUnlimitedMemory {
+   public:
+    void ReadPage(page_id_t page_id, char *page_data) override {
+      if (page_id == 1) {
+        throw Exception("the disk is gone");
+      }
+      DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+    }
+  };
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+
+  auto dm = std::make_unique<FailingDiskManager>();
+  auto disk_scheduler = std::make_unique<DiskScheduler>(dm.get(), 1);
+
+  // Scenario: an exception thrown by the disk manager reaches the issuer, and the worker keeps serving requests.
+  auto promise1 = disk_scheduler->CreatePromise();
+  auto future1 = promise1.get_future();
+  disk_scheduler->Schedule({/*is_write=*/false, buf, /*page_id=*/1, std::move(promise1)});
+  EXPECT_THROW(future1.get(), Exception);
+
+  auto promise2 = disk_scheduler->CreatePromise();
+  auto future2 = promise2.get_future();
+  disk_scheduler->Schedule({/*is_write=*/false, buf, /*page_id=*/0, std::move(promise2)});
+  EXPECT_TRUE(future2.get());
+
+  disk_scheduler = nullptr;
+  dm->ShutDown();
+}
+
+}  // namespace bustub
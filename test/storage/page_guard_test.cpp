@@ -13,6 +13,7 @@
 #include <cstdio>
 #include <random>
 #include <string>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "storage/disk/disk_manager_memory.h"
@@ -142,4 +143,92 @@ TEST(PageGuardTest, HHTest) {
   disk_manager->ShutDown();
 }
 
+// NOLINTNEXTLINE
+TEST(PageGuardTest, OptimisticReadTest) {
+  const size_t buffer_pool_size = 3;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_shared<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_shared<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k);
+
+  page_id_t page_id;
+  {
+    auto guard = bpm->NewPageGuarded(&page_id);
+    snprintf(guard.AsMut<char>(), BUSTUB_PAGE_SIZE, "hello");
+  }
+
+  // An optimistic read neither pins nor latches the page.
+  auto guard = bpm->FetchPageOptimistic(page_id);
+  ASSERT_TRUE(guard.IsValid());
+  EXPECT_STREQ("hello", guard.GetData());
+  EXPECT_TRUE(guard.Validate());
+  {
+    auto write_guard = bpm->FetchPageWrite(page_id);
+    EXPECT_EQ(1, bpm->GetPages()[0].GetPinCount());
+    // Taken while the page is write latched, the guard never validates.
+    EXPECT_FALSE(bpm->FetchPageOptimistic(page_id).Validate());
+    snprintf(write_guard.AsMut<char>(), BUSTUB_PAGE_SIZE, "world");
+  }
+  EXPECT_FALSE(guard.Validate());
+  // Read latches do not invalidate optimistic readers.
+  guard = bpm->FetchPageOptimistic(page_id);
+  { auto read_guard = bpm->FetchPageRead(page_id); }
+  EXPECT_STREQ("world", guard.GetData());
+  EXPECT_TRUE(guard.Validate());
+
+  // Evicting the page invalidates the guard, and a page that is not resident is read in.
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    page_id_t other_page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&other_page_id));
+  }
+  EXPECT_FALSE(guard.Validate());
+  EXPECT_FALSE(bpm->FetchPageOptimistic(page_id).IsValid());
+  for (size_t i = 1; i <= buffer_pool_size; i++) {
+    bpm->UnpinPage(static_cast<page_id_t>(i), false);
+  }
+  guard = bpm->FetchPageOptimistic(page_id);
+  ASSERT_TRUE(guard.IsValid());
+  EXPECT_STREQ("world", guard.GetData());
+  EXPECT_TRUE(guard.Validate());
+
+  // Deleting the page invalidates the guard as well.
+  EXPECT_TRUE(bpm->DeletePage(page_id));
+  EXPECT_FALSE(guard.Validate());
+
+  disk_manager->ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST(PageGuardTest, OptimisticReadHintTest) {
+  const size_t buffer_pool_size = 3;
+  const size_t num_pages = 4 * buffer_pool_size;
+
+  auto disk_manager = std::make_shared<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_shared<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+
+  std::vector<page_id_t> page_ids(num_pages);
+  for (auto &page_id : page_ids) {
+    auto guard = bpm->NewPageGuarded(&page_id);
+    snprintf(guard.AsMut<char>(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+  }
+
+  // Scenario: hits are served from the frame hints, which go stale as pages move between frames and share hints with
+  // other pages. A stale hint must never yield the wrong page.
+  char expected[BUSTUB_PAGE_SIZE];
+  for (int round = 0; round < 3; round++) {
+    for (size_t i = 0; i < num_pages; i++) {
+      page_id_t page_id = page_ids[round % 2 == 0 ? i : num_pages - 1 - i];
+      snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", page_id);
+      for (int repeat = 0; repeat < 2; repeat++) {
+        auto guard = bpm->FetchPageOptimistic(page_id);
+        ASSERT_TRUE(guard.IsValid());
+        EXPECT_STREQ(expected, guard.GetData());
+        EXPECT_TRUE(guard.Validate());
+      }
+    }
+  }
+
+  disk_manager->ShutDown();
+}
+
 }  // namespace bustub
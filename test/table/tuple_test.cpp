@@ -13,14 +13,18 @@
 #include <algorithm>
 #include <cstdio>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
+#include "common/exception.h"
 #include "gtest/gtest.h"
 #include "logging/common.h"
+#include "storage/disk/disk_manager_memory.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 // NOLINTNEXTLINE
@@ -61,4 +65,44 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(TupleTest, TableHeapGetTuplesTest) {
+  const size_t buffer_pool_size = 4;
+  Schema schema{std::vector<Column>{Column{"a", TypeId::BIGINT}}};
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+  auto table = std::make_unique<TableHeap>(bpm.get());
+
+  std::vector<RID> rids;
+  for (int64_t i = 0; i < 3000; i++) {
+    Tuple tuple{std::vector<Value>{ValueFactory::GetBigIntValue(i)}, &schema};
+    rids.push_back(*table->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple));
+  }
+  ASSERT_GT(rids.back().GetPageId() - rids.front().GetPageId(), static_cast<page_id_t>(buffer_pool_size));
+
+  // Scenario: the tuples live on more pages than the buffer pool holds, so most of them are fetched one at a time
+  // after the batch.
+  std::reverse(rids.begin(), rids.end());
+  auto tuples = table->GetTuples(rids);
+  ASSERT_EQ(tuples.size(), rids.size());
+  for (size_t i = 0; i < rids.size(); i++) {
+    EXPECT_EQ(tuples[i].second.GetRid(), rids[i]);
+    EXPECT_EQ(tuples[i].second.GetValue(&schema, 0).GetAs<int64_t>(), static_cast<int64_t>(rids.size() - 1 - i));
+  }
+
+  // Scenario: with every frame pinned, not even one page can be fetched.
+  std::vector<page_id_t> pinned(buffer_pool_size);
+  for (auto &page_id : pinned) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+  EXPECT_THROW(table->GetTuples(rids), Exception);
+  for (auto page_id : pinned) {
+    bpm->UnpinPage(page_id, false);
+  }
+
+  table = nullptr;
+  disk_manager->ShutDown();
+}
+
 }  // namespace bustub
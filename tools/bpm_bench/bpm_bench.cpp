@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <iostream>
 #include <memory>
@@ -35,10 +37,22 @@ static const size_t LRU_K_SIZE = 16;
 static const size_t BUSTUB_PAGE_CNT = 6400;
 static const size_t BUSTUB_BPM_SIZE = 64;
 
+/** Counts the pages the buffer pool reads, so that the benchmark can tell hits from misses. */
+class CountingDiskManager : public bustub::DiskManagerUnlimitedMemory {
+ public:
+  void ReadPage(bustub::page_id_t page_id, char *page_data) override {
+    read_cnt_++;
+    DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+  }
+
+  std::atomic<uint64_t> read_cnt_{0};
+};
+
 struct BpmTotalMetrics {
   uint64_t scan_cnt_{0};
   uint64_t get_cnt_{0};
   uint64_t start_time_{0};
+  uint64_t read_cnt_{0};
   std::mutex mutex_;
 
   void Begin() { start_time_ = ClockMs(); }
@@ -58,10 +72,13 @@ struct BpmTotalMetrics {
     auto elsped = now - start_time_;
     auto scan_per_sec = scan_cnt_ / static_cast<double>(elsped) * 1000;
     auto get_per_sec = get_cnt_ / static_cast<double>(elsped) * 1000;
+    auto fetch_cnt = scan_cnt_ + get_cnt_;
+    auto hit_ratio = fetch_cnt == 0 ? 0.0 : 1.0 - std::min(read_cnt_, fetch_cnt) / static_cast<double>(fetch_cnt);
 
     fmt::print("<<< BEGIN\n");
     fmt::print("scan: {}\n", scan_per_sec);
     fmt::print("get: {}\n", get_per_sec);
+    fmt::print("hit_ratio: {:.4f}\n", hit_ratio);
     fmt::print(">>> END\n");
   }
 };
@@ -104,12 +121,20 @@ struct BpmMetrics {
 auto main(int argc, char **argv) -> int {
   using bustub::AccessType;
   using bustub::BufferPoolManager;
-  using bustub::DiskManagerUnlimitedMemory;
   using bustub::page_id_t;
+  using bustub::ReplacerPolicy;
 
   argparse::ArgumentParser program("bustub-bpm-bench");
   program.add_argument("--duration").help("run bpm bench for n milliseconds");
   program.add_argument("--latency").help("set disk latency to n milliseconds");
+  program.add_argument("--latency-us").help("set the mean disk latency to n microseconds, overriding --latency");
+  program.add_argument("--latency-distribution")
+      .help("distribution of the disk latency: fixed, uniform (0.5x to 1.5x the mean) or heavy-tailed (pareto)");
+  program.add_argument("--shards").help("partition the buffer pool into n independently latched shards");
+  program.add_argument("--read-ahead").help("prefetch n pages after a scan miss");
+  program.add_argument("--replacer").help("replacement policy: lru_k, lru, clock, arc or clock_pro");
+  program.add_argument("--dirty-high-water")
+      .help("run the background writer, keeping the dirty fraction of the buffer pool below x");
 
   try {
     program.parse_args(argc, argv);
@@ -124,17 +149,59 @@ auto main(int argc, char **argv) -> int {
     duration_ms = std::stoi(program.get("--duration"));
   }
 
-  uint64_t latency_ms = 0;
+  uint64_t latency_us = 0;
   if (program.present("--latency")) {
-    latency_ms = std::stoi(program.get("--latency"));
+    latency_us = std::stoi(program.get("--latency")) * 1000;
+  }
+  if (program.present("--latency-us")) {
+    latency_us = std::stoi(program.get("--latency-us"));
+  }
+
+  std::string latency_distribution = "fixed";
+  if (program.present("--latency-distribution")) {
+    latency_distribution = program.get("--latency-distribution");
+  }
+  bustub::IoLatency latency;
+  std::chrono::microseconds mean(latency_us);
+  if (latency_distribution == "fixed") {
+    latency = bustub::IoLatency::Fixed(mean);
+  } else if (latency_distribution == "uniform") {
+    latency = bustub::IoLatency::Uniform(mean / 2, mean * 3 / 2);
+  } else if (latency_distribution == "heavy-tailed") {
+    // A shape of 2 puts the mean at twice the minimum; the cap keeps a single I/O from stalling the run.
+    latency = bustub::IoLatency::HeavyTailed(mean / 2, 2.0, mean * 100);
+  } else {
+    std::cerr << "unknown latency distribution: " << latency_distribution << std::endl;
+    return 1;
   }
 
-  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
-  auto bpm = std::make_unique<BufferPoolManager>(BUSTUB_BPM_SIZE, disk_manager.get(), LRU_K_SIZE);
+  size_t shards = 1;
+  if (program.present("--shards")) {
+    shards = std::stoi(program.get("--shards"));
+  }
+
+  size_t read_ahead = 0;
+  if (program.present("--read-ahead")) {
+    read_ahead = std::stoi(program.get("--read-ahead"));
+  }
+
+  ReplacerPolicy replacer = ReplacerPolicy::LRUK;
+  if (program.present("--replacer") && !bustub::ReplacerPolicyFromString(program.get("--replacer"), &replacer)) {
+    std::cerr << "unknown replacer policy: " << program.get("--replacer") << std::endl;
+    return 1;
+  }
+
+  auto disk_manager = std::make_unique<CountingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManager>(BUSTUB_BPM_SIZE, disk_manager.get(), LRU_K_SIZE, nullptr, shards,
+                                                 replacer);
+  bpm->SetReadAhead(read_ahead);
   std::vector<page_id_t> page_ids;
 
-  fmt::print(stderr, "[info] total_page={}, duration_ms={}, latency_ms={}, lru_k_size={}, bpm_size={}\n",
-             BUSTUB_PAGE_CNT, duration_ms, latency_ms, LRU_K_SIZE, BUSTUB_BPM_SIZE);
+  fmt::print(stderr,
+             "[info] total_page={}, duration_ms={}, latency_us={}, latency_distribution={}, lru_k_size={}, "
+             "bpm_size={}, shards={}, read_ahead={}, replacer={}\n",
+             BUSTUB_PAGE_CNT, duration_ms, latency_us, latency_distribution, LRU_K_SIZE, BUSTUB_BPM_SIZE, shards,
+             read_ahead, bustub::ReplacerPolicyToString(replacer));
 
   for (size_t i = 0; i < BUSTUB_PAGE_CNT; i++) {
     page_id_t page_id;
@@ -149,8 +216,13 @@ auto main(int argc, char **argv) -> int {
     page_ids.push_back(page_id);
   }
 
+  if (program.present("--dirty-high-water")) {
+    bpm->StartBackgroundWriter(std::stod(program.get("--dirty-high-water")));
+  }
+
   // enable disk latency after creating all pages
-  disk_manager->SetLatency(latency_ms);
+  disk_manager->SetLatency(latency);
+  disk_manager->read_cnt_ = 0;
 
   fmt::print(stderr, "[info] benchmark start\n");
 
@@ -226,6 +298,7 @@ auto main(int argc, char **argv) -> int {
     thread.join();
   }
 
+  total_metrics.read_cnt_ = disk_manager->read_cnt_;
   total_metrics.Report();
 
   return 0;
@@ -21,7 +21,7 @@
 #include "fmt/format.h"
 #include "storage/disk/disk_manager_memory.h"
 #include "storage/index/b_plus_tree.h"
-#include "storage/index/generic_key.h"
+#include "storage/index/integer_key.h"
 #include "test_util.h"
 
 #include <sys/time.h>
@@ -140,16 +140,16 @@ auto main(int argc, char **argv) -> int {
              LRU_K_SIZE, BUSTUB_BPM_SIZE);
 
   auto key_schema = bustub::ParseCreateStatement("a bigint");
-  bustub::GenericComparator<8> comparator(key_schema.get());
+  bustub::IntegerComparator comparator(key_schema.get());
 
   page_id_t page_id;
   auto header_page = bpm->NewPageGuarded(&page_id);
 
-  bustub::BPlusTree<bustub::GenericKey<8>, bustub::RID, bustub::GenericComparator<8>> index("foo_pk", page_id,
-                                                                                            bpm.get(), comparator);
+  bustub::BPlusTree<bustub::IntegerKey, bustub::RID, bustub::IntegerComparator> index("foo_pk", page_id, bpm.get(),
+                                                                                     comparator);
 
   for (size_t key = 0; key < TOTAL_KEYS; key++) {
-    bustub::GenericKey<8> index_key;
+    bustub::IntegerKey index_key;
     bustub::RID rid;
     uint32_t value = key;
     rid.Set(value, value);
@@ -175,7 +175,7 @@ auto main(int argc, char **argv) -> int {
       std::default_random_engine gen(r());
       std::uniform_int_distribution<size_t> dis(key_start, key_end - 1);
 
-      bustub::GenericKey<8> index_key;
+      bustub::IntegerKey index_key;
       std::vector<bustub::RID> rids;
 
       while (!metrics.ShouldFinish()) {
@@ -221,7 +221,7 @@ auto main(int argc, char **argv) -> int {
       std::default_random_engine gen(r());
       std::uniform_int_distribution<size_t> dis(key_start, key_end - 1);
 
-      bustub::GenericKey<8> index_key;
+      bustub::IntegerKey index_key;
       bustub::RID rid;
 
       bool do_insert = false;
@@ -27,24 +27,28 @@ auto GetWidthOfUtf8(const void *beg, const void *end, size_t *width) -> int {
 auto main(int argc, char **argv) -> int {
   ft_set_u8strwid_func(&GetWidthOfUtf8);
 
-  auto bustub = std::make_unique<bustub::BustubInstance>("test.db");
-
   auto default_prompt = "bustub> ";
   auto emoji_prompt = "\U0001f6c1> ";  // the bathtub emoji
   bool use_emoji_prompt = false;
   bool disable_tty = false;
+  size_t pool_size = bustub::BustubInstance::DEFAULT_POOL_SIZE;
+  size_t page_size = bustub::BUSTUB_PAGE_SIZE;
 
   for (int i = 1; i < argc; i++) {
     if (strcmp(argv[i], "--emoji-prompt") == 0) {
       use_emoji_prompt = true;
-      break;
-    }
-    if (strcmp(argv[i], "--disable-tty") == 0) {
+    } else if (strcmp(argv[i], "--disable-tty") == 0) {
       disable_tty = true;
-      break;
+    } else if (strcmp(argv[i], "--pool-size") == 0 && i + 1 < argc) {
+      pool_size = std::stoul(argv[++i]);
+    } else if (strcmp(argv[i], "--page-size") == 0 && i + 1 < argc) {
+      // Only used when test.db is created; an existing file keeps its page size.
+      page_size = std::stoul(argv[++i]);
     }
   }
 
+  auto bustub = std::make_unique<bustub::BustubInstance>("test.db", pool_size, page_size);
+
   bustub->GenerateMockTable();
 
   if (bustub->buffer_pool_manager_ != nullptr) {